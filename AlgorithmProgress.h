@@ -0,0 +1,50 @@
+#ifndef ALGORITHMPROGRESS_H
+#define ALGORITHMPROGRESS_H
+
+#include <QtGlobal>
+#include <QPromise>
+
+// Lets a long-running algorithm report how far it got and notice that the
+// caller gave up on it. Both methods are called from the worker thread;
+// isCancelled may also be polled from threads the algorithm starts itself.
+class AlgorithmProgress
+{
+public:
+    static constexpr int CHECK_INTERVAL = 1024;
+
+    virtual ~AlgorithmProgress() = default;
+
+    virtual void setProgress(int percent) = 0;
+    virtual bool isCancelled() const = 0;
+
+    // Reports done/total and returns true when the run should stop.
+    // A null progress never cancels.
+    static bool checkpoint(AlgorithmProgress *progress, qint64 done, qint64 total)
+    {
+        bool shouldStop = false;
+        if (progress) {
+            if (total > 0) {
+                progress->setProgress(static_cast<int>(done * 100 / total));
+            }
+            shouldStop = progress->isCancelled();
+        }
+        return shouldStop;
+    }
+};
+
+// Progress of a task started with QtConcurrent::run, reported through the
+// promise the task fills; cancelling its future cancels the task.
+template <typename T>
+class PromiseProgress : public AlgorithmProgress
+{
+public:
+    explicit PromiseProgress(QPromise<T> &promise) : m_promise(promise) {}
+
+    void setProgress(int percent) override { m_promise.setProgressValue(percent); }
+    bool isCancelled() const override { return m_promise.isCanceled(); }
+
+private:
+    QPromise<T> &m_promise;
+};
+
+#endif
@@ -0,0 +1,107 @@
+#ifndef ALGORITHMRESULTS_H
+#define ALGORITHMRESULTS_H
+
+#include <QVector>
+
+// Typed results returned by GraphAlgorithms. Vertices are reported by their
+// Graph ids, so a result stays meaningful after the snapshot it was computed
+// on is gone, and edges by their Graph edge ids, which tell parallel edges
+// apart. Text for the output pane is produced by ResultFormatter.
+enum class AlgorithmStatus {
+    Ok,
+    GraphNotInitialized,
+    EmptyGraph,
+    NotWeaklyConnected,
+    ContainsCycle,
+    ConditionsNotMet,
+    NoEdges,
+    StartVertexNotFound,
+    EndVertexNotFound,
+    SameEndpoints,
+    NoPath,
+    Cancelled
+};
+
+// Trails also list the edge taken between each pair of consecutive vertices;
+// edgeIds stays empty for sequences that are not walks, such as orders.
+struct VertexSequenceResult {
+    AlgorithmStatus status = AlgorithmStatus::Ok;
+    QVector<int> vertexIds;
+    QVector<int> edgeIds;
+
+    bool isOk() const { return status == AlgorithmStatus::Ok; }
+};
+
+struct ShortestPathResult {
+    AlgorithmStatus status = AlgorithmStatus::Ok;
+    int startId = -1;
+    int endId = -1;
+    int distance = 0;
+    QVector<int> path;
+    // Empty for answers from a contraction hierarchy, which keeps no edge ids.
+    QVector<int> edgeIds;
+
+    bool isOk() const { return status == AlgorithmStatus::Ok; }
+};
+
+struct FlowEdge {
+    int edgeId = -1;
+    int fromId = -1;
+    int toId = -1;
+    int capacity = 0;
+    int flow = 0;
+    bool crossesCut = false;
+};
+
+struct MaxFlowResult {
+    AlgorithmStatus status = AlgorithmStatus::Ok;
+    int sourceId = -1;
+    int sinkId = -1;
+    qint64 value = 0;
+    QVector<FlowEdge> edges;
+
+    bool isOk() const { return status == AlgorithmStatus::Ok; }
+};
+
+// components lists member ids in topological order of the condensation;
+// componentOf[i] is the index of the component containing vertexIds[i].
+struct ComponentsResult {
+    AlgorithmStatus status = AlgorithmStatus::Ok;
+    QVector<int> vertexIds;
+    QVector<int> componentOf;
+    QVector<QVector<int>> components;
+
+    bool isOk() const { return status == AlgorithmStatus::Ok; }
+};
+
+struct VertexDegree {
+    int vertexId = -1;
+    int inDegree = 0;
+    int outDegree = 0;
+};
+
+struct DegreesResult {
+    AlgorithmStatus status = AlgorithmStatus::Ok;
+    QVector<VertexDegree> degrees;
+
+    bool isOk() const { return status == AlgorithmStatus::Ok; }
+};
+
+// Summary of the search from one source: how many vertices it reaches
+// (itself included), the sum of their distances and the largest one.
+// Distances are hop counts or weight sums, depending on the metric asked for.
+struct SourceReach {
+    int sourceId = -1;
+    int reachedCount = 0;
+    qint64 distanceSum = 0;
+    int eccentricity = 0;
+};
+
+struct ReachabilityResult {
+    AlgorithmStatus status = AlgorithmStatus::Ok;
+    QVector<SourceReach> sources;
+
+    bool isOk() const { return status == AlgorithmStatus::Ok; }
+};
+
+#endif
@@ -0,0 +1,61 @@
+#include "AlgorithmRunner.h"
+#include <QtConcurrent/QtConcurrent>
+
+AlgorithmRunner::AlgorithmRunner(QObject *parent)
+    : QObject(parent)
+{
+    connect(&m_watcher, &QFutureWatcher<QString>::progressValueChanged, this, &AlgorithmRunner::progressChanged);
+    connect(&m_watcher, &QFutureWatcher<QString>::finished, this, &AlgorithmRunner::onFinished);
+}
+
+// The task owns its snapshot copy, but it must not outlive the watcher that
+// reports on it.
+AlgorithmRunner::~AlgorithmRunner()
+{
+    if (isRunning()) {
+        m_watcher.disconnect(this);
+        m_watcher.cancel();
+        m_watcher.waitForFinished();
+    }
+}
+
+bool AlgorithmRunner::isRunning() const
+{
+    return m_watcher.isRunning();
+}
+
+void AlgorithmRunner::start(const QString &title, const GraphSnapshot &snapshot, const Task &task)
+{
+    if (!isRunning()) {
+        m_title = title;
+
+        QFuture<QString> future = QtConcurrent::run([snapshot, task](QPromise<QString> &promise) {
+            PromiseProgress<QString> progress(promise);
+            promise.setProgressRange(0, 100);
+
+            QString text = task(snapshot, &progress);
+            if (!promise.isCanceled()) {
+                promise.addResult(text);
+            }
+        });
+
+        m_watcher.setFuture(future);
+        emit started(title);
+    }
+}
+
+void AlgorithmRunner::cancel()
+{
+    if (isRunning()) {
+        m_watcher.cancel();
+    }
+}
+
+void AlgorithmRunner::onFinished()
+{
+    if (m_watcher.isCanceled() || m_watcher.future().resultCount() == 0) {
+        emit cancelled(m_title);
+    } else {
+        emit finished(m_title, m_watcher.result());
+    }
+}
@@ -0,0 +1,44 @@
+#ifndef ALGORITHMRUNNER_H
+#define ALGORITHMRUNNER_H
+
+#include <QObject>
+#include <QFutureWatcher>
+#include <QString>
+#include <functional>
+#include "GraphSnapshot.h"
+#include "AlgorithmProgress.h"
+
+// Runs one algorithm at a time on the global thread pool against a snapshot
+// taken on the GUI thread, so the canvas stays editable meanwhile. Signals
+// are delivered on the thread that owns the runner.
+class AlgorithmRunner : public QObject
+{
+    Q_OBJECT
+
+public:
+    typedef std::function<QString(const GraphSnapshot&, AlgorithmProgress*)> Task;
+
+    explicit AlgorithmRunner(QObject *parent = nullptr);
+    ~AlgorithmRunner();
+
+    bool isRunning() const;
+    void start(const QString &title, const GraphSnapshot &snapshot, const Task &task);
+
+public slots:
+    void cancel();
+
+signals:
+    void started(const QString &title);
+    void progressChanged(int percent);
+    void finished(const QString &title, const QString &text);
+    void cancelled(const QString &title);
+
+private slots:
+    void onFinished();
+
+private:
+    QFutureWatcher<QString> m_watcher;
+    QString m_title;
+};
+
+#endif
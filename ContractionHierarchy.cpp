@@ -0,0 +1,591 @@
+#include "ContractionHierarchy.h"
+#include "GraphFile.h"
+#include <QFile>
+#include <QSaveFile>
+#include <QtEndian>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+const char MAGIC[8] = {'U', 'G', 'R', 'A', 'P', 'H', 'C', 'H'};
+const quint16 FORMAT_VERSION = 1;
+const int HEADER_SIZE = 40;
+
+// Binary .ch format, version 1. All integers are little-endian.
+//
+//   0  char[8]  magic "UGRAPHCH"
+//   8  quint16  version
+//  10  quint16  reserved, 0
+//  12  quint32  vertex count n
+//  16  quint32  up arc count u
+//  20  quint32  down arc count d
+//  24  quint64  fingerprint of the graph
+//  32  quint32  CRC-32 of everything after the header
+//  36  quint32  CRC-32 of bytes 0..35
+//
+// Then qint32 arrays: ids[n], upOffsets[n + 1], upTargets[u],
+// upWeights[u], upMiddles[u], downOffsets[n + 1], downSources[d],
+// downWeights[d], downMiddles[d].
+
+quint64 mix(quint64 value)
+{
+    value += 0x9E3779B97F4A7C15ull;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+    return value ^ (value >> 31);
+}
+
+void appendInts(QByteArray &buffer, const QVector<int> &values)
+{
+    qsizetype offset = buffer.size();
+    buffer.resize(offset + 4 * values.size());
+    qToLittleEndian<qint32>(values.constData(), values.size(), buffer.data() + offset);
+}
+
+bool readInts(const uchar *&cursor, const uchar *end, qint64 count, QVector<int> &values)
+{
+    bool isValid = end - cursor >= 4 * count;
+
+    if (isValid) {
+        values.resize(count);
+        qFromLittleEndian<qint32>(cursor, count, values.data());
+        cursor += 4 * count;
+    }
+
+    return isValid;
+}
+
+bool isValidCsr(const QVector<int> &offsets, const QVector<int> &vertices, const QVector<int> &weights,
+                const QVector<int> &middles, int vertexCount)
+{
+    bool isValid = offsets.first() == 0 && offsets.last() == vertices.size();
+
+    for (int vertex = 0; vertex < vertexCount && isValid; ++vertex) {
+        isValid = offsets[vertex] <= offsets[vertex + 1];
+    }
+    for (int arc = 0; arc < vertices.size() && isValid; ++arc) {
+        isValid = vertices[arc] >= 0 && vertices[arc] < vertexCount && weights[arc] >= 0
+            && middles[arc] >= -1 && middles[arc] < vertexCount;
+    }
+
+    return isValid;
+}
+
+}
+
+ContractionHierarchy::Contraction::Contraction(int vertexCount)
+    : outArcs(vertexCount)
+    , inArcs(vertexCount)
+    , isPriorityStale(vertexCount, false)
+    , contractedNeighbors(vertexCount, 0)
+    , levels(vertexCount, 0)
+    , witnessDistances(vertexCount, UNREACHABLE)
+    , witnessHeap(vertexCount)
+{
+}
+
+ContractionHierarchy::ContractionHierarchy()
+    : m_fingerprint(0)
+{
+}
+
+// Priorities are updated lazily: the cheapest vertex by its stored priority
+// is popped and, if a neighbour was contracted since it was computed,
+// re-queued when its current priority is higher than the next one's.
+bool ContractionHierarchy::build(const GraphSnapshot &snapshot, AlgorithmProgress *progress)
+{
+    clear();
+
+    int vertexCount = snapshot.vertexCount();
+    bool isBuilt = true;
+    for (int edge = 0; edge < snapshot.edgeCount() && isBuilt; ++edge) {
+        isBuilt = snapshot.weight(edge) >= 0;
+    }
+
+    if (isBuilt) {
+        Contraction state(vertexCount);
+        for (int edge = 0; edge < snapshot.edgeCount(); ++edge) {
+            int from = snapshot.source(edge);
+            int to = snapshot.target(edge);
+            if (from != to) {
+                state.outArcs[from].append(Arc{to, snapshot.weight(edge), -1});
+                state.inArcs[to].append(Arc{from, snapshot.weight(edge), -1});
+            }
+        }
+
+        IndexedDaryHeap queue(vertexCount);
+        for (int vertex = 0; vertex < vertexCount; ++vertex) {
+            queue.push(vertex, priority(state, vertex));
+        }
+
+        int contractedCount = 0;
+        while (!queue.isEmpty() && isBuilt) {
+            int vertex = queue.pop();
+            bool isCheapest = true;
+
+            if (state.isPriorityStale[vertex]) {
+                int current = priority(state, vertex);
+                state.isPriorityStale[vertex] = false;
+                if (!queue.isEmpty() && current > queue.topKey()) {
+                    queue.push(vertex, current);
+                    isCheapest = false;
+                }
+            }
+
+            if (isCheapest) {
+                contract(state, vertex, false);
+                detach(state, vertex);
+
+                if (++contractedCount % AlgorithmProgress::CHECK_INTERVAL == 0) {
+                    isBuilt = !AlgorithmProgress::checkpoint(progress, contractedCount, vertexCount);
+                }
+            }
+        }
+
+        if (isBuilt) {
+            m_vertexIds.resize(vertexCount);
+            for (int vertex = 0; vertex < vertexCount; ++vertex) {
+                m_vertexIds[vertex] = snapshot.vertexId(vertex);
+            }
+            indexVertexIds();
+            storeArcs(state);
+            m_fingerprint = fingerprint(snapshot);
+        }
+    }
+
+    return isBuilt;
+}
+
+// Edge difference weighs most; contracted neighbours and level spread the
+// contraction evenly over the graph instead of eating into one region.
+int ContractionHierarchy::priority(Contraction &state, int vertex)
+{
+    return 2 * contract(state, vertex, true) + state.contractedNeighbors[vertex] + state.levels[vertex];
+}
+
+// Returns the number of shortcuts needed minus the number of arcs removed.
+// A shortcut u->w is skipped when the witness search finds a path from u to
+// w around vertex that is no longer; an incomplete search only costs extra
+// shortcuts, never a wrong distance.
+int ContractionHierarchy::contract(Contraction &state, int vertex, bool isSimulation)
+{
+    const QVector<Arc> &outArcs = state.outArcs[vertex];
+    const QVector<Arc> &inArcs = state.inArcs[vertex];
+    int shortcutCount = 0;
+    int maxOutWeight = 0;
+
+    for (const Arc &out : outArcs) {
+        maxOutWeight = qMax(maxOutWeight, out.weight);
+    }
+
+    for (const Arc &in : inArcs) {
+        witnessSearch(state, in.vertex, vertex, static_cast<qint64>(in.weight) + maxOutWeight);
+
+        for (const Arc &out : outArcs) {
+            qint64 viaVertex = static_cast<qint64>(in.weight) + out.weight;
+            if (out.vertex != in.vertex && viaVertex < state.witnessDistances[out.vertex]) {
+                shortcutCount++;
+                if (!isSimulation) {
+                    addArc(state.outArcs[in.vertex], out.vertex, static_cast<int>(viaVertex), vertex);
+                    addArc(state.inArcs[out.vertex], in.vertex, static_cast<int>(viaVertex), vertex);
+                }
+            }
+        }
+
+        for (int touched : state.witnessTouched) {
+            state.witnessDistances[touched] = UNREACHABLE;
+        }
+        state.witnessTouched.clear();
+        state.witnessHeap.clear();
+    }
+
+    return shortcutCount - outArcs.size() - inArcs.size();
+}
+
+// Dijkstra over the remaining graph without excluded, stopped
+// after a fixed number of settled vertices or beyond limit. The distances
+// left behind are lengths of real paths, settled or not.
+void ContractionHierarchy::witnessSearch(Contraction &state, int source, int excluded, qint64 limit)
+{
+    QVector<int> &distances = state.witnessDistances;
+    int settledCount = 0;
+    bool isDone = false;
+
+    distances[source] = 0;
+    state.witnessTouched.append(source);
+    state.witnessHeap.push(source, 0);
+
+    while (!state.witnessHeap.isEmpty() && !isDone) {
+        int current = state.witnessHeap.pop();
+        isDone = distances[current] > limit || ++settledCount > MAX_WITNESS_SETTLED;
+
+        if (!isDone) {
+            for (const Arc &arc : state.outArcs[current]) {
+                qint64 alternative = static_cast<qint64>(distances[current]) + arc.weight;
+                if (arc.vertex != excluded && alternative < distances[arc.vertex]) {
+                    if (distances[arc.vertex] == UNREACHABLE) {
+                        state.witnessTouched.append(arc.vertex);
+                    }
+                    distances[arc.vertex] = static_cast<int>(alternative);
+                    state.witnessHeap.push(arc.vertex, distances[arc.vertex]);
+                }
+            }
+        }
+    }
+}
+
+// Keeps one arc per neighbour, the shortest.
+void ContractionHierarchy::addArc(QVector<Arc> &arcs, int vertex, int weight, int middle)
+{
+    auto existing = std::find_if(arcs.begin(), arcs.end(), [vertex](const Arc &arc) { return arc.vertex == vertex; });
+
+    if (existing == arcs.end()) {
+        arcs.append(Arc{vertex, weight, middle});
+    } else if (weight < existing->weight) {
+        existing->weight = weight;
+        existing->middle = middle;
+    }
+}
+
+// Removes vertex from the arc lists of its neighbours. Its own lists only
+// lead to vertices contracted later and are not touched again; they become
+// its up and down arcs.
+void ContractionHierarchy::detach(Contraction &state, int vertex)
+{
+    auto isToVertex = [vertex](const Arc &arc) { return arc.vertex == vertex; };
+
+    for (const Arc &out : state.outArcs[vertex]) {
+        state.inArcs[out.vertex].removeIf(isToVertex);
+        state.isPriorityStale[out.vertex] = true;
+        state.contractedNeighbors[out.vertex]++;
+        state.levels[out.vertex] = qMax(state.levels[out.vertex], state.levels[vertex] + 1);
+    }
+    for (const Arc &in : state.inArcs[vertex]) {
+        state.outArcs[in.vertex].removeIf(isToVertex);
+        state.isPriorityStale[in.vertex] = true;
+        state.contractedNeighbors[in.vertex]++;
+        state.levels[in.vertex] = qMax(state.levels[in.vertex], state.levels[vertex] + 1);
+    }
+}
+
+void ContractionHierarchy::storeArcs(const Contraction &state)
+{
+    int vertexCount = state.outArcs.size();
+    m_upOffsets.fill(0, vertexCount + 1);
+    m_downOffsets.fill(0, vertexCount + 1);
+
+    for (int vertex = 0; vertex < vertexCount; ++vertex) {
+        for (const Arc &arc : state.outArcs[vertex]) {
+            m_upTargets.append(arc.vertex);
+            m_upWeights.append(arc.weight);
+            m_upMiddles.append(arc.middle);
+        }
+        for (const Arc &arc : state.inArcs[vertex]) {
+            m_downSources.append(arc.vertex);
+            m_downWeights.append(arc.weight);
+            m_downMiddles.append(arc.middle);
+        }
+        m_upOffsets[vertex + 1] = m_upTargets.size();
+        m_downOffsets[vertex + 1] = m_downSources.size();
+    }
+}
+
+// The bypassed vertex of the shortest arc from -> to, -1 for an original
+// edge. The arc sits with whichever end ranks lower.
+int ContractionHierarchy::middleOf(int from, int to) const
+{
+    int middle = -1;
+    int weight = UNREACHABLE;
+
+    for (int arc = m_upOffsets[from]; arc < m_upOffsets[from + 1]; ++arc) {
+        if (m_upTargets[arc] == to && m_upWeights[arc] < weight) {
+            weight = m_upWeights[arc];
+            middle = m_upMiddles[arc];
+        }
+    }
+    for (int arc = m_downOffsets[to]; arc < m_downOffsets[to + 1]; ++arc) {
+        if (m_downSources[arc] == from && m_downWeights[arc] < weight) {
+            weight = m_downWeights[arc];
+            middle = m_downMiddles[arc];
+        }
+    }
+
+    return middle;
+}
+
+// Replaces each shortcut between consecutive vertices by the two arcs it
+// stands for until only original edges are left. Shortcuts can nest as deep
+// as the path is long, hence the explicit stack.
+void ContractionHierarchy::appendUnpacked(const QVector<int> &vertices, QVector<int> &path) const
+{
+    QVector<QPair<int, int>> pending;
+
+    path.append(vertices.first());
+    for (int i = vertices.size() - 1; i > 0; --i) {
+        pending.append(qMakePair(vertices[i - 1], vertices[i]));
+    }
+
+    while (!pending.isEmpty()) {
+        QPair<int, int> arc = pending.takeLast();
+        int middle = middleOf(arc.first, arc.second);
+
+        if (middle < 0) {
+            path.append(arc.second);
+        } else {
+            pending.append(qMakePair(middle, arc.second));
+            pending.append(qMakePair(arc.first, middle));
+        }
+    }
+}
+
+bool ContractionHierarchy::matches(const GraphSnapshot &snapshot) const
+{
+    bool isMatching = !isEmpty() && snapshot.vertexCount() == vertexCount();
+
+    for (int vertex = 0; vertex < vertexCount() && isMatching; ++vertex) {
+        isMatching = snapshot.vertexId(vertex) == m_vertexIds[vertex];
+    }
+
+    return isMatching && fingerprint(snapshot) == m_fingerprint;
+}
+
+QString ContractionHierarchy::fileNameFor(const QString &graphFilename)
+{
+    return graphFilename + ".ch";
+}
+
+// Self-loops are left out, as neither Graph nor the hierarchy keeps them.
+quint64 ContractionHierarchy::fingerprint(const GraphSnapshot &snapshot)
+{
+    quint64 vertexHash = mix(snapshot.vertexCount());
+    quint64 edgeHash = 0;
+
+    for (int vertex = 0; vertex < snapshot.vertexCount(); ++vertex) {
+        vertexHash = mix(vertexHash ^ static_cast<quint32>(snapshot.vertexId(vertex)));
+    }
+    for (int edge = 0; edge < snapshot.edgeCount(); ++edge) {
+        if (snapshot.source(edge) != snapshot.target(edge)) {
+            quint64 endpoints = (static_cast<quint64>(snapshot.source(edge)) << 32) | static_cast<quint32>(snapshot.target(edge));
+            edgeHash += mix(mix(endpoints) ^ static_cast<quint32>(snapshot.weight(edge)));
+        }
+    }
+
+    return mix(vertexHash ^ edgeHash);
+}
+
+bool ContractionHierarchy::write(const QString &filename) const
+{
+    QByteArray buffer(HEADER_SIZE, '\0');
+    for (const QVector<int> *values : {&m_vertexIds, &m_upOffsets, &m_upTargets, &m_upWeights, &m_upMiddles,
+                                       &m_downOffsets, &m_downSources, &m_downWeights, &m_downMiddles}) {
+        appendInts(buffer, *values);
+    }
+
+    uchar *header = reinterpret_cast<uchar*>(buffer.data());
+    std::memcpy(header, MAGIC, sizeof(MAGIC));
+    qToLittleEndian<quint16>(FORMAT_VERSION, header + 8);
+    qToLittleEndian<quint32>(vertexCount(), header + 12);
+    qToLittleEndian<quint32>(m_upTargets.size(), header + 16);
+    qToLittleEndian<quint32>(m_downSources.size(), header + 20);
+    qToLittleEndian<quint64>(m_fingerprint, header + 24);
+    qToLittleEndian<quint32>(GraphFile::checksum(header + HEADER_SIZE, buffer.size() - HEADER_SIZE), header + 32);
+    qToLittleEndian<quint32>(GraphFile::checksum(header, 36), header + 36);
+
+    QSaveFile file(filename);
+    bool isSaveSuccessful = !isEmpty()
+        && file.open(QIODevice::WriteOnly)
+        && file.write(buffer) == buffer.size()
+        && file.commit();
+
+    return isSaveSuccessful;
+}
+
+// A file that fails any check leaves the hierarchy empty.
+bool ContractionHierarchy::read(const QString &filename)
+{
+    clear();
+
+    QFile file(filename);
+    QByteArray contents;
+    if (file.open(QIODevice::ReadOnly)) {
+        contents = file.readAll();
+        file.close();
+    }
+
+    const uchar *data = reinterpret_cast<const uchar*>(contents.constData());
+    const uchar *end = data + contents.size();
+    bool isValid = contents.size() >= HEADER_SIZE && std::memcmp(data, MAGIC, sizeof(MAGIC)) == 0
+        && qFromLittleEndian<quint16>(data + 8) == FORMAT_VERSION
+        && qFromLittleEndian<quint32>(data + 36) == GraphFile::checksum(data, 36)
+        && qFromLittleEndian<quint32>(data + 32) == GraphFile::checksum(data + HEADER_SIZE, contents.size() - HEADER_SIZE);
+
+    if (isValid) {
+        qint64 vertexCount = qFromLittleEndian<quint32>(data + 12);
+        qint64 upCount = qFromLittleEndian<quint32>(data + 16);
+        qint64 downCount = qFromLittleEndian<quint32>(data + 20);
+        const uchar *cursor = data + HEADER_SIZE;
+
+        isValid = vertexCount > 0 && vertexCount < std::numeric_limits<int>::max()
+            && readInts(cursor, end, vertexCount, m_vertexIds)
+            && readInts(cursor, end, vertexCount + 1, m_upOffsets)
+            && readInts(cursor, end, upCount, m_upTargets)
+            && readInts(cursor, end, upCount, m_upWeights)
+            && readInts(cursor, end, upCount, m_upMiddles)
+            && readInts(cursor, end, vertexCount + 1, m_downOffsets)
+            && readInts(cursor, end, downCount, m_downSources)
+            && readInts(cursor, end, downCount, m_downWeights)
+            && readInts(cursor, end, downCount, m_downMiddles)
+            && cursor == end
+            && isValidCsr(m_upOffsets, m_upTargets, m_upWeights, m_upMiddles, vertexCount)
+            && isValidCsr(m_downOffsets, m_downSources, m_downWeights, m_downMiddles, vertexCount);
+
+        if (isValid) {
+            indexVertexIds();
+            m_fingerprint = qFromLittleEndian<quint64>(data + 24);
+            isValid = m_indexById.size() == vertexCount;
+        }
+    }
+
+    if (!isValid) {
+        clear();
+    }
+
+    return isValid;
+}
+
+void ContractionHierarchy::indexVertexIds()
+{
+    m_indexById.clear();
+    m_indexById.reserve(m_vertexIds.size());
+    for (int vertex = 0; vertex < m_vertexIds.size(); ++vertex) {
+        m_indexById.insert(m_vertexIds[vertex], vertex);
+    }
+}
+
+void ContractionHierarchy::clear()
+{
+    m_fingerprint = 0;
+    m_vertexIds.clear();
+    m_indexById.clear();
+    m_upOffsets.clear();
+    m_upTargets.clear();
+    m_upWeights.clear();
+    m_upMiddles.clear();
+    m_downOffsets.clear();
+    m_downSources.clear();
+    m_downWeights.clear();
+    m_downMiddles.clear();
+}
+
+ContractionHierarchy::Query::Query(const ContractionHierarchy &hierarchy)
+    : m_hierarchy(hierarchy)
+    , m_forwardDistances(hierarchy.vertexCount(), UNREACHABLE)
+    , m_backwardDistances(hierarchy.vertexCount(), UNREACHABLE)
+    , m_forwardPrevious(hierarchy.vertexCount(), -1)
+    , m_backwardNext(hierarchy.vertexCount(), -1)
+    , m_isTouched(hierarchy.vertexCount(), false)
+    , m_forwardHeap(hierarchy.vertexCount())
+    , m_backwardHeap(hierarchy.vertexCount())
+{
+}
+
+// Both searches only follow arcs towards more important vertices, so they
+// cannot stop when they first meet: each runs until its queue minimum
+// reaches the best distance through any vertex settled by both.
+ContractionHierarchy::Result ContractionHierarchy::Query::run(int source, int target)
+{
+    const ContractionHierarchy &hierarchy = m_hierarchy;
+    Result result;
+    int best = UNREACHABLE;
+    int meeting = -1;
+
+    touch(source);
+    touch(target);
+    m_forwardDistances[source] = 0;
+    m_backwardDistances[target] = 0;
+    m_forwardHeap.push(source, 0);
+    m_backwardHeap.push(target, 0);
+
+    while (!m_forwardHeap.isEmpty() || !m_backwardHeap.isEmpty()) {
+        bool isForward = !m_forwardHeap.isEmpty()
+            && (m_backwardHeap.isEmpty() || m_forwardHeap.topKey() <= m_backwardHeap.topKey());
+        IndexedDaryHeap &heap = isForward ? m_forwardHeap : m_backwardHeap;
+
+        if (heap.topKey() >= best) {
+            heap.clear();
+        } else {
+            int current = heap.pop();
+            result.settledCount++;
+
+            if (m_forwardDistances[current] != UNREACHABLE && m_backwardDistances[current] != UNREACHABLE
+                && static_cast<qint64>(m_forwardDistances[current]) + m_backwardDistances[current] < best) {
+                best = m_forwardDistances[current] + m_backwardDistances[current];
+                meeting = current;
+            }
+
+            if (isForward) {
+                for (int arc = hierarchy.m_upOffsets[current]; arc < hierarchy.m_upOffsets[current + 1]; ++arc) {
+                    int neighbor = hierarchy.m_upTargets[arc];
+                    qint64 alternative = static_cast<qint64>(m_forwardDistances[current]) + hierarchy.m_upWeights[arc];
+                    touch(neighbor);
+                    if (alternative < m_forwardDistances[neighbor]) {
+                        m_forwardDistances[neighbor] = static_cast<int>(alternative);
+                        m_forwardPrevious[neighbor] = current;
+                        m_forwardHeap.push(neighbor, m_forwardDistances[neighbor]);
+                    }
+                }
+            } else {
+                for (int arc = hierarchy.m_downOffsets[current]; arc < hierarchy.m_downOffsets[current + 1]; ++arc) {
+                    int neighbor = hierarchy.m_downSources[arc];
+                    qint64 alternative = static_cast<qint64>(m_backwardDistances[current]) + hierarchy.m_downWeights[arc];
+                    touch(neighbor);
+                    if (alternative < m_backwardDistances[neighbor]) {
+                        m_backwardDistances[neighbor] = static_cast<int>(alternative);
+                        m_backwardNext[neighbor] = current;
+                        m_backwardHeap.push(neighbor, m_backwardDistances[neighbor]);
+                    }
+                }
+            }
+        }
+    }
+
+    if (meeting >= 0) {
+        QVector<int> vertices;
+        for (int vertex = meeting; vertex >= 0; vertex = m_forwardPrevious[vertex]) {
+            vertices.append(vertex);
+        }
+        std::reverse(vertices.begin(), vertices.end());
+        for (int vertex = m_backwardNext[meeting]; vertex >= 0; vertex = m_backwardNext[vertex]) {
+            vertices.append(vertex);
+        }
+
+        result.distance = best;
+        hierarchy.appendUnpacked(vertices, result.path);
+    }
+
+    reset();
+    return result;
+}
+
+void ContractionHierarchy::Query::touch(int vertex)
+{
+    if (!m_isTouched[vertex]) {
+        m_isTouched[vertex] = true;
+        m_touched.append(vertex);
+    }
+}
+
+void ContractionHierarchy::Query::reset()
+{
+    for (int vertex : m_touched) {
+        m_forwardDistances[vertex] = UNREACHABLE;
+        m_backwardDistances[vertex] = UNREACHABLE;
+        m_forwardPrevious[vertex] = -1;
+        m_backwardNext[vertex] = -1;
+        m_isTouched[vertex] = false;
+    }
+    m_touched.clear();
+    m_forwardHeap.clear();
+    m_backwardHeap.clear();
+}
@@ -0,0 +1,136 @@
+#ifndef CONTRACTIONHIERARCHY_H
+#define CONTRACTIONHIERARCHY_H
+
+#include "GraphSnapshot.h"
+#include "AlgorithmProgress.h"
+#include "PriorityQueues.h"
+#include <QVector>
+#include <QHash>
+#include <QString>
+#include <limits>
+
+// Contraction hierarchy over a GraphSnapshot for repeated point-to-point
+// queries on a graph that does not change. Building contracts the vertices
+// one by one in order of importance and adds a shortcut u->w whenever a
+// shortest path u->v->w would otherwise be lost with v. A query is then a
+// bidirectional Dijkstra that only climbs towards more important vertices
+// and settles a few hundred of them on road-like graphs.
+//
+// The hierarchy keeps the vertex ids and a fingerprint of the edges and
+// weights it was built from; matches() tells whether it still fits a
+// snapshot, e.g. one loaded next to a saved hierarchy. Weights must not be
+// negative. Vertex indices are those of the snapshot it was built from.
+class ContractionHierarchy
+{
+public:
+    static constexpr int UNREACHABLE = std::numeric_limits<int>::max();
+
+    struct Result {
+        int distance = UNREACHABLE;
+        QVector<int> path;
+        int settledCount = 0;
+    };
+
+    // Scratch for queries against one hierarchy. The hierarchy itself is
+    // never written to, so each thread can query it through its own Query.
+    class Query
+    {
+    public:
+        explicit Query(const ContractionHierarchy &hierarchy);
+
+        const ContractionHierarchy& hierarchy() const { return m_hierarchy; }
+        Result run(int source, int target);
+
+    private:
+        void touch(int vertex);
+        void reset();
+
+        const ContractionHierarchy &m_hierarchy;
+        QVector<int> m_forwardDistances;
+        QVector<int> m_backwardDistances;
+        QVector<int> m_forwardPrevious;
+        QVector<int> m_backwardNext;
+        QVector<bool> m_isTouched;
+        QVector<int> m_touched;
+        IndexedDaryHeap m_forwardHeap;
+        IndexedDaryHeap m_backwardHeap;
+    };
+
+    ContractionHierarchy();
+
+    // False, leaving the hierarchy empty, when cancelled or when the
+    // snapshot has negative weights.
+    bool build(const GraphSnapshot &snapshot, AlgorithmProgress *progress = nullptr);
+
+    bool isEmpty() const { return m_vertexIds.isEmpty(); }
+    int vertexCount() const { return m_vertexIds.size(); }
+    int arcCount() const { return m_upTargets.size() + m_downSources.size(); }
+    int vertexId(int vertex) const { return m_vertexIds[vertex]; }
+    int indexOf(int vertexId) const { return m_indexById.value(vertexId, -1); }
+    bool matches(const GraphSnapshot &snapshot) const;
+
+    bool write(const QString &filename) const;
+    bool read(const QString &filename);
+
+    // Where the hierarchy of a .graph file is kept: next to it, with a
+    // ".ch" suffix.
+    static QString fileNameFor(const QString &graphFilename);
+    // Hash of the vertex ids in order and of the edge set with weights;
+    // edge order does not matter.
+    static quint64 fingerprint(const GraphSnapshot &snapshot);
+
+private:
+    // An arc of the graph being contracted. middle is the vertex a
+    // shortcut bypasses, -1 for an original edge.
+    struct Arc {
+        int vertex;
+        int weight;
+        int middle;
+    };
+
+    // Working state of build(): the arcs of the remaining graph, the final
+    // arcs of contracted vertices and the witness search.
+    struct Contraction {
+        explicit Contraction(int vertexCount);
+
+        QVector<QVector<Arc>> outArcs;
+        QVector<QVector<Arc>> inArcs;
+        QVector<bool> isPriorityStale;
+        QVector<int> contractedNeighbors;
+        QVector<int> levels;
+        QVector<int> witnessDistances;
+        QVector<int> witnessTouched;
+        IndexedDaryHeap witnessHeap;
+    };
+
+    static const int MAX_WITNESS_SETTLED = 64;
+
+    static void addArc(QVector<Arc> &arcs, int vertex, int weight, int middle);
+    static int contract(Contraction &state, int vertex, bool isSimulation);
+    static int priority(Contraction &state, int vertex);
+    static void witnessSearch(Contraction &state, int source, int excluded, qint64 limit);
+    static void detach(Contraction &state, int vertex);
+    void storeArcs(const Contraction &state);
+    int middleOf(int from, int to) const;
+    void appendUnpacked(const QVector<int> &vertices, QVector<int> &path) const;
+    void indexVertexIds();
+    void clear();
+
+    quint64 m_fingerprint;
+    QVector<int> m_vertexIds;
+    QHash<int, int> m_indexById;
+
+    // Arcs from v to more important vertices occupy slots
+    // m_upOffsets[v]..m_upOffsets[v + 1] - 1 of the up arrays; arcs into v
+    // from more important vertices likewise through m_downOffsets.
+    QVector<int> m_upOffsets;
+    QVector<int> m_upTargets;
+    QVector<int> m_upWeights;
+    QVector<int> m_upMiddles;
+    QVector<int> m_downOffsets;
+    QVector<int> m_downSources;
+    QVector<int> m_downWeights;
+    QVector<int> m_downMiddles;
+};
+
+#endif
@@ -0,0 +1,543 @@
+#include "DynamicComponents.h"
+#include "Vertex.h"
+#include "Edge.h"
+#include <algorithm>
+
+DynamicComponents::DynamicComponents()
+    : m_nextComponent(0)
+    , m_weakComponentCount(0)
+    , m_isWeakCurrent(true)
+{
+}
+
+// Starts from a single component holding everything, which split() then
+// takes apart with one Tarjan pass over the whole graph.
+void DynamicComponents::reset(const QVector<Vertex*> &vertices)
+{
+    clear();
+
+    if (!vertices.isEmpty()) {
+        int component = createComponent();
+        place(component, 0);
+        Component &all = m_components[component];
+        all.members.reserve(vertices.size());
+        m_componentOf.reserve(vertices.size());
+
+        for (const Vertex *vertex : vertices) {
+            all.members.append(vertex);
+            m_componentOf.insert(vertex, component);
+        }
+
+        split(component);
+        m_isWeakCurrent = false;
+    }
+}
+
+void DynamicComponents::clear()
+{
+    m_componentOf.clear();
+    m_components.clear();
+    m_order.clear();
+    m_nextComponent = 0;
+    m_weakParent.clear();
+    m_weakComponentCount = 0;
+    m_isWeakCurrent = true;
+}
+
+// A vertex without edges can go anywhere in the order; it goes last.
+void DynamicComponents::addVertex(const Vertex *vertex)
+{
+    int component = createComponent();
+    place(component, m_order.isEmpty() ? 0 : m_order.lastKey() + LABEL_GAP);
+    m_components[component].members.append(vertex);
+    m_componentOf.insert(vertex, component);
+
+    if (m_isWeakCurrent) {
+        m_weakParent.insert(vertex, vertex);
+        m_weakComponentCount++;
+    }
+}
+
+void DynamicComponents::removeVertex(const Vertex *vertex)
+{
+    int component = m_componentOf.take(vertex);
+
+    for (const Edge *edge : vertex->outEdges()) {
+        int neighborComponent = m_componentOf.value(edge->to(), -1);
+        if (neighborComponent >= 0 && neighborComponent != component) {
+            disconnect(component, neighborComponent, 1);
+        }
+    }
+    for (const Edge *edge : vertex->inEdges()) {
+        int neighborComponent = m_componentOf.value(edge->from(), -1);
+        if (neighborComponent >= 0 && neighborComponent != component) {
+            disconnect(neighborComponent, component, 1);
+        }
+    }
+
+    Component &remaining = m_components[component];
+    remaining.members.removeOne(vertex);
+    if (remaining.members.isEmpty()) {
+        unplace(component);
+        m_components.remove(component);
+    } else {
+        split(component);
+    }
+
+    m_isWeakCurrent = false;
+}
+
+// An edge that agrees with the order costs nothing more. Otherwise the
+// order is repaired between the two components, which also finds out
+// whether the edge closed a cycle.
+void DynamicComponents::addEdge(const Vertex *from, const Vertex *to)
+{
+    int fromComponent = componentOf(from);
+    int toComponent = componentOf(to);
+
+    if (fromComponent >= 0 && toComponent >= 0 && fromComponent != toComponent) {
+        if (m_components[fromComponent].label < m_components[toComponent].label) {
+            connect(fromComponent, toComponent, 1);
+        } else {
+            reorder(fromComponent, toComponent);
+        }
+    }
+
+    if (m_isWeakCurrent && fromComponent >= 0 && toComponent >= 0) {
+        uniteWeak(from, to);
+    }
+}
+
+// A parallel edge left behind keeps the component together, so only the
+// last edge between two members can split it.
+void DynamicComponents::removeEdge(const Vertex *from, const Vertex *to)
+{
+    int fromComponent = componentOf(from);
+    int toComponent = componentOf(to);
+
+    if (fromComponent >= 0 && toComponent >= 0) {
+        if (fromComponent == toComponent) {
+            if (!from->hasOutNeighbor(to)) {
+                split(fromComponent);
+            }
+        } else {
+            disconnect(fromComponent, toComponent, 1);
+        }
+    }
+
+    m_isWeakCurrent = false;
+}
+
+bool DynamicComponents::isStronglyConnected(const Vertex *first, const Vertex *second) const
+{
+    int component = componentOf(first);
+    return component >= 0 && component == componentOf(second);
+}
+
+bool DynamicComponents::isAcyclic() const
+{
+    return m_components.size() == m_componentOf.size();
+}
+
+// Deletions cannot be undone in a union-find, so they only mark it stale
+// and the next call rebuilds it from all edges.
+int DynamicComponents::weakComponentCount() const
+{
+    if (!m_isWeakCurrent) {
+        m_weakParent.clear();
+        m_weakParent.reserve(m_componentOf.size());
+        for (auto vertex = m_componentOf.constBegin(); vertex != m_componentOf.constEnd(); ++vertex) {
+            m_weakParent.insert(vertex.key(), vertex.key());
+        }
+        m_weakComponentCount = m_componentOf.size();
+        m_isWeakCurrent = true;
+
+        for (auto vertex = m_componentOf.constBegin(); vertex != m_componentOf.constEnd(); ++vertex) {
+            for (const Edge *edge : vertex.key()->outEdges()) {
+                if (m_componentOf.contains(edge->to())) {
+                    uniteWeak(vertex.key(), edge->to());
+                }
+            }
+        }
+    }
+
+    return m_weakComponentCount;
+}
+
+const QVector<const Vertex*>& DynamicComponents::members(int component) const
+{
+    static const Component empty;
+    auto found = m_components.constFind(component);
+    return found != m_components.constEnd() ? found->members : empty.members;
+}
+
+const QHash<int, int>& DynamicComponents::successors(int component) const
+{
+    static const Component empty;
+    auto found = m_components.constFind(component);
+    return found != m_components.constEnd() ? found->successors : empty.successors;
+}
+
+QVector<int> DynamicComponents::topologicalOrder() const
+{
+    return m_order.values();
+}
+
+int DynamicComponents::createComponent()
+{
+    int component = m_nextComponent++;
+    m_components.insert(component, Component());
+    return component;
+}
+
+void DynamicComponents::place(int component, qint64 label)
+{
+    m_components[component].label = label;
+    m_order.insert(label, component);
+}
+
+void DynamicComponents::unplace(int component)
+{
+    m_order.remove(m_components[component].label);
+}
+
+void DynamicComponents::connect(int from, int to, int count)
+{
+    m_components[from].successors[to] += count;
+    m_components[to].predecessors[from] += count;
+}
+
+void DynamicComponents::disconnect(int from, int to, int count)
+{
+    QHash<int, int> &successors = m_components[from].successors;
+    QHash<int, int> &predecessors = m_components[to].predecessors;
+
+    if ((successors[to] -= count) <= 0) {
+        successors.remove(to);
+        predecessors.remove(from);
+    } else {
+        predecessors[from] -= count;
+    }
+}
+
+// Drops every condensation edge into or out of component.
+void DynamicComponents::detachComponent(int component)
+{
+    Component &detached = m_components[component];
+
+    for (auto successor = detached.successors.constBegin(); successor != detached.successors.constEnd(); ++successor) {
+        m_components[successor.key()].predecessors.remove(component);
+    }
+    for (auto predecessor = detached.predecessors.constBegin(); predecessor != detached.predecessors.constEnd(); ++predecessor) {
+        m_components[predecessor.key()].successors.remove(component);
+    }
+
+    detached.successors.clear();
+    detached.predecessors.clear();
+}
+
+// Pearce-Kelly repair for an edge from -> to with from placed after to.
+// Only components placed between the two can be affected: those reachable
+// from to and those reaching from. The ones reaching from move in front of
+// the ones reachable from to, each group keeping its relative order, and
+// both take over the labels the groups held. Components in both groups lie
+// on a cycle with the new edge and merge into one, placed between them.
+void DynamicComponents::reorder(int from, int to)
+{
+    QVector<int> forward = searchForward(to, m_components[from].label);
+    QVector<int> backward = searchBackward(from, m_components[to].label);
+    QSet<int> forwardSet(forward.constBegin(), forward.constEnd());
+    QSet<int> cycle;
+    QVector<qint64> labels;
+
+    for (int component : backward) {
+        if (forwardSet.contains(component)) {
+            cycle.insert(component);
+        }
+        labels.append(m_components[component].label);
+    }
+    for (int component : forward) {
+        if (!cycle.contains(component)) {
+            labels.append(m_components[component].label);
+        }
+    }
+
+    auto isPlacedBefore = [this](int first, int second) {
+        return m_components[first].label < m_components[second].label;
+    };
+    std::sort(labels.begin(), labels.end());
+    std::sort(backward.begin(), backward.end(), isPlacedBefore);
+    std::sort(forward.begin(), forward.end(), isPlacedBefore);
+    for (int component : backward) {
+        unplace(component);
+    }
+    for (int component : forward) {
+        if (!cycle.contains(component)) {
+            unplace(component);
+        }
+    }
+
+    int next = 0;
+    for (int component : backward) {
+        if (!cycle.contains(component)) {
+            place(component, labels[next++]);
+        }
+    }
+    if (!cycle.isEmpty()) {
+        place(merge(cycle), labels[next]);
+    }
+    next = labels.size() - (forward.size() - cycle.size());
+    for (int component : forward) {
+        if (!cycle.contains(component)) {
+            place(component, labels[next++]);
+        }
+    }
+
+    if (cycle.isEmpty()) {
+        connect(from, to, 1);
+    }
+}
+
+// Components reachable from start without passing a label above upper.
+QVector<int> DynamicComponents::searchForward(int start, qint64 upper) const
+{
+    QVector<int> reached{start};
+    QSet<int> isReached{start};
+
+    for (int i = 0; i < reached.size(); ++i) {
+        const QHash<int, int> &next = m_components.constFind(reached[i])->successors;
+        for (auto successor = next.constBegin(); successor != next.constEnd(); ++successor) {
+            if (m_components.constFind(successor.key())->label <= upper && !isReached.contains(successor.key())) {
+                isReached.insert(successor.key());
+                reached.append(successor.key());
+            }
+        }
+    }
+
+    return reached;
+}
+
+// Components reaching start without passing a label below lower.
+QVector<int> DynamicComponents::searchBackward(int start, qint64 lower) const
+{
+    QVector<int> reached{start};
+    QSet<int> isReached{start};
+
+    for (int i = 0; i < reached.size(); ++i) {
+        const QHash<int, int> &previous = m_components.constFind(reached[i])->predecessors;
+        for (auto predecessor = previous.constBegin(); predecessor != previous.constEnd(); ++predecessor) {
+            if (m_components.constFind(predecessor.key())->label >= lower && !isReached.contains(predecessor.key())) {
+                isReached.insert(predecessor.key());
+                reached.append(predecessor.key());
+            }
+        }
+    }
+
+    return reached;
+}
+
+// The largest component absorbs the others, so the fewest members move.
+// Condensation edges between merged components disappear; the rest are
+// redirected to the survivor, which is returned unplaced.
+int DynamicComponents::merge(const QSet<int> &components)
+{
+    int survivor = *components.constBegin();
+    for (int component : components) {
+        if (m_components[component].members.size() > m_components[survivor].members.size()) {
+            survivor = component;
+        }
+    }
+
+    for (int component : components) {
+        if (component != survivor) {
+            Component absorbed = m_components.take(component);
+
+            for (const Vertex *member : absorbed.members) {
+                m_componentOf[member] = survivor;
+            }
+            m_components[survivor].members.append(absorbed.members);
+
+            for (auto successor = absorbed.successors.constBegin(); successor != absorbed.successors.constEnd(); ++successor) {
+                if (!components.contains(successor.key())) {
+                    m_components[successor.key()].predecessors.remove(component);
+                    connect(survivor, successor.key(), successor.value());
+                }
+            }
+            for (auto predecessor = absorbed.predecessors.constBegin(); predecessor != absorbed.predecessors.constEnd(); ++predecessor) {
+                if (!components.contains(predecessor.key())) {
+                    m_components[predecessor.key()].successors.remove(component);
+                    connect(predecessor.key(), survivor, predecessor.value());
+                }
+            }
+
+            m_components[survivor].successors.remove(component);
+            m_components[survivor].predecessors.remove(component);
+        }
+    }
+
+    return survivor;
+}
+
+// Recomputes component after it lost an edge or a vertex. When it falls
+// apart, the first part keeps its id and the condensation edges of all
+// parts are rebuilt from their members' neighbours. Tarjan finds the parts
+// sinks first; they take the component's place in the order, reversed.
+void DynamicComponents::split(int component)
+{
+    QVector<QVector<const Vertex*>> parts = tarjan(m_components[component].members);
+
+    if (parts.size() > 1) {
+        detachComponent(component);
+
+        QSet<int> partIds;
+        QVector<int> orderedParts;
+        for (int i = 0; i < parts.size(); ++i) {
+            int part = (i == 0) ? component : createComponent();
+            for (const Vertex *member : parts[i]) {
+                m_componentOf[member] = part;
+            }
+            m_components[part].members = parts[i];
+            partIds.insert(part);
+            orderedParts.prepend(part);
+        }
+
+        qint64 label = m_components[component].label;
+        auto next = m_order.upperBound(label);
+        qint64 step = (next == m_order.constEnd()) ? LABEL_GAP : (next.key() - label) / orderedParts.size();
+        if (step > 0) {
+            unplace(component);
+            for (int i = 0; i < orderedParts.size(); ++i) {
+                place(orderedParts[i], label + i * step);
+            }
+        } else {
+            relabel(component, orderedParts);
+        }
+
+        for (int part : partIds) {
+            for (const Vertex *member : m_components[part].members) {
+                for (const Edge *edge : member->outEdges()) {
+                    int neighborComponent = m_componentOf.value(edge->to(), -1);
+                    if (neighborComponent >= 0 && neighborComponent != part) {
+                        connect(part, neighborComponent, 1);
+                    }
+                }
+                for (const Edge *edge : member->inEdges()) {
+                    int neighborComponent = m_componentOf.value(edge->from(), -1);
+                    if (neighborComponent >= 0 && !partIds.contains(neighborComponent)) {
+                        connect(neighborComponent, part, 1);
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Spreads the labels evenly again, with replacement standing in for
+// component, when there is no room left between two neighbours.
+void DynamicComponents::relabel(int component, const QVector<int> &replacement)
+{
+    QVector<int> order;
+    order.reserve(m_order.size() + replacement.size());
+    for (auto placed = m_order.constBegin(); placed != m_order.constEnd(); ++placed) {
+        if (placed.value() == component) {
+            order.append(replacement);
+        } else {
+            order.append(placed.value());
+        }
+    }
+
+    m_order.clear();
+    for (int i = 0; i < order.size(); ++i) {
+        place(order[i], i * LABEL_GAP);
+    }
+}
+
+const Vertex* DynamicComponents::weakRoot(const Vertex *vertex) const
+{
+    const Vertex *root = vertex;
+    while (m_weakParent[root] != root) {
+        m_weakParent[root] = m_weakParent[m_weakParent[root]];
+        root = m_weakParent[root];
+    }
+    return root;
+}
+
+void DynamicComponents::uniteWeak(const Vertex *first, const Vertex *second) const
+{
+    const Vertex *firstRoot = weakRoot(first);
+    const Vertex *secondRoot = weakRoot(second);
+
+    if (firstRoot != secondRoot) {
+        m_weakParent[firstRoot] = secondRoot;
+        m_weakComponentCount--;
+    }
+}
+
+// Iterative Tarjan restricted to members, following only edges between them.
+QVector<QVector<const Vertex*>> DynamicComponents::tarjan(const QVector<const Vertex*> &members) const
+{
+    int memberCount = members.size();
+    QHash<const Vertex*, int> localIndex;
+    localIndex.reserve(memberCount);
+    for (int i = 0; i < memberCount; ++i) {
+        localIndex.insert(members[i], i);
+    }
+
+    QVector<int> index(memberCount, -1);
+    QVector<int> lowLink(memberCount, 0);
+    QVector<bool> onStack(memberCount, false);
+    QVector<int> componentStack;
+    QVector<int> callStack;
+    QVector<int> nextNeighbor;
+    QVector<QVector<const Vertex*>> parts;
+    int counter = 0;
+
+    for (int root = 0; root < memberCount; ++root) {
+        if (index[root] < 0) {
+            index[root] = lowLink[root] = counter++;
+            componentStack.append(root);
+            onStack[root] = true;
+            callStack.append(root);
+            nextNeighbor.append(0);
+
+            while (!callStack.isEmpty()) {
+                int vertex = callStack.last();
+                const EdgeList &edges = members[vertex]->outEdges();
+
+                if (nextNeighbor.last() < edges.size()) {
+                    const Vertex *neighbor = edges.at(nextNeighbor.last()++)->to();
+                    int local = localIndex.value(neighbor, -1);
+
+                    if (local >= 0 && index[local] < 0) {
+                        index[local] = lowLink[local] = counter++;
+                        componentStack.append(local);
+                        onStack[local] = true;
+                        callStack.append(local);
+                        nextNeighbor.append(0);
+                    } else if (local >= 0 && onStack[local]) {
+                        lowLink[vertex] = qMin(lowLink[vertex], index[local]);
+                    }
+                } else {
+                    callStack.removeLast();
+                    nextNeighbor.removeLast();
+                    if (!callStack.isEmpty()) {
+                        lowLink[callStack.last()] = qMin(lowLink[callStack.last()], lowLink[vertex]);
+                    }
+
+                    if (lowLink[vertex] == index[vertex]) {
+                        QVector<const Vertex*> part;
+                        int member = -1;
+                        while (member != vertex) {
+                            member = componentStack.takeLast();
+                            onStack[member] = false;
+                            part.append(members[member]);
+                        }
+                        parts.append(part);
+                    }
+                }
+            }
+        }
+    }
+
+    return parts;
+}
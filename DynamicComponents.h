@@ -0,0 +1,90 @@
+#ifndef DYNAMICCOMPONENTS_H
+#define DYNAMICCOMPONENTS_H
+
+#include <QHash>
+#include <QMap>
+#include <QSet>
+#include <QVector>
+
+class Vertex;
+
+// Strongly connected components of a Graph, kept current edit by edit
+// instead of recomputed. An edge closing a cycle through the condensation
+// merges the components along it; removing an edge or vertex inside a
+// component reruns Tarjan on that component alone. Between edits,
+// componentOf() is a hash lookup and the condensation is always at hand.
+//
+// The components also keep a topological order of the condensation,
+// repaired Pearce-Kelly style on each insertion that contradicts it, so on
+// a DAG the order of the vertices is ready without any traversal.
+//
+// The Graph calls the update functions with its adjacency already in the new
+// state, except removeVertex, which needs the neighbours still attached.
+// Component ids are stable until the component merges or splits.
+class DynamicComponents
+{
+public:
+    DynamicComponents();
+
+    void reset(const QVector<Vertex*> &vertices);
+    void clear();
+
+    void addVertex(const Vertex *vertex);
+    void removeVertex(const Vertex *vertex);
+    void addEdge(const Vertex *from, const Vertex *to);
+    void removeEdge(const Vertex *from, const Vertex *to);
+
+    int componentCount() const { return m_components.size(); }
+    int componentOf(const Vertex *vertex) const { return m_componentOf.value(vertex, -1); }
+    bool isStronglyConnected(const Vertex *first, const Vertex *second) const;
+    // Whether every component is a single vertex.
+    bool isAcyclic() const;
+    int weakComponentCount() const;
+    const QVector<const Vertex*>& members(int component) const;
+    // Condensation edges leaving component, with the number of graph edges
+    // each one stands for.
+    const QHash<int, int>& successors(int component) const;
+    // Component ids, every condensation edge pointing forward.
+    QVector<int> topologicalOrder() const;
+
+private:
+    // Order labels of newly placed components are this far apart, leaving
+    // room for splits to slot their parts in between.
+    static const qint64 LABEL_GAP = qint64(1) << 20;
+
+    struct Component {
+        QVector<const Vertex*> members;
+        QHash<int, int> successors;
+        QHash<int, int> predecessors;
+        qint64 label = 0;
+    };
+
+    int createComponent();
+    void place(int component, qint64 label);
+    void unplace(int component);
+    void connect(int from, int to, int count);
+    void disconnect(int from, int to, int count);
+    void detachComponent(int component);
+    void reorder(int from, int to);
+    QVector<int> searchForward(int start, qint64 upper) const;
+    QVector<int> searchBackward(int start, qint64 lower) const;
+    int merge(const QSet<int> &components);
+    void split(int component);
+    void relabel(int component, const QVector<int> &replacement);
+    const Vertex* weakRoot(const Vertex *vertex) const;
+    void uniteWeak(const Vertex *first, const Vertex *second) const;
+    QVector<QVector<const Vertex*>> tarjan(const QVector<const Vertex*> &members) const;
+
+    QHash<const Vertex*, int> m_componentOf;
+    QHash<int, Component> m_components;
+    QMap<qint64, int> m_order;
+    int m_nextComponent;
+
+    // Union-find over the vertices for weak connectivity, rebuilt lazily
+    // after deletions.
+    mutable QHash<const Vertex*, const Vertex*> m_weakParent;
+    mutable int m_weakComponentCount;
+    mutable bool m_isWeakCurrent;
+};
+
+#endif
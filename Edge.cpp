@@ -1,7 +1,8 @@
 #include "Edge.h"
 
-Edge::Edge(Vertex *from, Vertex *to, int weight)
-    : m_from(from)
+Edge::Edge(int id, Vertex *from, Vertex *to, int weight)
+    : m_id(id)
+    , m_from(from)
     , m_to(to)
     , m_weight(weight)
 {
@@ -3,11 +3,16 @@
 
 class Vertex;
 
+// Edges are owned by a Graph, which gives each one an id that stays fixed
+// while other edges come and go. Parallel edges differ only by id.
 class Edge
 {
 public:
-    Edge(Vertex *from, Vertex *to, int weight);
+    Edge(int id, Vertex *from, Vertex *to, int weight);
 
+    int id() const {
+        return m_id;
+    }
     Vertex* from() const {
         return m_from;
     }
@@ -17,10 +22,16 @@ public:
     int weight() const{
         return m_weight;
     }
+private:
+    // Only through Graph::setEdgeWeight, which drops what the old weight
+    // was baked into.
+    friend class Graph;
+
     void setWeight(int weight){
         m_weight = weight;
     }
-private:
+
+    int m_id;
     Vertex *m_from;
     Vertex *m_to;
     int m_weight;
@@ -0,0 +1,134 @@
+#include "EdgeList.h"
+
+EdgeArena::EdgeArena()
+    : m_current(nullptr)
+    , m_currentUsed(CHUNK_SLOTS)
+{
+    for (int i = 0; i < SIZE_CLASSES; ++i) {
+        m_freeBlocks[i] = nullptr;
+    }
+}
+
+EdgeArena::~EdgeArena()
+{
+    clear();
+}
+
+int EdgeArena::sizeClass(int capacity)
+{
+    int index = 0;
+    while ((1 << index) < capacity) {
+        index++;
+    }
+    return index;
+}
+
+// capacity must be a power of two. Blocks larger than a quarter chunk get a
+// chunk of their own.
+Edge** EdgeArena::allocate(int capacity)
+{
+    int index = sizeClass(capacity);
+    Edge **block = m_freeBlocks[index];
+
+    if (block) {
+        m_freeBlocks[index] = reinterpret_cast<Edge**>(block[0]);
+    } else if (capacity > CHUNK_SLOTS / 4) {
+        block = new Edge*[capacity];
+        m_chunks.append(block);
+    } else {
+        if (m_currentUsed + capacity > CHUNK_SLOTS) {
+            m_current = new Edge*[CHUNK_SLOTS];
+            m_currentUsed = 0;
+            m_chunks.append(m_current);
+        }
+        block = m_current + m_currentUsed;
+        m_currentUsed += capacity;
+    }
+
+    return block;
+}
+
+void EdgeArena::release(Edge **block, int capacity)
+{
+    int index = sizeClass(capacity);
+    block[0] = reinterpret_cast<Edge*>(m_freeBlocks[index]);
+    m_freeBlocks[index] = block;
+}
+
+void EdgeArena::clear()
+{
+    for (Edge **chunk : m_chunks) {
+        delete[] chunk;
+    }
+    m_chunks.clear();
+
+    for (int i = 0; i < SIZE_CLASSES; ++i) {
+        m_freeBlocks[i] = nullptr;
+    }
+    m_current = nullptr;
+    m_currentUsed = CHUNK_SLOTS;
+}
+
+EdgeList::EdgeList()
+    : m_size(0)
+    , m_capacity(INLINE_CAPACITY)
+{
+}
+
+bool EdgeList::contains(const Edge *edge) const
+{
+    bool isFound = false;
+    Edge* const *items = data();
+
+    for (int i = 0; i < m_size && !isFound; ++i) {
+        isFound = items[i] == edge;
+    }
+
+    return isFound;
+}
+
+void EdgeList::append(Edge *edge, EdgeArena &arena)
+{
+    if (m_size == m_capacity) {
+        int capacity = m_capacity * 2;
+        Edge **blocks = arena.allocate(capacity);
+        Edge **items = data();
+
+        for (int i = 0; i < m_size; ++i) {
+            blocks[i] = items[i];
+        }
+
+        if (m_capacity != INLINE_CAPACITY) {
+            arena.release(m_blocks, m_capacity);
+        }
+        m_blocks = blocks;
+        m_capacity = capacity;
+    }
+
+    data()[m_size++] = edge;
+}
+
+void EdgeList::removeOne(const Edge *edge)
+{
+    Edge **items = data();
+    int index = 0;
+
+    while (index < m_size && items[index] != edge) {
+        index++;
+    }
+
+    if (index < m_size) {
+        items[index] = items[m_size - 1];
+        m_size--;
+    }
+}
+
+// Returns a spilled block to the arena and empties the list.
+void EdgeList::release(EdgeArena &arena)
+{
+    if (m_capacity != INLINE_CAPACITY) {
+        arena.release(m_blocks, m_capacity);
+    }
+    m_size = 0;
+    m_capacity = INLINE_CAPACITY;
+}
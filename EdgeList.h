@@ -0,0 +1,73 @@
+#ifndef EDGELIST_H
+#define EDGELIST_H
+
+#include <QVector>
+
+class Edge;
+
+// Backing store for edge lists that outgrow their inline buffer. Blocks
+// hold a power-of-two number of pointers and are recycled through one free
+// list per size; clear() releases whole chunks.
+class EdgeArena
+{
+public:
+    EdgeArena();
+    ~EdgeArena();
+
+    EdgeArena(const EdgeArena &) = delete;
+    EdgeArena &operator=(const EdgeArena &) = delete;
+
+    Edge** allocate(int capacity);
+    void release(Edge **block, int capacity);
+    void clear();
+
+private:
+    static const int CHUNK_SLOTS = 16384;
+    static const int SIZE_CLASSES = 32;
+
+    static int sizeClass(int capacity);
+
+    QVector<Edge**> m_chunks;
+    Edge **m_freeBlocks[SIZE_CLASSES];
+    Edge **m_current;
+    int m_currentUsed;
+};
+
+// Small vector of incident edges: up to INLINE_CAPACITY entries live inside
+// the Vertex, larger lists move to a block from the owning Graph's EdgeArena.
+// Order is not preserved by removal. Trivially destructible so vertices can
+// be released slab-wise; the Graph returns spilled blocks itself.
+class EdgeList
+{
+public:
+    EdgeList();
+
+    EdgeList(const EdgeList &) = delete;
+    EdgeList &operator=(const EdgeList &) = delete;
+
+    int size() const { return m_size; }
+    bool isEmpty() const { return m_size == 0; }
+    Edge* const* begin() const { return data(); }
+    Edge* const* end() const { return data() + m_size; }
+    Edge* at(int index) const { return data()[index]; }
+    bool contains(const Edge *edge) const;
+
+    void append(Edge *edge, EdgeArena &arena);
+    void removeOne(const Edge *edge);
+    void release(EdgeArena &arena);
+
+private:
+    static const int INLINE_CAPACITY = 4;
+
+    Edge* const* data() const { return m_capacity == INLINE_CAPACITY ? m_inline : m_blocks; }
+    Edge** data() { return m_capacity == INLINE_CAPACITY ? m_inline : m_blocks; }
+
+    union {
+        Edge *m_inline[INLINE_CAPACITY];
+        Edge **m_blocks;
+    };
+    int m_size;
+    int m_capacity;
+};
+
+#endif
@@ -0,0 +1,546 @@
+#include "EdgeListImporter.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QThread>
+#include <QtMath>
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace {
+
+const qint64 MIN_CHUNK_BYTES = qint64(1) << 20;
+const int CHUNKS_PER_THREAD = 4;
+const qint64 MAX_COUNT = std::numeric_limits<int>::max() / 2;
+const int LAYOUT_SPACING = 60;
+
+bool isSeparator(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == ',' || c == ';' || c == '"';
+}
+
+// Tokens of one line, the line break excluded.
+struct LineReader {
+    const char *cursor;
+    const char *end;
+
+    char peek()
+    {
+        while (cursor < end && isSeparator(*cursor)) {
+            ++cursor;
+        }
+        return (cursor < end) ? *cursor : '\0';
+    }
+
+    void skipToken()
+    {
+        peek();
+        while (cursor < end && !isSeparator(*cursor)) {
+            ++cursor;
+        }
+    }
+
+    template <typename T>
+    bool read(T &value)
+    {
+        peek();
+        std::from_chars_result parsed = std::from_chars(cursor, end, value);
+        bool isRead = parsed.ec == std::errc() && (parsed.ptr == end || isSeparator(*parsed.ptr));
+        if (isRead) {
+            cursor = parsed.ptr;
+        }
+        return isRead;
+    }
+};
+
+// Moves cursor past the next line break.
+LineReader takeLine(const char *&cursor, const char *end)
+{
+    const char *lineEnd = static_cast<const char*>(std::memchr(cursor, '\n', end - cursor));
+    LineReader line = {cursor, lineEnd ? lineEnd : end};
+    cursor = lineEnd ? lineEnd + 1 : end;
+    return line;
+}
+
+// Takes lines up to the first that is neither blank nor a comment.
+LineReader takeContentLine(const char *&cursor, const char *end, const char *commentChars, int &lineCount)
+{
+    LineReader line = {end, end};
+    bool isContent = false;
+
+    while (!isContent && cursor < end) {
+        line = takeLine(cursor, end);
+        lineCount++;
+        char first = line.peek();
+        isContent = first != '\0' && !std::strchr(commentChars, first);
+    }
+
+    return isContent ? line : LineReader{end, end};
+}
+
+// Positions of ids in a sorted list. The id range is cut into at most as
+// many buckets as there are ids, so a lookup searches one bucket, usually
+// holding an id or two, instead of the whole list.
+class IdIndex
+{
+public:
+    explicit IdIndex(const QVector<qint64> &ids)
+        : m_ids(ids)
+        , m_shift(0)
+    {
+        int bucketCount = 0;
+        if (!ids.isEmpty()) {
+            while ((range(ids.last()) >> m_shift) >= static_cast<quint64>(ids.size())) {
+                m_shift++;
+            }
+            bucketCount = bucketOf(ids.last()) + 1;
+        }
+
+        m_bucketStarts.resize(bucketCount + 1);
+        int position = 0;
+        for (int bucket = 0; bucket <= bucketCount; ++bucket) {
+            while (position < ids.size() && bucketOf(ids.at(position)) < bucket) {
+                position++;
+            }
+            m_bucketStarts[bucket] = position;
+        }
+    }
+
+    int indexOf(qint64 id) const
+    {
+        int bucket = bucketOf(id);
+        QVector<qint64>::const_iterator first = m_ids.constBegin() + m_bucketStarts.at(bucket);
+        QVector<qint64>::const_iterator last = m_ids.constBegin() + m_bucketStarts.at(bucket + 1);
+        return static_cast<int>(std::lower_bound(first, last, id) - m_ids.constBegin());
+    }
+
+private:
+    quint64 range(qint64 id) const { return static_cast<quint64>(id) - static_cast<quint64>(m_ids.first()); }
+    int bucketOf(qint64 id) const { return static_cast<int>(range(id) >> m_shift); }
+
+    const QVector<qint64> &m_ids;
+    QVector<int> m_bucketStarts;
+    int m_shift;
+};
+
+}
+
+struct EdgeListImporter::Preamble {
+    const char *body = nullptr;
+    int lineCount = 0;
+    // Set when the format numbers vertices 1..vertexCount.
+    int vertexCount = -1;
+    qint64 entryCount = -1;
+    Mirror mirror = Mirror::None;
+    bool isPattern = false;
+};
+
+// Endpoints are external ids after parsing and vertex indices after
+// remapping; dense formats store indices right away.
+struct EdgeListImporter::Chunk {
+    const char *begin = nullptr;
+    const char *end = nullptr;
+    QVector<qint64> sources;
+    QVector<qint64> targets;
+    QVector<int> weights;
+    // Sorted distinct endpoints, for sparse formats.
+    QVector<qint64> ids;
+    qint64 entryCount = 0;
+    int lineCount = 0;
+    QString error;
+};
+
+EdgeListImporter::EdgeListImporter(int threadCount)
+{
+    m_pool.setMaxThreadCount(qMax(1, threadCount > 0 ? threadCount : QThread::idealThreadCount()));
+}
+
+bool EdgeListImporter::formatFor(const QString &filename, Format &format)
+{
+    QString suffix = QFileInfo(filename).suffix().toLower();
+    bool isKnown = true;
+
+    if (suffix == "mtx") {
+        format = Format::MatrixMarket;
+    } else if (suffix == "gr" || suffix == "dimacs" || suffix == "max") {
+        format = Format::Dimacs;
+    } else if (suffix == "csv") {
+        format = Format::Csv;
+    } else if (suffix == "txt" || suffix == "edges" || suffix == "el" || suffix == "tsv" || suffix == "snap") {
+        format = Format::Snap;
+    } else {
+        isKnown = false;
+    }
+
+    return isKnown;
+}
+
+bool EdgeListImporter::read(const QString &filename, Format format, GraphSnapshot &snapshot,
+                            AlgorithmProgress *progress)
+{
+    QFile file(filename);
+    bool isReadSuccessful = false;
+
+    m_errorString.clear();
+    if (!file.open(QIODevice::ReadOnly)) {
+        m_errorString = file.errorString();
+    } else {
+        qint64 size = file.size();
+        const char *data = size > 0 ? reinterpret_cast<const char*>(file.map(0, size)) : nullptr;
+        QByteArray contents;
+
+        if (!data) {
+            contents = file.readAll();
+            data = contents.constData();
+            size = contents.size();
+        }
+
+        isReadSuccessful = decode(data, data + size, format, snapshot, progress);
+        file.close();
+    }
+
+    return isReadSuccessful;
+}
+
+// Parsing takes the first 60 percent, numbering the vertices the next 20
+// and building the snapshot the rest.
+bool EdgeListImporter::decode(const char *data, const char *end, Format format, GraphSnapshot &snapshot,
+                              AlgorithmProgress *progress)
+{
+    Preamble preamble;
+    bool isValid = readPreamble(data, end, format, preamble);
+
+    if (isValid) {
+        QVector<Chunk> chunks = splitChunks(preamble.body, end, CHUNKS_PER_THREAD * m_pool.maxThreadCount());
+        Chunk *chunkData = chunks.data();
+        bool isDense = preamble.vertexCount >= 0;
+
+        runTasks(chunks.size(), [chunkData, format, &preamble, isDense, progress](int index) {
+            Chunk &chunk = chunkData[index];
+            parseChunk(chunk, format, preamble, progress);
+            if (!isDense && chunk.error.isEmpty()) {
+                chunk.ids = chunk.sources;
+                chunk.ids.append(chunk.targets);
+                std::sort(chunk.ids.begin(), chunk.ids.end());
+                chunk.ids.erase(std::unique(chunk.ids.begin(), chunk.ids.end()), chunk.ids.end());
+            }
+        });
+
+        if (AlgorithmProgress::checkpoint(progress, 60, 100)) {
+            isValid = fail(0, "Cancelled");
+        }
+
+        int line = preamble.lineCount;
+        qint64 entryCount = 0;
+        qint64 edgeCount = 0;
+        for (int index = 0; index < chunks.size() && isValid; ++index) {
+            const Chunk &chunk = chunks.at(index);
+            if (!chunk.error.isEmpty()) {
+                isValid = fail(line + chunk.lineCount, chunk.error);
+            }
+            line += chunk.lineCount;
+            entryCount += chunk.entryCount;
+            edgeCount += chunk.sources.size();
+        }
+        if (preamble.mirror != Mirror::None) {
+            edgeCount *= 2;
+        }
+
+        if (isValid && preamble.entryCount >= 0 && entryCount != preamble.entryCount) {
+            isValid = fail(0, QString("Expected %1 entries, found %2").arg(preamble.entryCount).arg(entryCount));
+        } else if (isValid && edgeCount > MAX_COUNT) {
+            isValid = fail(0, "Too many edges");
+        }
+
+        QVector<int> vertexIds;
+        if (isValid && isDense) {
+            vertexIds.resize(preamble.vertexCount);
+            for (int vertex = 0; vertex < preamble.vertexCount; ++vertex) {
+                vertexIds[vertex] = vertex + 1;
+            }
+        } else if (isValid) {
+            QVector<qint64> ids = mergeIds(chunks);
+
+            if (ids.size() > MAX_COUNT) {
+                isValid = fail(0, "Too many vertices");
+            } else {
+                bool keepsIds = ids.isEmpty() || (ids.first() >= 0 && ids.last() <= std::numeric_limits<int>::max());
+                vertexIds.resize(ids.size());
+                for (int vertex = 0; vertex < ids.size(); ++vertex) {
+                    vertexIds[vertex] = keepsIds ? static_cast<int>(ids.at(vertex)) : vertex + 1;
+                }
+
+                IdIndex index(ids);
+                runTasks(chunks.size(), [chunkData, &index](int chunkIndex) {
+                    Chunk &chunk = chunkData[chunkIndex];
+                    for (int edge = 0; edge < chunk.sources.size(); ++edge) {
+                        chunk.sources[edge] = index.indexOf(chunk.sources.at(edge));
+                        chunk.targets[edge] = index.indexOf(chunk.targets.at(edge));
+                    }
+                });
+            }
+        }
+
+        if (isValid && AlgorithmProgress::checkpoint(progress, 80, 100)) {
+            isValid = fail(0, "Cancelled");
+        }
+        if (isValid) {
+            buildSnapshot(chunks, vertexIds, preamble.mirror, snapshot);
+            AlgorithmProgress::checkpoint(progress, 100, 100);
+        }
+    }
+
+    return isValid;
+}
+
+// The preamble is read on the calling thread: the Matrix Market banner and
+// size line, the DIMACS problem line, or a Csv header row.
+bool EdgeListImporter::readPreamble(const char *data, const char *end, Format format, Preamble &preamble)
+{
+    const char *cursor = data;
+    bool isValid = true;
+
+    if (format == Format::MatrixMarket) {
+        LineReader bannerLine = takeLine(cursor, end);
+        QList<QByteArray> banner = QByteArray(bannerLine.cursor, bannerLine.end - bannerLine.cursor)
+            .simplified().toLower().split(' ');
+        preamble.lineCount = 1;
+
+        if (banner.size() != 5 || banner.at(0) != "%%matrixmarket" || banner.at(1) != "matrix") {
+            isValid = fail(1, "expected a %%MatrixMarket matrix banner");
+        } else if (banner.at(2) != "coordinate") {
+            isValid = fail(1, "only coordinate matrices can be imported");
+        } else if (banner.at(4) == "symmetric" || banner.at(4) == "hermitian") {
+            preamble.mirror = Mirror::Same;
+        } else if (banner.at(4) == "skew-symmetric") {
+            preamble.mirror = Mirror::Negated;
+        } else if (banner.at(4) != "general") {
+            isValid = fail(1, "unknown symmetry " + QString::fromLatin1(banner.at(4)));
+        }
+
+        if (isValid) {
+            preamble.isPattern = (banner.at(3) == "pattern");
+            LineReader sizeLine = takeContentLine(cursor, end, "%", preamble.lineCount);
+            qint64 rows = 0;
+            qint64 columns = 0;
+            isValid = sizeLine.read(rows) && sizeLine.read(columns) && sizeLine.read(preamble.entryCount)
+                && rows >= 0 && columns >= 0 && qMax(rows, columns) <= MAX_COUNT && preamble.entryCount >= 0;
+            if (!isValid) {
+                fail(preamble.lineCount, "expected the matrix size");
+            }
+            preamble.vertexCount = static_cast<int>(qMax(rows, columns));
+        }
+    } else if (format == Format::Dimacs) {
+        LineReader problemLine = takeContentLine(cursor, end, "c", preamble.lineCount);
+        qint64 vertexCount = 0;
+
+        isValid = problemLine.peek() == 'p';
+        problemLine.skipToken();
+        problemLine.skipToken();
+        isValid = isValid && problemLine.read(vertexCount) && problemLine.read(preamble.entryCount)
+            && vertexCount >= 0 && vertexCount <= MAX_COUNT && preamble.entryCount >= 0;
+        if (!isValid) {
+            fail(preamble.lineCount, "expected a \"p <problem> <vertices> <arcs>\" line");
+        }
+        preamble.vertexCount = static_cast<int>(vertexCount);
+    } else if (format == Format::Csv) {
+        const char *start = cursor;
+        int lineCount = 0;
+        qint64 id = 0;
+
+        if (takeContentLine(cursor, end, "#", lineCount).read(id)) {
+            cursor = start;
+        } else {
+            preamble.lineCount = lineCount;
+        }
+    }
+
+    preamble.body = cursor;
+    return isValid;
+}
+
+// Cuts the body into up to maxCount chunks of at least MIN_CHUNK_BYTES,
+// each ending at a line break.
+QVector<EdgeListImporter::Chunk> EdgeListImporter::splitChunks(const char *begin, const char *end, int maxCount)
+{
+    int count = static_cast<int>(qBound<qint64>(1, (end - begin) / MIN_CHUNK_BYTES, maxCount));
+    QVector<Chunk> chunks(count);
+    const char *chunkBegin = begin;
+
+    for (int index = 0; index < count; ++index) {
+        const char *chunkEnd = end;
+        if (index + 1 < count) {
+            const char *split = qMax(chunkBegin, begin + (end - begin) * (index + 1) / count);
+            const char *lineEnd = static_cast<const char*>(std::memchr(split, '\n', end - split));
+            chunkEnd = lineEnd ? lineEnd + 1 : end;
+        }
+        chunks[index].begin = chunkBegin;
+        chunks[index].end = chunkEnd;
+        chunkBegin = chunkEnd;
+    }
+
+    return chunks;
+}
+
+// Stops at the first line that does not parse, leaving lineCount on it.
+// Runs on a pool thread, which only polls the progress for cancellation.
+void EdgeListImporter::parseChunk(Chunk &chunk, Format format, const Preamble &preamble, AlgorithmProgress *progress)
+{
+    const char *cursor = chunk.begin;
+    bool isDimacs = (format == Format::Dimacs);
+    bool isDense = preamble.vertexCount >= 0;
+    bool isCancelled = false;
+
+    chunk.sources.reserve((chunk.end - chunk.begin) / 16);
+    chunk.targets.reserve((chunk.end - chunk.begin) / 16);
+    chunk.weights.reserve((chunk.end - chunk.begin) / 16);
+
+    while (cursor < chunk.end && chunk.error.isEmpty() && !isCancelled) {
+        LineReader line = takeLine(cursor, chunk.end);
+        char first = line.peek();
+        chunk.lineCount++;
+        if (progress && chunk.lineCount % AlgorithmProgress::CHECK_INTERVAL == 0) {
+            isCancelled = progress->isCancelled();
+        }
+
+        if (first != '\0' && first != '#' && first != '%' && !(isDimacs && (first == 'c' || first == 'n'))) {
+            qint64 from = 0;
+            qint64 to = 0;
+            double weight = 1.0;
+
+            if (isDimacs) {
+                line.cursor++;
+            }
+            bool isEdge = (!isDimacs || first == 'a') && line.read(from) && line.read(to);
+            if (isEdge && !preamble.isPattern && line.peek() != '\0') {
+                isEdge = line.read(weight);
+            }
+
+            if (!isEdge) {
+                chunk.error = isDimacs ? "expected an \"a <from> <to> <weight>\" line" : "expected an edge";
+            } else if (!(std::abs(weight) < std::numeric_limits<int>::max())) {
+                chunk.error = "weight out of range";
+            } else if (isDense && (from < 1 || from > preamble.vertexCount || to < 1 || to > preamble.vertexCount)) {
+                chunk.error = QString("vertex out of range 1..%1").arg(preamble.vertexCount);
+            } else {
+                chunk.entryCount++;
+                if (from != to) {
+                    chunk.sources.append(isDense ? from - 1 : from);
+                    chunk.targets.append(isDense ? to - 1 : to);
+                    chunk.weights.append(qRound(weight));
+                }
+            }
+        }
+    }
+}
+
+// Pairs of sorted lists are merged in parallel, halving the count each round.
+QVector<qint64> EdgeListImporter::mergeIds(QVector<Chunk> &chunks)
+{
+    QVector<QVector<qint64>> lists;
+    for (Chunk &chunk : chunks) {
+        lists.append(chunk.ids);
+        chunk.ids = QVector<qint64>();
+    }
+
+    while (lists.size() > 1) {
+        QVector<QVector<qint64>> merged((lists.size() + 1) / 2);
+        QVector<qint64> *mergedData = merged.data();
+
+        runTasks(merged.size(), [&lists, mergedData](int index) {
+            if (2 * index + 1 < lists.size()) {
+                const QVector<qint64> &left = lists.at(2 * index);
+                const QVector<qint64> &right = lists.at(2 * index + 1);
+                QVector<qint64> &result = mergedData[index];
+                result.resize(left.size() + right.size());
+                result.erase(std::set_union(left.constBegin(), left.constEnd(), right.constBegin(), right.constEnd(),
+                                            result.begin()),
+                             result.end());
+            } else {
+                mergedData[index] = lists.at(2 * index);
+            }
+        });
+        lists = merged;
+    }
+
+    return lists.isEmpty() ? QVector<qint64>() : lists.first();
+}
+
+// Counting sort on the source vertex, so each vertex keeps its out-edges in
+// file order. A mirrored edge takes the id right after its original.
+void EdgeListImporter::buildSnapshot(const QVector<Chunk> &chunks, const QVector<int> &vertexIds, Mirror mirror,
+                                     GraphSnapshot &snapshot)
+{
+    int vertexCount = vertexIds.size();
+    QVector<int> outOffsets(vertexCount + 1, 0);
+
+    for (const Chunk &chunk : chunks) {
+        for (int edge = 0; edge < chunk.sources.size(); ++edge) {
+            outOffsets[chunk.sources.at(edge) + 1]++;
+            if (mirror != Mirror::None) {
+                outOffsets[chunk.targets.at(edge) + 1]++;
+            }
+        }
+    }
+    for (int vertex = 0; vertex < vertexCount; ++vertex) {
+        outOffsets[vertex + 1] += outOffsets[vertex];
+    }
+
+    int edgeCount = outOffsets[vertexCount];
+    QVector<int> targets(edgeCount);
+    QVector<int> weights(edgeCount);
+    QVector<int> edgeIds(edgeCount);
+    QVector<int> cursors = outOffsets;
+    int nextId = 1;
+
+    for (const Chunk &chunk : chunks) {
+        for (int edge = 0; edge < chunk.sources.size(); ++edge) {
+            int from = static_cast<int>(chunk.sources.at(edge));
+            int to = static_cast<int>(chunk.targets.at(edge));
+            int weight = chunk.weights.at(edge);
+
+            int slot = cursors[from]++;
+            targets[slot] = to;
+            weights[slot] = weight;
+            edgeIds[slot] = nextId++;
+
+            if (mirror != Mirror::None) {
+                slot = cursors[to]++;
+                targets[slot] = from;
+                weights[slot] = (mirror == Mirror::Negated) ? -weight : weight;
+                edgeIds[slot] = nextId++;
+            }
+        }
+    }
+
+    int columns = qMax(1, qCeil(qSqrt(vertexCount)));
+    QVector<QPoint> positions(vertexCount);
+    for (int vertex = 0; vertex < vertexCount; ++vertex) {
+        positions[vertex] = QPoint((vertex % columns) * LAYOUT_SPACING, (vertex / columns) * LAYOUT_SPACING);
+    }
+
+    snapshot = GraphSnapshot(vertexIds, positions, outOffsets, targets, weights, edgeIds);
+}
+
+// Runs task(0..count-1) on the pool, or inline when only one would run.
+void EdgeListImporter::runTasks(int count, const std::function<void(int)> &task)
+{
+    if (count == 1 || m_pool.maxThreadCount() == 1) {
+        for (int index = 0; index < count; ++index) {
+            task(index);
+        }
+    } else {
+        for (int index = 0; index < count; ++index) {
+            m_pool.start([&task, index]() { task(index); });
+        }
+        m_pool.waitForDone();
+    }
+}
+
+bool EdgeListImporter::fail(int line, const QString &message)
+{
+    m_errorString = (line > 0) ? QString("Line %1: %2").arg(line).arg(message) : message;
+    return false;
+}
@@ -0,0 +1,68 @@
+#ifndef EDGELISTIMPORTER_H
+#define EDGELISTIMPORTER_H
+
+#include "GraphSnapshot.h"
+#include "AlgorithmProgress.h"
+#include <QString>
+#include <QThreadPool>
+#include <functional>
+
+// Builds a GraphSnapshot straight from a text edge list, without going
+// through Graph:
+//
+//   Snap          "from to [weight]" per line, '#' and '%' comments
+//   MatrixMarket  coordinate matrices; entry (i, j) is an edge i -> j, pattern
+//                 entries weigh 1, symmetric and hermitian matrices add j -> i,
+//                 skew-symmetric ones add it with the weight negated
+//   Dimacs        "p <problem> n m" header, "a u v w" arcs, 'c' comments
+//   Csv           "from,to[,weight]", optionally under a header row
+//
+// The file is mapped and cut at line breaks into chunks that a private
+// thread pool parses in parallel. Matrix Market and DIMACS number vertices
+// 1..n and keep those ids. Snap and Csv ids are arbitrary 64-bit integers:
+// the distinct ids are sorted and become the vertices in that order, keeping
+// their ids when all of them fit in 0..INT_MAX and numbered 1..n otherwise.
+// Real weights are rounded. Self-loops are dropped, as Graph refuses them;
+// edges get ids 1..m in file order. Vertices are laid out on a grid.
+//
+// A read can run on a worker thread: progress is reported between stages,
+// and a cancelled read stops soon after, returning false.
+class EdgeListImporter
+{
+public:
+    enum class Format { Snap, MatrixMarket, Dimacs, Csv };
+
+    // A threadCount of 0 uses QThread::idealThreadCount().
+    explicit EdgeListImporter(int threadCount = 0);
+
+    // Picks the format from the extension: .mtx, .gr/.dimacs/.max, .csv,
+    // and .txt/.edges/.el/.tsv/.snap for Snap. Returns false for others.
+    static bool formatFor(const QString &filename, Format &format);
+
+    bool read(const QString &filename, Format format, GraphSnapshot &snapshot,
+              AlgorithmProgress *progress = nullptr);
+    // Why the last read failed, with the line number where there is one.
+    QString errorString() const { return m_errorString; }
+
+private:
+    enum class Mirror { None, Same, Negated };
+    struct Preamble;
+    struct Chunk;
+
+    bool decode(const char *data, const char *end, Format format, GraphSnapshot &snapshot,
+                AlgorithmProgress *progress);
+    bool readPreamble(const char *data, const char *end, Format format, Preamble &preamble);
+    QVector<qint64> mergeIds(QVector<Chunk> &chunks);
+    void runTasks(int count, const std::function<void(int)> &task);
+    bool fail(int line, const QString &message);
+
+    static QVector<Chunk> splitChunks(const char *begin, const char *end, int maxCount);
+    static void parseChunk(Chunk &chunk, Format format, const Preamble &preamble, AlgorithmProgress *progress);
+    static void buildSnapshot(const QVector<Chunk> &chunks, const QVector<int> &vertexIds, Mirror mirror,
+                              GraphSnapshot &snapshot);
+
+    QThreadPool m_pool;
+    QString m_errorString;
+};
+
+#endif
@@ -0,0 +1,92 @@
+#include "EulerianTrail.h"
+
+EulerianTrail::EulerianTrail(const GraphSnapshot &snapshot)
+    : m_snapshot(snapshot)
+{
+}
+
+EulerianTrail::Result EulerianTrail::find(Kind kind) const
+{
+    Result result;
+    bool isBalanced = true;
+    int start = startVertex(kind, isBalanced);
+
+    if (!isBalanced) {
+        result.status = Status::Unbalanced;
+    } else if (start >= 0) {
+        result.start = start;
+        result.edges = walk(start);
+        result.status = (result.edges.size() == m_snapshot.edgeCount()) ? Status::Found : Status::Disconnected;
+    }
+
+    return result;
+}
+
+// A cycle needs in-degree == out-degree everywhere and may start at any
+// vertex with edges. A path additionally allows one vertex with a surplus
+// out-edge, where it must start, and one with a surplus in-edge.
+int EulerianTrail::startVertex(Kind kind, bool &isBalanced) const
+{
+    int firstWithEdges = -1;
+    int surplusVertex = -1;
+    int surplusCount = 0;
+    int deficitCount = 0;
+    bool allowsSurplus = (kind == Kind::Path);
+
+    isBalanced = true;
+    for (int vertex = 0; vertex < m_snapshot.vertexCount() && isBalanced; ++vertex) {
+        int difference = m_snapshot.outDegree(vertex) - m_snapshot.inDegree(vertex);
+
+        if (difference == 1 && allowsSurplus) {
+            surplusVertex = vertex;
+            surplusCount++;
+        } else if (difference == -1 && allowsSurplus) {
+            deficitCount++;
+        } else if (difference != 0) {
+            isBalanced = false;
+        } else if (firstWithEdges < 0 && m_snapshot.outDegree(vertex) > 0) {
+            firstWithEdges = vertex;
+        }
+    }
+
+    isBalanced = isBalanced && surplusCount == deficitCount && surplusCount <= 1;
+    return (surplusCount == 1) ? surplusVertex : firstWithEdges;
+}
+
+// Follows unused edges until stuck, then backs out along the edge stack.
+// Edges leave the stack in reverse trail order, so they are written from
+// the end of the array. A walk that strands edges in another component
+// leaves the front of the array unfilled; that part is dropped.
+QVector<int> EulerianTrail::walk(int start) const
+{
+    int vertexCount = m_snapshot.vertexCount();
+    int edgeCount = m_snapshot.edgeCount();
+
+    QVector<int> cursors(vertexCount);
+    for (int vertex = 0; vertex < vertexCount; ++vertex) {
+        cursors[vertex] = m_snapshot.outBegin(vertex);
+    }
+
+    QVector<int> trail(edgeCount);
+    int position = edgeCount;
+    QVector<int> stack;
+    int current = start;
+    bool isDone = false;
+
+    while (!isDone) {
+        if (cursors[current] < m_snapshot.outEnd(current)) {
+            int edge = cursors[current]++;
+            stack.append(edge);
+            current = m_snapshot.target(edge);
+        } else if (!stack.isEmpty()) {
+            int edge = stack.takeLast();
+            trail[--position] = edge;
+            current = m_snapshot.source(edge);
+        } else {
+            isDone = true;
+        }
+    }
+
+    trail.remove(0, position);
+    return trail;
+}
@@ -0,0 +1,39 @@
+#ifndef EULERIANTRAIL_H
+#define EULERIANTRAIL_H
+
+#include "GraphSnapshot.h"
+#include <QVector>
+
+// Hierholzer's algorithm over a GraphSnapshot. Every vertex keeps a cursor
+// into its own out-edge slots, so edges are consumed by advancing the cursor
+// rather than copied or erased, and the trail is written back to front into
+// one array of edgeCount slots. Time and memory are linear in the edges.
+//
+// Isolated vertices are ignored. The graph counts as connected when the walk
+// from the start vertex uses every edge.
+class EulerianTrail
+{
+public:
+    enum class Kind { Cycle, Path };
+    enum class Status { Found, NoEdges, Unbalanced, Disconnected };
+
+    // edges holds snapshot edge slots in walking order; the trail starts at
+    // start and edge i ends where edge i + 1 begins.
+    struct Result {
+        Status status = Status::NoEdges;
+        int start = -1;
+        QVector<int> edges;
+    };
+
+    explicit EulerianTrail(const GraphSnapshot &snapshot);
+
+    Result find(Kind kind) const;
+
+private:
+    int startVertex(Kind kind, bool &isBalanced) const;
+    QVector<int> walk(int start) const;
+
+    const GraphSnapshot &m_snapshot;
+};
+
+#endif
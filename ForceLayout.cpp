@@ -0,0 +1,335 @@
+#include "ForceLayout.h"
+#include <QThread>
+#include <QVarLengthArray>
+#include <QtMath>
+
+namespace {
+const double MIN_DISTANCE_SQUARED = 1e-4;
+const double GOLDEN_ANGLE = 2.39996322972865332;
+}
+
+ForceLayout::ForceLayout(const GraphSnapshot &snapshot, const Settings &settings)
+    : m_snapshot(snapshot)
+    , m_settings(settings)
+    , m_initialTemperature(0.0)
+    , m_iteration(0)
+{
+    int threadCount = settings.threadCount > 0 ? settings.threadCount : QThread::idealThreadCount();
+    m_pool.setMaxThreadCount(qMax(1, threadCount));
+
+    initializePositions();
+    m_displacements.resize(m_positions.size());
+
+    double edgeLength = m_settings.edgeLength;
+    m_initialTemperature = qMax(edgeLength, 0.1 * edgeLength * qSqrt(m_positions.size()));
+}
+
+// Keeps the current drawing unless it is a pile, i.e. has far less room per
+// vertex than the ideal edge length asks for; a pile is spread on a
+// sunflower spiral around its centre first.
+void ForceLayout::initializePositions()
+{
+    int vertexCount = m_snapshot.vertexCount();
+    m_positions.resize(vertexCount);
+
+    double minX = 0.0;
+    double minY = 0.0;
+    double maxX = 0.0;
+    double maxY = 0.0;
+
+    for (int vertex = 0; vertex < vertexCount; ++vertex) {
+        QPointF position = m_snapshot.position(vertex);
+        m_positions[vertex] = position;
+        minX = vertex == 0 ? position.x() : qMin(minX, position.x());
+        minY = vertex == 0 ? position.y() : qMin(minY, position.y());
+        maxX = vertex == 0 ? position.x() : qMax(maxX, position.x());
+        maxY = vertex == 0 ? position.y() : qMax(maxY, position.y());
+    }
+
+    m_center = QPointF((minX + maxX) / 2, (minY + maxY) / 2);
+
+    double edgeLength = m_settings.edgeLength;
+    double area = (maxX - minX + 1) * (maxY - minY + 1);
+    if (vertexCount > 1 && area / vertexCount < edgeLength * edgeLength / 16) {
+        for (int vertex = 0; vertex < vertexCount; ++vertex) {
+            double radius = 0.5 * edgeLength * qSqrt(vertex);
+            double angle = vertex * GOLDEN_ANGLE;
+            m_positions[vertex] = m_center + QPointF(radius * qCos(angle), radius * qSin(angle));
+        }
+    }
+}
+
+bool ForceLayout::step()
+{
+    bool isStepped = false;
+
+    if (m_iteration < m_settings.iterations) {
+        buildQuadTree();
+
+        double progress = static_cast<double>(m_iteration) / m_settings.iterations;
+        double temperature = qMax(m_initialTemperature * (1.0 - progress), 0.01 * m_settings.edgeLength);
+
+        forEachChunk([this](int begin, int end) {
+            for (int vertex = begin; vertex < end; ++vertex) {
+                QPointF gravity = (m_center - m_positions[vertex]) * m_settings.gravity;
+                m_displacements[vertex] = repulsion(vertex) + attraction(vertex) + gravity;
+            }
+        });
+
+        forEachChunk([this, temperature](int begin, int end) {
+            for (int vertex = begin; vertex < end; ++vertex) {
+                QPointF displacement = m_displacements[vertex];
+                double length = qSqrt(QPointF::dotProduct(displacement, displacement));
+                if (length > 0) {
+                    m_positions[vertex] += displacement * (qMin(length, temperature) / length);
+                }
+            }
+        });
+
+        m_iteration++;
+        isStepped = true;
+    }
+
+    return isStepped;
+}
+
+bool ForceLayout::run(AlgorithmProgress *progress, const std::function<void()> &onIteration)
+{
+    bool isCancelled = false;
+
+    while (!isCancelled && step()) {
+        if (onIteration) {
+            onIteration();
+        }
+        isCancelled = AlgorithmProgress::checkpoint(progress, m_iteration, m_settings.iterations);
+    }
+
+    return !isCancelled;
+}
+
+QVector<QPoint> ForceLayout::roundedPositions() const
+{
+    QVector<QPoint> result(m_positions.size());
+
+    for (int vertex = 0; vertex < m_positions.size(); ++vertex) {
+        result[vertex] = m_positions[vertex].toPoint();
+    }
+
+    return result;
+}
+
+void ForceLayout::buildQuadTree()
+{
+    m_nodes.clear();
+
+    if (!m_positions.isEmpty()) {
+        double minX = m_positions[0].x();
+        double minY = m_positions[0].y();
+        double maxX = minX;
+        double maxY = minY;
+
+        for (const QPointF &position : m_positions) {
+            minX = qMin(minX, position.x());
+            minY = qMin(minY, position.y());
+            maxX = qMax(maxX, position.x());
+            maxY = qMax(maxY, position.y());
+        }
+
+        QuadNode root;
+        root.centerX = (minX + maxX) / 2;
+        root.centerY = (minY + maxY) / 2;
+        root.halfSize = qMax(maxX - minX, maxY - minY) / 2 + 1.0;
+        root.massX = 0.0;
+        root.massY = 0.0;
+        root.mass = 0;
+        root.firstChild = -1;
+        root.body = -1;
+
+        m_nodes.reserve(4 * m_positions.size());
+        m_nodes.append(root);
+        m_bodyLeaves.resize(m_positions.size());
+
+        for (int body = 0; body < m_positions.size(); ++body) {
+            insertBody(body);
+        }
+
+        for (QuadNode &node : m_nodes) {
+            if (node.mass > 0) {
+                node.massX /= node.mass;
+                node.massY /= node.mass;
+            }
+        }
+    }
+}
+
+// Walks down from the root, adding the body to every node's mass, and
+// splits the leaf it lands in when that leaf already holds a body.
+void ForceLayout::insertBody(int body)
+{
+    QPointF position = m_positions[body];
+    int node = 0;
+    int depth = 0;
+    bool isPlaced = false;
+
+    while (!isPlaced) {
+        m_nodes[node].massX += position.x();
+        m_nodes[node].massY += position.y();
+        m_nodes[node].mass++;
+
+        if (m_nodes[node].firstChild >= 0) {
+            node = m_nodes[node].firstChild + quadrant(node, position);
+            depth++;
+        } else if (m_nodes[node].mass == 1) {
+            m_nodes[node].body = body;
+            m_bodyLeaves[body] = node;
+            isPlaced = true;
+        } else if (depth >= MAX_DEPTH) {
+            m_nodes[node].body = -1;
+            m_bodyLeaves[body] = node;
+            isPlaced = true;
+        } else {
+            subdivide(node);
+            node = m_nodes[node].firstChild + quadrant(node, position);
+            depth++;
+        }
+    }
+}
+
+// Moves the single body of a leaf into one of four new children.
+void ForceLayout::subdivide(int node)
+{
+    int firstChild = m_nodes.size();
+    double quarter = m_nodes[node].halfSize / 2;
+
+    for (int i = 0; i < 4; ++i) {
+        QuadNode child;
+        child.centerX = m_nodes[node].centerX + ((i & 1) ? quarter : -quarter);
+        child.centerY = m_nodes[node].centerY + ((i & 2) ? quarter : -quarter);
+        child.halfSize = quarter;
+        child.massX = 0.0;
+        child.massY = 0.0;
+        child.mass = 0;
+        child.firstChild = -1;
+        child.body = -1;
+        m_nodes.append(child);
+    }
+
+    int existing = m_nodes[node].body;
+    QuadNode &child = m_nodes[firstChild + quadrant(node, m_positions[existing])];
+    child.massX = m_positions[existing].x();
+    child.massY = m_positions[existing].y();
+    child.mass = 1;
+    child.body = existing;
+    m_bodyLeaves[existing] = firstChild + quadrant(node, m_positions[existing]);
+
+    m_nodes[node].firstChild = firstChild;
+    m_nodes[node].body = -1;
+}
+
+int ForceLayout::quadrant(int node, const QPointF &point) const
+{
+    int index = 0;
+    if (point.x() >= m_nodes[node].centerX) {
+        index |= 1;
+    }
+    if (point.y() >= m_nodes[node].centerY) {
+        index |= 2;
+    }
+    return index;
+}
+
+// k^2 / d away from every other vertex; a node far enough away relative to
+// its size (theta) stands in for all bodies under it. In a merged leaf the
+// vertex's own share is taken out of the mass and its centre first.
+QPointF ForceLayout::repulsion(int vertex) const
+{
+    QPointF position = m_positions[vertex];
+    double edgeLengthSquared = m_settings.edgeLength * m_settings.edgeLength;
+    double thetaSquared = m_settings.theta * m_settings.theta;
+    double forceX = 0.0;
+    double forceY = 0.0;
+
+    QVarLengthArray<int, 128> stack;
+    stack.append(0);
+
+    while (!stack.isEmpty()) {
+        int node = stack.last();
+        stack.removeLast();
+        const QuadNode &current = m_nodes[node];
+
+        if (current.body != vertex) {
+            double massX = current.massX;
+            double massY = current.massY;
+            int mass = current.mass;
+            if (node == m_bodyLeaves[vertex]) {
+                mass--;
+                massX = (current.massX * current.mass - position.x()) / mass;
+                massY = (current.massY * current.mass - position.y()) / mass;
+            }
+
+            double deltaX = position.x() - massX;
+            double deltaY = position.y() - massY;
+            double distanceSquared = deltaX * deltaX + deltaY * deltaY;
+            double size = 2 * current.halfSize;
+
+            if (current.firstChild < 0 || size * size < thetaSquared * distanceSquared) {
+                if (distanceSquared < MIN_DISTANCE_SQUARED) {
+                    double angle = vertex * GOLDEN_ANGLE;
+                    deltaX = 0.01 * qCos(angle);
+                    deltaY = 0.01 * qSin(angle);
+                    distanceSquared = MIN_DISTANCE_SQUARED;
+                }
+                double scale = edgeLengthSquared * mass / distanceSquared;
+                forceX += deltaX * scale;
+                forceY += deltaY * scale;
+            } else {
+                for (int child = current.firstChild; child < current.firstChild + 4; ++child) {
+                    if (m_nodes[child].mass > 0) {
+                        stack.append(child);
+                    }
+                }
+            }
+        }
+    }
+
+    return QPointF(forceX, forceY);
+}
+
+// d^2 / k towards every neighbour, over out- and in-edges alike.
+QPointF ForceLayout::attraction(int vertex) const
+{
+    QPointF position = m_positions[vertex];
+    QPointF force(0.0, 0.0);
+
+    for (int edge = m_snapshot.outBegin(vertex); edge < m_snapshot.outEnd(vertex); ++edge) {
+        QPointF delta = m_positions[m_snapshot.target(edge)] - position;
+        force += delta * (qSqrt(QPointF::dotProduct(delta, delta)) / m_settings.edgeLength);
+    }
+
+    for (int slot = m_snapshot.inBegin(vertex); slot < m_snapshot.inEnd(vertex); ++slot) {
+        QPointF delta = m_positions[m_snapshot.inSource(slot)] - position;
+        force += delta * (qSqrt(QPointF::dotProduct(delta, delta)) / m_settings.edgeLength);
+    }
+
+    return force;
+}
+
+// Splits 0..n-1 into a few chunks per thread and waits for all of them.
+// Small graphs are handled on the calling thread.
+void ForceLayout::forEachChunk(const std::function<void(int, int)> &work)
+{
+    int vertexCount = m_positions.size();
+
+    if (vertexCount < MIN_PARALLEL_VERTICES || m_pool.maxThreadCount() == 1) {
+        work(0, vertexCount);
+    } else {
+        int chunkCount = 4 * m_pool.maxThreadCount();
+        int chunkSize = (vertexCount + chunkCount - 1) / chunkCount;
+
+        for (int begin = 0; begin < vertexCount; begin += chunkSize) {
+            int end = qMin(begin + chunkSize, vertexCount);
+            m_pool.start([&work, begin, end]() { work(begin, end); });
+        }
+        m_pool.waitForDone();
+    }
+}
@@ -0,0 +1,83 @@
+#ifndef FORCELAYOUT_H
+#define FORCELAYOUT_H
+
+#include "GraphSnapshot.h"
+#include "AlgorithmProgress.h"
+#include <QVector>
+#include <QPointF>
+#include <QThreadPool>
+#include <functional>
+
+// Fruchterman-Reingold layout over a GraphSnapshot. Repulsion between all
+// vertex pairs is approximated with a Barnes-Hut quadtree, so an iteration
+// costs O(n log n + m); forces are evaluated in chunks on a private thread
+// pool. Edges pull both endpoints together regardless of direction, and a
+// weak gravity keeps disconnected parts from drifting apart.
+class ForceLayout
+{
+public:
+    // A threadCount of 0 uses QThread::idealThreadCount().
+    struct Settings {
+        Settings() : iterations(200), edgeLength(80.0), theta(0.9), gravity(0.05), threadCount(0) {}
+
+        int iterations;
+        double edgeLength;
+        double theta;
+        double gravity;
+        int threadCount;
+    };
+
+    explicit ForceLayout(const GraphSnapshot &snapshot, const Settings &settings = Settings());
+
+    // Moves every vertex once and cools down. Returns false when all
+    // iterations have been done.
+    bool step();
+    // Runs the remaining iterations, calling onIteration after each one.
+    // Returns false when cancelled through progress.
+    bool run(AlgorithmProgress *progress = nullptr, const std::function<void()> &onIteration = nullptr);
+
+    int iteration() const { return m_iteration; }
+    const QVector<QPointF>& positions() const { return m_positions; }
+    QVector<QPoint> roundedPositions() const;
+
+private:
+    // Leaves hold one body, except at MAX_DEPTH where coincident bodies are
+    // merged and body is -1. massX/massY sum the positions under the node
+    // while the tree is built and hold their centre afterwards.
+    struct QuadNode {
+        double centerX;
+        double centerY;
+        double halfSize;
+        double massX;
+        double massY;
+        int mass;
+        int firstChild;
+        int body;
+    };
+
+    static const int MAX_DEPTH = 48;
+    static const int MIN_PARALLEL_VERTICES = 2048;
+
+    void initializePositions();
+    void buildQuadTree();
+    void insertBody(int body);
+    void subdivide(int node);
+    int quadrant(int node, const QPointF &point) const;
+    QPointF repulsion(int vertex) const;
+    QPointF attraction(int vertex) const;
+    void forEachChunk(const std::function<void(int, int)> &work);
+
+    const GraphSnapshot &m_snapshot;
+    Settings m_settings;
+    QVector<QPointF> m_positions;
+    QVector<QPointF> m_displacements;
+    QVector<QuadNode> m_nodes;
+    // The leaf each body ended up in.
+    QVector<int> m_bodyLeaves;
+    QPointF m_center;
+    double m_initialTemperature;
+    int m_iteration;
+    QThreadPool m_pool;
+};
+
+#endif
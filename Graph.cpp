@@ -3,9 +3,13 @@
 #include <QFile>
 #include <QDataStream>
 #include <QIODevice>
-#include <QMap>
+#include <QSet>
 Graph::Graph()
     : m_vertexCounter(1)
+    , m_edgeCounter(1)
+    , m_revision(0)
+    , m_structureRevision(0)
+    , m_isEdgeIndexed(true)
 {
 }
 
@@ -14,36 +18,190 @@ Graph::~Graph(){
 }
 
 Vertex* Graph::addVertex(const QPoint &position){
-    Vertex *newVertex = new Vertex(m_vertexCounter++, position);
+    Vertex *newVertex = m_vertexPool.create(m_vertexCounter++, position);
     m_vertices.append(newVertex);
+    m_vertexIndex.insert(newVertex->id(), newVertex);
+    m_spatialIndex.insertVertex(newVertex);
+    if (m_strongComponents) {
+        m_strongComponents->addVertex(newVertex);
+    }
+    changeStructure();
     return newVertex;
 }
 
 void Graph::removeVertex(Vertex *vertex){
-    if (m_vertices.contains(vertex)) {
-        QVector<Edge*> edgesToRemove;
-        for (Edge *edge : m_edges) {
-            if (edge->from() == vertex || edge->to() == vertex) {
-                edgesToRemove.append(edge);
-            }
+    if (vertex && m_vertexIndex.value(vertex->id()) == vertex) {
+        if (m_strongComponents) {
+            m_strongComponents->removeVertex(vertex);
         }
+
+        QVector<Edge*> edgesToRemove = incidentEdges(vertex);
+        QSet<Edge*> removedEdges(edgesToRemove.begin(), edgesToRemove.end());
+
         for (Edge *edge : edgesToRemove) {
-            removeEdge(edge);
+            m_edgeIndex.remove(EdgeKey(edge->from(), edge->to()));
+            m_edgeById.remove(edge->id());
+            unindexEdge(edge);
+        }
+        vertex->releaseEdges(m_edgeArena);
+        m_edges.removeIf([&removedEdges](Edge *edge) { return removedEdges.contains(edge); });
+        for (Edge *edge : edgesToRemove) {
+            m_edgePool.destroy(edge);
         }
 
+        m_spatialIndex.removeVertex(vertex);
+        m_vertexIndex.remove(vertex->id());
         m_vertices.removeAll(vertex);
-        delete vertex;
+        m_vertexPool.destroy(vertex);
+        changeStructure();
     }
 }
 
-void Graph::addEdge(Vertex *from, Vertex *to){
-    if (from && to && from != to && !getEdge(from, to)) {
-        from->addOutNeighbor(to);
-        Edge *newEdge = new Edge(from, to, 1);
-        m_edges.append(newEdge);
+void Graph::moveVertex(Vertex *vertex, const QPoint &position){
+    if (vertex && m_vertexIndex.value(vertex->id()) == vertex) {
+        QVector<Edge*> edges = incidentEdges(vertex);
+
+        for (Edge *edge : edges) {
+            unindexEdge(edge);
+        }
+        m_spatialIndex.removeVertex(vertex);
+
+        vertex->setPosition(position);
+
+        m_spatialIndex.insertVertex(vertex);
+        for (Edge *edge : edges) {
+            indexEdge(edge);
+        }
+        m_revision++;
     }
 }
 
+// Moves many vertices at once, e.g. for a layout pass. Unknown ids and
+// vertices that stay put are skipped. Only the moved vertices and their
+// edges are re-indexed unless rebuilding the spatial index is cheaper:
+// taking an edge out visits about entries / edges cells holding entries /
+// cells edges each, against one insert per entry for a rebuild.
+void Graph::moveVertices(const QVector<int> &vertexIds, const QVector<QPoint> &positions){
+    QVector<Vertex*> movedVertices;
+    QVector<QPoint> newPositions;
+    QVector<Edge*> movedEdges;
+    QSet<Edge*> seenEdges;
+
+    for (int i = 0; i < vertexIds.size() && i < positions.size(); ++i) {
+        Vertex *vertex = m_vertexIndex.value(vertexIds[i], nullptr);
+        if (vertex && vertex->position() != positions[i]) {
+            movedVertices.append(vertex);
+            newPositions.append(positions[i]);
+            if (m_isEdgeIndexed) {
+                for (Edge *edge : incidentEdges(vertex)) {
+                    if (!seenEdges.contains(edge)) {
+                        seenEdges.insert(edge);
+                        movedEdges.append(edge);
+                    }
+                }
+            }
+        }
+    }
+
+    if (!movedVertices.isEmpty()) {
+        bool isRebuilt = movedEdges.size() * m_spatialIndex.edgeEntryCount()
+                         >= static_cast<qint64>(m_edges.size()) * m_spatialIndex.edgeCellCount()
+                         && movedEdges.size() > 0;
+
+        if (isRebuilt) {
+            m_spatialIndex.clear();
+        } else {
+            for (Edge *edge : movedEdges) {
+                m_spatialIndex.removeEdge(edge);
+            }
+            for (Vertex *vertex : movedVertices) {
+                m_spatialIndex.removeVertex(vertex);
+            }
+        }
+
+        for (int i = 0; i < movedVertices.size(); ++i) {
+            movedVertices[i]->setPosition(newPositions[i]);
+        }
+
+        if (isRebuilt) {
+            for (Vertex *vertex : m_vertices) {
+                m_spatialIndex.insertVertex(vertex);
+            }
+            for (Edge *edge : m_edges) {
+                m_spatialIndex.insertEdge(edge);
+            }
+        } else {
+            for (Vertex *vertex : movedVertices) {
+                m_spatialIndex.insertVertex(vertex);
+            }
+            for (Edge *edge : movedEdges) {
+                m_spatialIndex.insertEdge(edge);
+            }
+        }
+        m_revision++;
+    }
+}
+
+void Graph::indexEdges(){
+    if (!m_isEdgeIndexed) {
+        for (Edge *edge : m_edges) {
+            m_spatialIndex.insertEdge(edge);
+        }
+        m_isEdgeIndexed = true;
+    }
+}
+
+void Graph::indexEdge(Edge *edge){
+    if (m_isEdgeIndexed) {
+        m_spatialIndex.insertEdge(edge);
+    }
+}
+
+void Graph::unindexEdge(Edge *edge){
+    if (m_isEdgeIndexed) {
+        m_spatialIndex.removeEdge(edge);
+    }
+}
+
+QVector<Edge*> Graph::incidentEdges(Vertex *vertex) const{
+    QVector<Edge*> edges;
+    edges.reserve(vertex->outDegree() + vertex->inDegree());
+
+    for (Edge *edge : vertex->outEdges()) {
+        edges.append(edge);
+    }
+    for (Edge *edge : vertex->inEdges()) {
+        edges.append(edge);
+    }
+
+    return edges;
+}
+
+Edge* Graph::addEdge(Vertex *from, Vertex *to, int weight){
+    Edge *newEdge = nullptr;
+
+    if (from && to && from != to) {
+        newEdge = createEdge(m_edgeCounter++, from, to, weight);
+        if (m_strongComponents) {
+            m_strongComponents->addEdge(from, to);
+        }
+        changeStructure();
+    }
+
+    return newEdge;
+}
+
+// The newest edge between a pair becomes the one the pair index returns.
+Edge* Graph::createEdge(int id, Vertex *from, Vertex *to, int weight){
+    Edge *edge = m_edgePool.create(id, from, to, weight);
+    from->addOutEdge(edge, m_edgeArena);
+    m_edges.append(edge);
+    m_edgeIndex.insert(EdgeKey(from, to), edge);
+    m_edgeById.insert(id, edge);
+    indexEdge(edge);
+    return edge;
+}
+
 void Graph::removeEdge(Vertex *from, Vertex *to){
     Edge *edge = getEdge(from, to);
     if (edge) {
@@ -52,12 +210,53 @@ void Graph::removeEdge(Vertex *from, Vertex *to){
 }
 
 void Graph::removeEdge(Edge *edge){
-    if (m_edges.contains(edge)) {
-        if (edge->from()) {
-            edge->from()->removeOutNeighbor(edge->to());
+    if (edge && m_edgeById.value(edge->id()) == edge) {
+        Vertex *from = edge->from();
+        Vertex *to = edge->to();
+
+        detachEdge(edge);
+        m_edges.removeOne(edge);
+        m_edgePool.destroy(edge);
+        if (m_strongComponents) {
+            m_strongComponents->removeEdge(from, to);
+        }
+        changeStructure();
+    }
+}
+
+void Graph::setEdgeWeight(Edge *edge, int weight){
+    if (edge && edge->weight() != weight) {
+        edge->setWeight(weight);
+        changeStructure();
+    }
+}
+
+// When the pair index pointed at this edge, a remaining parallel edge takes
+// its place.
+void Graph::detachEdge(Edge *edge){
+    Vertex *from = edge->from();
+    Vertex *to = edge->to();
+
+    from->removeOutEdge(edge);
+    m_edgeById.remove(edge->id());
+    unindexEdge(edge);
+
+    EdgeKey key(from, to);
+    if (m_edgeIndex.value(key) == edge) {
+        Edge *replacement = nullptr;
+        const EdgeList &outEdges = from->outEdges();
+
+        for (int i = 0; i < outEdges.size() && !replacement; ++i) {
+            if (outEdges.at(i)->to() == to) {
+                replacement = outEdges.at(i);
+            }
+        }
+
+        if (replacement) {
+            m_edgeIndex.insert(key, replacement);
+        } else {
+            m_edgeIndex.remove(key);
         }
-        m_edges.removeAll(edge);
-        delete edge;
     }
 }
 
@@ -65,7 +264,7 @@ Edge* Graph::findEdgeAt(const QPoint &point, int radius) const {
     Edge* closestEdge = nullptr;
     double minDistance = radius;
 
-    for (Edge* edge : m_edges) {
+    for (Edge* edge : m_spatialIndex.edgesNear(point, radius)) {
         double distance = distanceToLineSegment(point, edge->from()->position(), edge->to()->position());
         if (distance < minDistance) {
             minDistance = distance;
@@ -93,86 +292,218 @@ double Graph::distanceToLineSegment(const QPoint &point, const QPoint &lineStart
 }
 
 Edge* Graph::getEdge(Vertex *from, Vertex *to) const {
-    for (Edge *edge : m_edges) {
-        if (edge->from() == from && edge->to() == to) {
-            return edge;
+    return m_edgeIndex.value(EdgeKey(from, to), nullptr);
+}
+
+Edge* Graph::getEdgeById(int id) const {
+    return m_edgeById.value(id, nullptr);
+}
+
+QVector<Edge*> Graph::edgesBetween(Vertex *from, Vertex *to) const {
+    QVector<Edge*> edges;
+
+    if (from && to && m_edgeIndex.contains(EdgeKey(from, to))) {
+        for (Edge *edge : from->outEdges()) {
+            if (edge->to() == to) {
+                edges.append(edge);
+            }
         }
     }
-    return nullptr;
+
+    return edges;
 }
 
 Vertex* Graph::findVertexAt(const QPoint &point, int radius) const
 {
-    for (Vertex *vertex : m_vertices) {
+    Vertex *closestVertex = nullptr;
+    int minDistanceSquared = radius * radius;
+
+    for (Vertex *vertex : m_spatialIndex.verticesNear(point, radius)) {
         QPoint delta = vertex->position() - point;
         int distanceSquared = delta.x() * delta.x() + delta.y() * delta.y();
 
-        if (distanceSquared <= radius * radius) {
-            return vertex;
+        if (distanceSquared <= minDistanceSquared) {
+            minDistanceSquared = distanceSquared;
+            closestVertex = vertex;
         }
     }
-    return nullptr;
+    return closestVertex;
 }
 
 Vertex* Graph::getVertexById(int id) const
 {
-    for (Vertex *vertex : m_vertices) {
-        if (vertex->id() == id) {
-            return vertex;
-        }
-    }
-    return nullptr;
+    return m_vertexIndex.value(id, nullptr);
+}
+
+QVector<Vertex*> Graph::verticesIn(const QRect &rect) const
+{
+    return m_spatialIndex.verticesIn(rect);
+}
+
+QVector<Edge*> Graph::edgesIn(const QRect &rect) const
+{
+    return m_spatialIndex.edgesIn(rect);
 }
 
 bool Graph::areConnected(Vertex *from, Vertex *to) const
 {
-    return from && to && from->hasOutNeighbor(to);
+    return from && to && m_edgeIndex.contains(EdgeKey(from, to));
+}
+
+GraphSnapshot Graph::snapshot() const
+{
+    return GraphSnapshot(*this);
 }
 
 void Graph::clear()
 {
-    qDeleteAll(m_edges);
     m_edges.clear();
-    qDeleteAll(m_vertices);
+    m_edgeIndex.clear();
+    m_edgeById.clear();
     m_vertices.clear();
+    m_vertexIndex.clear();
+    m_spatialIndex.clear();
+    m_isEdgeIndexed = true;
+
+    m_edgePool.clear();
+    m_vertexPool.clear();
+    m_edgeArena.clear();
 
     m_vertexCounter = 1;
+    m_edgeCounter = 1;
+    if (m_strongComponents) {
+        m_strongComponents->clear();
+    }
+    changeStructure();
 }
 
-bool Graph::saveToFile(const QString& filename) const
+// The hierarchy file is only a cache: failing to write it does not fail the
+// save, and a stale one is removed so that loading does not try it.
+bool Graph::saveToFile(const QString& filename, GraphFile::Encoding encoding) const
 {
-    QFile file(filename);
-    bool isFileOpened = false;
+    bool isSaveSuccessful = GraphFile::write(snapshot(), filename, encoding);
 
-    isFileOpened = file.open(QIODevice::WriteOnly);
+    if (isSaveSuccessful) {
+        QString hierarchyFilename = ContractionHierarchy::fileNameFor(filename);
+        if (!m_hierarchy || !m_hierarchy->write(hierarchyFilename)) {
+            QFile::remove(hierarchyFilename);
+        }
+    }
 
-    if (!isFileOpened) {
-        return false;
+    return isSaveSuccessful;
+}
+
+// Files without the .graph magic are read with the headerless QDataStream
+// layout used before the format was versioned.
+bool Graph::loadFromFile(const QString& filename)
+{
+    bool isLoadSuccessful = false;
+
+    if (GraphFile::isGraphFile(filename)) {
+        GraphSnapshot fileSnapshot;
+        isLoadSuccessful = GraphFile::read(filename, fileSnapshot);
+        if (isLoadSuccessful) {
+            loadSnapshot(fileSnapshot);
+            loadHierarchy(filename);
+        }
+    } else {
+        isLoadSuccessful = loadLegacyFile(filename);
     }
 
-    QDataStream out(&file);
-    out.setVersion(QDataStream::Qt_6_0);
+    return isLoadSuccessful;
+}
 
-    out << static_cast<quint32>(m_vertices.size());
+// A hierarchy saved for a different version of the graph is ignored.
+void Graph::loadHierarchy(const QString& filename)
+{
+    QString hierarchyFilename = ContractionHierarchy::fileNameFor(filename);
 
-    for (Vertex* vertex : m_vertices) {
-        out << static_cast<quint32>(vertex->id());
-        out << vertex->position();
+    if (QFile::exists(hierarchyFilename)) {
+        std::shared_ptr<ContractionHierarchy> hierarchy = std::make_shared<ContractionHierarchy>();
+        if (hierarchy->read(hierarchyFilename) && hierarchy->matches(snapshot())) {
+            m_hierarchy = hierarchy;
+        }
     }
+}
 
-    out << static_cast<quint32>(m_edges.size());
+void Graph::setHierarchy(const std::shared_ptr<const ContractionHierarchy> &hierarchy, quint64 structureRevision)
+{
+    if (structureRevision == m_structureRevision) {
+        m_hierarchy = hierarchy;
+    }
+}
 
-    for (Edge* edge : m_edges) {
-        out << static_cast<quint32>(edge->from()->id());
-        out << static_cast<quint32>(edge->to()->id());
-        out << static_cast<qint32>(edge->weight());
+// Turning tracking on costs one Tarjan pass over the graph.
+void Graph::setTracksComponents(bool isTracking)
+{
+    if (isTracking && !m_strongComponents) {
+        m_strongComponents.reset(new DynamicComponents());
+        m_strongComponents->reset(m_vertices);
+    } else if (!isTracking) {
+        m_strongComponents.reset();
     }
+}
 
-    file.close();
-    return true;
+void Graph::changeStructure()
+{
+    m_revision++;
+    m_structureRevision++;
+    m_hierarchy.reset();
 }
 
-bool Graph::loadFromFile(const QString& filename)
+// Self-loops are dropped, as addEdge would. Edges keep their snapshot ids;
+// an id seen twice gets a fresh one. Tracked components are recomputed once
+// at the end rather than edge by edge. Edges stay out of the spatial index
+// until indexEdges(): an imported graph laid out on a grid has edges
+// crossing hundreds of cells each, which is wasted on one too big to draw.
+void Graph::loadSnapshot(const GraphSnapshot &snapshot)
+{
+    clear();
+    m_isEdgeIndexed = false;
+
+    m_vertices.reserve(snapshot.vertexCount());
+    m_vertexIndex.reserve(snapshot.vertexCount());
+    m_vertexPool.reserve(snapshot.vertexCount());
+    for (int vertex = 0; vertex < snapshot.vertexCount(); ++vertex) {
+        Vertex* newVertex = m_vertexPool.create(snapshot.vertexId(vertex), snapshot.position(vertex));
+        m_vertices.append(newVertex);
+        m_vertexIndex.insert(newVertex->id(), newVertex);
+        m_spatialIndex.insertVertex(newVertex);
+
+        if (newVertex->id() >= m_vertexCounter) {
+            m_vertexCounter = newVertex->id() + 1;
+        }
+    }
+
+    m_edges.reserve(snapshot.edgeCount());
+    m_edgeIndex.reserve(snapshot.edgeCount());
+    m_edgeById.reserve(snapshot.edgeCount());
+    m_edgePool.reserve(snapshot.edgeCount());
+    for (int edge = 0; edge < snapshot.edgeCount(); ++edge) {
+        if (snapshot.edgeId(edge) >= m_edgeCounter) {
+            m_edgeCounter = snapshot.edgeId(edge) + 1;
+        }
+    }
+
+    for (int edge = 0; edge < snapshot.edgeCount(); ++edge) {
+        Vertex* fromVertex = m_vertices[snapshot.source(edge)];
+        Vertex* toVertex = m_vertices[snapshot.target(edge)];
+
+        if (fromVertex != toVertex) {
+            int id = snapshot.edgeId(edge);
+            if (m_edgeById.contains(id)) {
+                id = m_edgeCounter++;
+            }
+            createEdge(id, fromVertex, toVertex, snapshot.weight(edge));
+        }
+    }
+
+    if (m_strongComponents) {
+        m_strongComponents->reset(m_vertices);
+    }
+}
+
+bool Graph::loadLegacyFile(const QString& filename)
 {
     QFile file(filename);
     bool isFileOpened = false;
@@ -188,10 +519,13 @@ bool Graph::loadFromFile(const QString& filename)
 
     clear();
 
+    // Every record takes 12 bytes, which bounds what a bad count can reserve.
+    qint64 maxRecords = file.size() / 12;
+
     quint32 vertexCount = 0;
     in >> vertexCount;
-
-    QMap<quint32, Vertex*> vertexMap;
+    m_vertices.reserve(qMin<qint64>(vertexCount, maxRecords));
+    m_vertexIndex.reserve(qMin<qint64>(vertexCount, maxRecords));
 
     bool isVertexLoadingSuccessful = true;
     for (quint32 i = 0; i < vertexCount && isVertexLoadingSuccessful; ++i) {
@@ -203,10 +537,11 @@ bool Graph::loadFromFile(const QString& filename)
 
         if (in.status() != QDataStream::Ok) {
             isVertexLoadingSuccessful = false;
-        } else {
-            Vertex* vertex = new Vertex(static_cast<int>(id), position);
+        } else if (!m_vertexIndex.contains(static_cast<int>(id))) {
+            Vertex* vertex = m_vertexPool.create(static_cast<int>(id), position);
             m_vertices.append(vertex);
-            vertexMap[id] = vertex;
+            m_vertexIndex.insert(vertex->id(), vertex);
+            m_spatialIndex.insertVertex(vertex);
 
             // Обновляем счетчик ID
             if (id >= static_cast<quint32>(m_vertexCounter)) {
@@ -217,6 +552,9 @@ bool Graph::loadFromFile(const QString& filename)
 
     quint32 edgeCount = 0;
     in >> edgeCount;
+    m_edges.reserve(qMin<qint64>(edgeCount, maxRecords));
+    m_edgeIndex.reserve(qMin<qint64>(edgeCount, maxRecords));
+    m_edgeById.reserve(qMin<qint64>(edgeCount, maxRecords));
 
     bool isEdgeLoadingSuccessful = true;
     for (quint32 i = 0; i < edgeCount && isEdgeLoadingSuccessful; ++i) {
@@ -231,19 +569,21 @@ bool Graph::loadFromFile(const QString& filename)
         if (in.status() != QDataStream::Ok) {
             isEdgeLoadingSuccessful = false;
         } else {
-            Vertex* fromVertex = vertexMap.value(fromId, nullptr);
-            Vertex* toVertex = vertexMap.value(toId, nullptr);
+            Vertex* fromVertex = m_vertexIndex.value(static_cast<int>(fromId), nullptr);
+            Vertex* toVertex = m_vertexIndex.value(static_cast<int>(toId), nullptr);
 
             if (fromVertex && toVertex && fromVertex != toVertex) {
-                fromVertex->addOutNeighbor(toVertex);
-                Edge* edge = new Edge(fromVertex, toVertex, weight);
-                m_edges.append(edge);
+                createEdge(m_edgeCounter++, fromVertex, toVertex, weight);
             }
         }
     }
 
     file.close();
 
+    if (m_strongComponents) {
+        m_strongComponents->reset(m_vertices);
+    }
+
     bool isLoadSuccessful = (isVertexLoadingSuccessful && isEdgeLoadingSuccessful);
     return isLoadSuccessful;
 }
\ No newline at end of file
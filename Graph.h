@@ -3,7 +3,16 @@
 
 #include "Vertex.h"
 #include "Edge.h"
+#include "GraphSnapshot.h"
+#include "SpatialGrid.h"
+#include "GraphFile.h"
+#include "ContractionHierarchy.h"
+#include "DynamicComponents.h"
+#include "ObjectPool.h"
 #include <QVector>
+#include <QHash>
+#include <QPair>
+#include <memory>
 
 class Graph
 {
@@ -13,29 +22,91 @@ public:
 
     Vertex* addVertex(const QPoint &position);
     void removeVertex(Vertex *vertex);
-    void addEdge(Vertex *from, Vertex *to);
+    void moveVertex(Vertex *vertex, const QPoint &position);
+    void moveVertices(const QVector<int> &vertexIds, const QVector<QPoint> &positions);
+    // Parallel edges are allowed, self-loops are not; returns null for a
+    // refused edge.
+    Edge* addEdge(Vertex *from, Vertex *to, int weight = 1);
+    // Removes one edge from -> to, the one getEdge returns.
     void removeEdge(Vertex *from, Vertex *to);
     void removeEdge(Edge *edge);
+    void setEdgeWeight(Edge *edge, int weight);
 
+    // One of the edges from -> to, or null.
     Edge* getEdge(Vertex *from, Vertex *to) const;
+    Edge* getEdgeById(int id) const;
+    QVector<Edge*> edgesBetween(Vertex *from, Vertex *to) const;
+    // findEdgeAt and edgesIn only see edges in the spatial index; see
+    // indexEdges.
     Edge* findEdgeAt(const QPoint &point, int radius = 5) const;
     Vertex* findVertexAt(const QPoint &point, int radius = 20) const;
     Vertex* getVertexById(int id) const;
+    QVector<Vertex*> verticesIn(const QRect &rect) const;
+    QVector<Edge*> edgesIn(const QRect &rect) const;
     bool areConnected(Vertex *from, Vertex *to) const;
 
     const QVector<Vertex*>& vertices() const { return m_vertices; }
     const QVector<Edge*>& edges() const { return m_edges; }
     int vertexCount() const { return m_vertices.size(); }
     int edgeCount() const { return m_edges.size(); }
+    // Bumped by every change to vertices, positions, edges or weights.
+    quint64 revision() const { return m_revision; }
+    // Bumped by the same changes except vertex moves.
+    quint64 structureRevision() const { return m_structureRevision; }
 
-    bool saveToFile(const QString& filename) const;
+    // Contraction hierarchy for the current vertices, edges and weights, or
+    // null. Every change counted by structureRevision drops it; it is saved
+    // next to the .graph file and picked up again on load when it fits.
+    std::shared_ptr<const ContractionHierarchy> hierarchy() const { return m_hierarchy; }
+    // Ignored when the structure changed since structureRevision was read.
+    void setHierarchy(const std::shared_ptr<const ContractionHierarchy> &hierarchy, quint64 structureRevision);
+
+    // Off by default. While on, every edit also updates the strongly
+    // connected components and a topological order of them, which
+    // strongComponents() then returns; it is null while off.
+    void setTracksComponents(bool isTracking);
+    const DynamicComponents* strongComponents() const { return m_strongComponents.get(); }
+
+    GraphSnapshot snapshot() const;
+
+    bool saveToFile(const QString& filename, GraphFile::Encoding encoding = GraphFile::Encoding::Fixed) const;
     bool loadFromFile(const QString& filename);
+    void loadSnapshot(const GraphSnapshot &snapshot);
     void clear();
+    // Adds the edges loadSnapshot left out to the spatial index, for callers
+    // about to look edges up by position; a no-op once they are in.
+    void indexEdges();
 
 private:
+    typedef QPair<const Vertex*, const Vertex*> EdgeKey;
+
+    bool loadLegacyFile(const QString& filename);
+    void loadHierarchy(const QString& filename);
+    void changeStructure();
+    Edge* createEdge(int id, Vertex *from, Vertex *to, int weight);
+    void detachEdge(Edge *edge);
+    QVector<Edge*> incidentEdges(Vertex *vertex) const;
+    void indexEdge(Edge *edge);
+    void unindexEdge(Edge *edge);
+
+    ObjectPool<Vertex> m_vertexPool;
+    ObjectPool<Edge> m_edgePool;
+    EdgeArena m_edgeArena;
     QVector<Vertex*> m_vertices;
     QVector<Edge*> m_edges;
+    // One edge per connected pair, so that simple-graph lookups stay a
+    // single hash probe; parallel edges are found through the edge lists.
+    QHash<EdgeKey, Edge*> m_edgeIndex;
+    QHash<int, Edge*> m_edgeById;
+    QHash<int, Vertex*> m_vertexIndex;
+    SpatialGrid m_spatialIndex;
     int m_vertexCounter;
+    int m_edgeCounter;
+    quint64 m_revision;
+    quint64 m_structureRevision;
+    bool m_isEdgeIndexed;
+    std::shared_ptr<const ContractionHierarchy> m_hierarchy;
+    std::unique_ptr<DynamicComponents> m_strongComponents;
     double distanceToLineSegment(const QPoint &point, const QPoint &lineStart, const QPoint &lineEnd) const;
 
 };
@@ -1,65 +1,93 @@
 #include "GraphAlgorithms.h"
 #include "Graph.h"
-#include "Vertex.h"
-#include "Edge.h"
-#include <QSet>
-#include <QStack>
-#include <QMap>
-#include <QQueue>
+#include "GraphSnapshot.h"
+#include "PriorityQueues.h"
+#include <limits>
+#include <algorithm>
 
 
-QString GraphAlgorithms::validateGraph(Graph* graph){
-    QString errorMessage = "";
+AlgorithmStatus GraphAlgorithms::validateGraph(const GraphSnapshot& snapshot){
+    AlgorithmStatus status = AlgorithmStatus::Ok;
 
-    if (!graph) {
-        errorMessage = "Graph is not initialized.";
-    }
-    else if (graph->vertexCount() == 0) {
-        errorMessage = "Graph is empty. No vertices for sorting.";
+    if (snapshot.vertexCount() == 0) {
+        status = AlgorithmStatus::EmptyGraph;
     }
-    else if (!isWeaklyConnected(graph)) {
-        errorMessage = "Graph is not weakly connected. Topological sort is only possible for weakly connected directed graphs.";
+    else if (!isWeaklyConnected(snapshot)) {
+        status = AlgorithmStatus::NotWeaklyConnected;
     }
     else {
-        QSet<Vertex*> visited;
-        QSet<Vertex*> recursionStack;
+        QVector<bool> visited(snapshot.vertexCount(), false);
+        QVector<bool> recursionStack(snapshot.vertexCount(), false);
         bool hasCycle = false;
 
-        for (Vertex* vertex : graph->vertices()) {
-            if (!visited.contains(vertex)) {
-                if (hasCycleDFS(vertex, visited, recursionStack)) {
+        for (int vertex = 0; vertex < snapshot.vertexCount(); ++vertex) {
+            if (!visited[vertex]) {
+                if (hasCycleDFS(snapshot, vertex, visited, recursionStack)) {
                     hasCycle = true;
                 }
             }
         }
 
         if (hasCycle) {
-            errorMessage = "Graph contains cycles. Topological sort is not possible for graphs with cycles.";
+            status = AlgorithmStatus::ContainsCycle;
         }
     }
 
-    return errorMessage;
+    return status;
 }
 
-QString GraphAlgorithms::topologicalSort(Graph* graph){
-    QString result = "";
-    QString error = validateGraph(graph);
-    if (!error.isEmpty()) {
-        result = error;
+QVector<int> GraphAlgorithms::toVertexIds(const GraphSnapshot& snapshot, const QVector<int>& vertices){
+    QVector<int> vertexIds;
+    vertexIds.reserve(vertices.size());
+
+    for (int vertex : vertices) {
+        vertexIds.append(snapshot.vertexId(vertex));
     }
-    else {
-        QSet<Vertex*> sortVisited;
-        QVector<Vertex*> sortedVertices;
 
-        for (Vertex* vertex : graph->vertices()) {
-            if (!sortVisited.contains(vertex)) {
-                topologicalSortDFS(vertex, sortVisited, sortedVertices);
+    return vertexIds;
+}
+
+// With parallel edges, a shortest path runs over the lightest one of each
+// pair of consecutive vertices.
+QVector<int> GraphAlgorithms::pathEdgeIds(const GraphSnapshot& snapshot, const QVector<int>& vertices){
+    QVector<int> edgeIds;
+    edgeIds.reserve(vertices.size());
+
+    for (int i = 1; i < vertices.size(); ++i) {
+        int lightest = -1;
+        for (int edge = snapshot.outBegin(vertices[i - 1]); edge < snapshot.outEnd(vertices[i - 1]); ++edge) {
+            if (snapshot.target(edge) == vertices[i] && (lightest < 0 || snapshot.weight(edge) < snapshot.weight(lightest))) {
+                lightest = edge;
             }
         }
-        for (int i = sortedVertices.size() - 1; i >= 0; --i) {
-            result += QString::number(sortedVertices[i]->id());
-            if (i > 0) {
-                result += " -> ";
+        edgeIds.append(snapshot.edgeId(lightest));
+    }
+
+    return edgeIds;
+}
+
+// A graph that tracks its components already knows whether it has a cycle
+// and keeps its vertices in topological order, so only the output is built.
+VertexSequenceResult GraphAlgorithms::topologicalSort(Graph* graph){
+    VertexSequenceResult result;
+
+    if (!graph) {
+        result.status = AlgorithmStatus::GraphNotInitialized;
+    } else if (!graph->strongComponents()) {
+        result = topologicalSort(graph->snapshot());
+    } else {
+        const DynamicComponents &tracked = *graph->strongComponents();
+
+        if (graph->vertexCount() == 0) {
+            result.status = AlgorithmStatus::EmptyGraph;
+        } else if (tracked.weakComponentCount() > 1) {
+            result.status = AlgorithmStatus::NotWeaklyConnected;
+        } else if (!tracked.isAcyclic()) {
+            result.status = AlgorithmStatus::ContainsCycle;
+        } else {
+            result.vertexIds.reserve(graph->vertexCount());
+            for (int component : tracked.topologicalOrder()) {
+                result.vertexIds.append(tracked.members(component).first()->id());
             }
         }
     }
@@ -67,298 +95,314 @@ QString GraphAlgorithms::topologicalSort(Graph* graph){
     return result;
 }
 
-bool GraphAlgorithms::hasCycleDFS(Vertex* vertex, QSet<Vertex*>& visited, QSet<Vertex*>& recursionStack){
-    bool hasCycle = false;
+VertexSequenceResult GraphAlgorithms::topologicalSort(const GraphSnapshot& snapshot){
+    VertexSequenceResult result;
 
-    if (recursionStack.contains(vertex)) {
-        hasCycle = true;
+    result.status = validateGraph(snapshot);
+    if (result.isOk()) {
+        QVector<bool> sortVisited(snapshot.vertexCount(), false);
+        QVector<int> sortedVertices;
+        sortedVertices.reserve(snapshot.vertexCount());
+
+        for (int vertex = 0; vertex < snapshot.vertexCount(); ++vertex) {
+            if (!sortVisited[vertex]) {
+                topologicalSortDFS(snapshot, vertex, sortVisited, sortedVertices);
+            }
+        }
+        std::reverse(sortedVertices.begin(), sortedVertices.end());
+        result.vertexIds = toVertexIds(snapshot, sortedVertices);
     }
-    else if (!visited.contains(vertex)) {
-        visited.insert(vertex);
-        recursionStack.insert(vertex);
 
-        for (Vertex* neighbor : vertex->outNeighbors()) {
-            if (hasCycleDFS(neighbor, visited, recursionStack)) {
+    return result;
+}
+
+// The DFS helpers below keep (vertex, next out-edge slot) frames on an
+// explicit stack, so path length is bounded by heap, not thread stack.
+bool GraphAlgorithms::hasCycleDFS(const GraphSnapshot& snapshot, int vertex, QVector<bool>& visited, QVector<bool>& recursionStack){
+    bool hasCycle = false;
+    QVector<int> stack;
+    QVector<int> nextEdge;
+
+    visited[vertex] = true;
+    recursionStack[vertex] = true;
+    stack.append(vertex);
+    nextEdge.append(snapshot.outBegin(vertex));
+
+    while (!stack.isEmpty() && !hasCycle) {
+        int current = stack.last();
+
+        if (nextEdge.last() < snapshot.outEnd(current)) {
+            int neighbor = snapshot.target(nextEdge.last()++);
+
+            if (recursionStack[neighbor]) {
                 hasCycle = true;
             }
+            else if (!visited[neighbor]) {
+                visited[neighbor] = true;
+                recursionStack[neighbor] = true;
+                stack.append(neighbor);
+                nextEdge.append(snapshot.outBegin(neighbor));
+            }
+        }
+        else {
+            recursionStack[current] = false;
+            stack.removeLast();
+            nextEdge.removeLast();
         }
+    }
 
-        recursionStack.remove(vertex);
+    for (int onStack : stack) {
+        recursionStack[onStack] = false;
     }
 
     return hasCycle;
 }
 
-void GraphAlgorithms::topologicalSortDFS(Vertex* vertex, QSet<Vertex*>& visited, QVector<Vertex*>& result){
-    visited.insert(vertex);
+void GraphAlgorithms::topologicalSortDFS(const GraphSnapshot& snapshot, int vertex, QVector<bool>& visited, QVector<int>& result){
+    QVector<int> stack;
+    QVector<int> nextEdge;
+
+    visited[vertex] = true;
+    stack.append(vertex);
+    nextEdge.append(snapshot.outBegin(vertex));
+
+    while (!stack.isEmpty()) {
+        int current = stack.last();
 
-    for (Vertex* neighbor : vertex->outNeighbors()) {
-        if (!visited.contains(neighbor)) {
-            topologicalSortDFS(neighbor, visited, result);
+        if (nextEdge.last() < snapshot.outEnd(current)) {
+            int neighbor = snapshot.target(nextEdge.last()++);
+
+            if (!visited[neighbor]) {
+                visited[neighbor] = true;
+                stack.append(neighbor);
+                nextEdge.append(snapshot.outBegin(neighbor));
+            }
+        }
+        else {
+            result.append(current);
+            stack.removeLast();
+            nextEdge.removeLast();
         }
     }
-
-    result.append(vertex);
 }
 
-bool GraphAlgorithms::isWeaklyConnected(Graph* graph){
+bool GraphAlgorithms::isWeaklyConnected(const GraphSnapshot& snapshot){
     bool isConnected = true;
 
-    if (graph->vertexCount() == 0) {
+    if (snapshot.vertexCount() == 0) {
         isConnected = true;
     }
     else {
-        QSet<Vertex*> visited;
-        QQueue<Vertex*> queue;
+        QVector<bool> visited(snapshot.vertexCount(), false);
+        QVector<int> queue;
+        queue.reserve(snapshot.vertexCount());
 
-        queue.enqueue(graph->vertices().first());
-        visited.insert(graph->vertices().first());
+        queue.append(0);
+        visited[0] = true;
 
-        while (!queue.isEmpty()) {
-            Vertex* current = queue.dequeue();
+        for (int head = 0; head < queue.size(); ++head) {
+            int current = queue[head];
 
-            for (Vertex* neighbor : current->outNeighbors()) {
-                if (!visited.contains(neighbor)) {
-                    visited.insert(neighbor);
-                    queue.enqueue(neighbor);
+            for (int edge = snapshot.outBegin(current); edge < snapshot.outEnd(current); ++edge) {
+                int neighbor = snapshot.target(edge);
+                if (!visited[neighbor]) {
+                    visited[neighbor] = true;
+                    queue.append(neighbor);
                 }
             }
 
-            for (Vertex* neighbor : current->inNeighbors()) {
-                if (!visited.contains(neighbor)) {
-                    visited.insert(neighbor);
-                    queue.enqueue(neighbor);
+            for (int slot = snapshot.inBegin(current); slot < snapshot.inEnd(current); ++slot) {
+                int neighbor = snapshot.inSource(slot);
+                if (!visited[neighbor]) {
+                    visited[neighbor] = true;
+                    queue.append(neighbor);
                 }
             }
         }
 
-        isConnected = (visited.size() == graph->vertexCount());
+        isConnected = (queue.size() == snapshot.vertexCount());
     }
 
     return isConnected;
 }
 
 
-QString GraphAlgorithms::eulerianCycle(Graph* graph){
-    QString result = "";
+VertexSequenceResult GraphAlgorithms::eulerianCycle(Graph* graph){
+    VertexSequenceResult result;
 
     if (!graph) {
-        result = "Graph is not initialized.";
-    }
-    else if (graph->vertexCount() == 0) {
-        result = "Graph is empty. No vertices for finding Eulerian cycle.";
-    }
-    else if (!hasEulerianCycleConditions(graph)) {
-        result = "Graph does not satisfy conditions for Eulerian cycle.";
+        result.status = AlgorithmStatus::GraphNotInitialized;
+    } else {
+        result = eulerianCycle(graph->snapshot());
     }
-    else {
-        QMap<Vertex*, QList<Vertex*>> availableEdges;
-        for (Vertex* vertex : graph->vertices()) {
-            availableEdges[vertex] = vertex->outNeighbors().values();
-        }
-        Vertex* startVertex = nullptr;
-        bool isStartVertexFound = false;
-        for (Vertex* vertex : graph->vertices()) {
-            if (!isStartVertexFound && vertex->outDegree() > 0) {
-                startVertex = vertex;
-                isStartVertexFound = true;
-            }
-        }
 
-        if (!startVertex) {
-            result = "No edges found in the graph.";
-        }
-        else {
-            QVector<Vertex*> path;
-            eulerianDFS(startVertex, path, availableEdges);
+    return result;
+}
 
-            if (path.isEmpty()) {
-                result = "No Eulerian cycle found.";
-            }
-            else {
-                for (int i = 0; i < path.size(); ++i) {
-                    result += QString::number(path[i]->id());
-                    if (i < path.size() - 1) {
-                        result += " -> ";
-                    }
-                }
-            }
-        }
+VertexSequenceResult GraphAlgorithms::eulerianCycle(const GraphSnapshot& snapshot){
+    VertexSequenceResult result;
+
+    if (snapshot.vertexCount() == 0) {
+        result.status = AlgorithmStatus::EmptyGraph;
+    }
+    else {
+        result = eulerianTrail(snapshot, EulerianTrail::Kind::Cycle);
     }
 
     return result;
 }
 
-bool GraphAlgorithms::hasEulerianCycleConditions(Graph* graph){
-    bool conditionsSatisfied = true;
+VertexSequenceResult GraphAlgorithms::eulerianTrail(const GraphSnapshot& snapshot, EulerianTrail::Kind kind){
+    VertexSequenceResult result;
+    EulerianTrail::Result trail = EulerianTrail(snapshot).find(kind);
 
-    if (!isWeaklyConnected(graph)) {
-        conditionsSatisfied = false;
+    if (trail.status == EulerianTrail::Status::NoEdges) {
+        result.status = AlgorithmStatus::NoEdges;
+    }
+    else if (trail.status != EulerianTrail::Status::Found) {
+        result.status = AlgorithmStatus::ConditionsNotMet;
     }
     else {
-        bool hasDegreeMismatch = false;
-        for (Vertex* vertex : graph->vertices()) {
-            if (!hasDegreeMismatch && vertex->inDegree() != vertex->outDegree()) {
-                hasDegreeMismatch = true;
-            }
-        }
-
-        if (hasDegreeMismatch) {
-            conditionsSatisfied = false;
+        result.vertexIds.reserve(trail.edges.size() + 1);
+        result.edgeIds.reserve(trail.edges.size());
+        result.vertexIds.append(snapshot.vertexId(trail.start));
+        for (int edge : trail.edges) {
+            result.vertexIds.append(snapshot.vertexId(snapshot.target(edge)));
+            result.edgeIds.append(snapshot.edgeId(edge));
         }
     }
 
-    return conditionsSatisfied;
+    return result;
 }
 
-void GraphAlgorithms::eulerianDFS(Vertex* vertex, QVector<Vertex*>& path, QMap<Vertex*, QList<Vertex*>>& availableEdges){
-    QStack<Vertex*> stack;
-    stack.push(vertex);
-
-    QVector<Vertex*> circuit;
-
-    while (!stack.isEmpty()) {
-        Vertex* current = stack.top();
+ShortestPathResult GraphAlgorithms::dijkstra(Graph* graph, int startVertexId, int endVertexId,
+                                             PriorityQueueKind queueKind){
+    ShortestPathResult result;
 
-        if (!availableEdges[current].isEmpty()) {
-            Vertex* next = availableEdges[current].first();
-            availableEdges[current].removeFirst();
-            stack.push(next);
-        }
-        else {
-            circuit.append(current);
-            stack.pop();
-        }
-    }
-    for (int i = circuit.size() - 1; i >= 0; --i) {
-        path.append(circuit[i]);
+    if (!graph) {
+        result.status = AlgorithmStatus::GraphNotInitialized;
+        result.startId = startVertexId;
+        result.endId = endVertexId;
+    } else {
+        result = dijkstra(graph->snapshot(), startVertexId, endVertexId, queueKind);
     }
+
+    return result;
 }
 
-QString GraphAlgorithms::dijkstra(Graph* graph, int startVertexId, int endVertexId){
-    QString result = "";
-    Vertex* startVertex = nullptr;
-    Vertex* endVertex = nullptr;
+ShortestPathResult GraphAlgorithms::dijkstra(const GraphSnapshot& snapshot, int startVertexId, int endVertexId,
+                                             PriorityQueueKind queueKind, AlgorithmProgress* progress){
+    ShortestPathResult result;
+    result.startId = startVertexId;
+    result.endId = endVertexId;
 
-    QString validationError = validateDijkstraInput(graph, startVertexId, endVertexId, startVertex, endVertex);
-    if (!validationError.isEmpty()) {
-        result = validationError;
+    int startVertex = -1;
+    int endVertex = -1;
+
+    result.status = validateEndpoints(snapshot, startVertexId, endVertexId, startVertex, endVertex);
+    if (!result.isOk()) {
         return result;
     }
 
-    QMap<Vertex*, int> distances;
-    QMap<Vertex*, Vertex*> previous;
-    QSet<Vertex*> unvisited;
-    initializeDijkstra(graph, distances, previous, unvisited, startVertex);
-
-    bool isAlgorithmComplete = false;
-    while (!unvisited.isEmpty() && !isAlgorithmComplete) {
-        Vertex* current = findMinDistanceVertex(unvisited, distances);
+    QVector<int> distances;
+    QVector<int> previous;
+    QVector<bool> settled;
+    initializeDijkstra(snapshot, distances, previous, settled, startVertex);
 
-        if (!current || distances[current] == std::numeric_limits<int>::max()) {
-            isAlgorithmComplete = true;
-        } else {
-            unvisited.remove(current);
-            updateNeighborDistances(current, graph, distances, previous, unvisited);
-        }
+    bool isCancelled = false;
+    // The radix heap needs monotone keys, which negative weights would break.
+    if (queueKind == PriorityQueueKind::RadixHeap && !hasNegativeWeights(snapshot)) {
+        isCancelled = dijkstraWithRadixHeap(snapshot, startVertex, endVertex, distances, previous, settled, progress);
+    } else {
+        isCancelled = dijkstraWithDaryHeap(snapshot, startVertex, endVertex, distances, previous, settled, progress);
     }
 
-    result = buildDijkstraResult(startVertex, endVertex, distances, previous);
+    if (isCancelled) {
+        result.status = AlgorithmStatus::Cancelled;
+    } else {
+        buildDijkstraResult(snapshot, endVertex, distances, previous, result);
+    }
     return result;
 }
 
-QString GraphAlgorithms::validateDijkstraInput(Graph* graph, int startVertexId, int endVertexId,
-                                              Vertex*& startVertex, Vertex*& endVertex){
-    QString errorMessage = "";
+ShortestPathResult GraphAlgorithms::shortestPath(Graph* graph, int startVertexId, int endVertexId,
+                                                 PointToPointSearch::Method method){
+    ShortestPathResult result;
 
     if (!graph) {
-        errorMessage = "Graph is not initialized.";
+        result.status = AlgorithmStatus::GraphNotInitialized;
+        result.startId = startVertexId;
+        result.endId = endVertexId;
     } else {
-        startVertex = graph->getVertexById(startVertexId);
-        endVertex = graph->getVertexById(endVertexId);
-
-        if (!startVertex) {
-            errorMessage = "Start vertex with ID " + QString::number(startVertexId) + " not found.";
-        } else if (!endVertex) {
-            errorMessage = "End vertex with ID " + QString::number(endVertexId) + " not found.";
-        } else if (startVertex == endVertex) {
-            errorMessage = "Start and end vertices are the same. Distance: 0";
-        }
+        result = shortestPath(graph->snapshot(), startVertexId, endVertexId, method);
     }
 
-    return errorMessage;
+    return result;
 }
 
-void GraphAlgorithms::initializeDijkstra(Graph* graph, QMap<Vertex*, int>& distances,
-                                        QMap<Vertex*, Vertex*>& previous, QSet<Vertex*>& unvisited,
-                                        Vertex* startVertex){
-    for (Vertex* vertex : graph->vertices()) {
-        distances[vertex] = std::numeric_limits<int>::max();
-        previous[vertex] = nullptr;
-        unvisited.insert(vertex);
-    }
-    distances[startVertex] = 0;
+ShortestPathResult GraphAlgorithms::shortestPath(const GraphSnapshot& snapshot, int startVertexId, int endVertexId,
+                                                 PointToPointSearch::Method method, AlgorithmProgress* progress){
+    PointToPointSearch search(snapshot);
+    return shortestPath(search, startVertexId, endVertexId, method, progress);
 }
 
-Vertex* GraphAlgorithms::findMinDistanceVertex(const QSet<Vertex*>& unvisited, const QMap<Vertex*, int>& distances){
-    Vertex* minVertex = nullptr;
-    int minDistance = std::numeric_limits<int>::max();
+ShortestPathResult GraphAlgorithms::shortestPath(PointToPointSearch& search, int startVertexId, int endVertexId,
+                                                 PointToPointSearch::Method method, AlgorithmProgress* progress){
+    const GraphSnapshot& snapshot = search.snapshot();
+    ShortestPathResult result;
+    result.startId = startVertexId;
+    result.endId = endVertexId;
 
-    for (Vertex* vertex : unvisited) {
-        if (distances[vertex] < minDistance) {
-            minDistance = distances[vertex];
-            minVertex = vertex;
-        }
-    }
+    int startVertex = -1;
+    int endVertex = -1;
 
-    return minVertex;
-}
+    result.status = validateEndpoints(snapshot, startVertexId, endVertexId, startVertex, endVertex);
+    if (!result.isOk()) {
+        return result;
+    }
 
-void GraphAlgorithms::updateNeighborDistances(Vertex* current, Graph* graph, QMap<Vertex*, int>& distances,
-                                            QMap<Vertex*, Vertex*>& previous, const QSet<Vertex*>& unvisited){
-    for (Vertex* neighbor : current->outNeighbors()) {
-        if (unvisited.contains(neighbor)) {
-            Edge* edge = graph->getEdge(current, neighbor);
-            if (edge) {
-                int alternative = distances[current] + edge->weight();
-                if (alternative < distances[neighbor]) {
-                    distances[neighbor] = alternative;
-                    previous[neighbor] = current;
-                }
-            }
-        }
+    if (search.hasNegativeWeights()) {
+        return dijkstra(snapshot, startVertexId, endVertexId, PriorityQueueKind::DaryHeap, progress);
     }
-}
 
-QString GraphAlgorithms::buildDijkstraResult(Vertex* startVertex, Vertex* endVertex,
-                                            const QMap<Vertex*, int>& distances, const QMap<Vertex*, Vertex*>& previous){
-    QString result = "";
+    PointToPointSearch::Result found = search.run(startVertex, endVertex, method, progress);
 
-    if (distances[endVertex] == std::numeric_limits<int>::max()) {
-        result = "No path from vertex " + QString::number(startVertex->id()) +
-                 " to vertex " + QString::number(endVertex->id());
+    if (found.isCancelled) {
+        result.status = AlgorithmStatus::Cancelled;
+    } else if (found.distance == PointToPointSearch::UNREACHABLE) {
+        result.status = AlgorithmStatus::NoPath;
     } else {
-        QVector<Vertex*> path;
-        Vertex* current = endVertex;
-        bool isPathComplete = false;
-
-        while (!isPathComplete) {
-            path.prepend(current);
-            current = previous[current];
-            if (!current) {
-                isPathComplete = true;
-            }
-        }
+        result.distance = found.distance;
+        result.path = toVertexIds(snapshot, found.path);
+        result.edgeIds = pathEdgeIds(snapshot, found.path);
+    }
 
-        result = "Shortest path from " + QString::number(startVertex->id()) +
-                 " to " + QString::number(endVertex->id()) + ":\n";
-        result += "Distance: " + QString::number(distances[endVertex]) + "\n";
-        result += "Path: ";
+    return result;
+}
 
-        for (int i = 0; i < path.size(); ++i) {
-            result += QString::number(path[i]->id());
-            if (i < path.size() - 1) {
-                result += " → ";
+ShortestPathResult GraphAlgorithms::shortestPath(ContractionHierarchy::Query& query, int startVertexId, int endVertexId){
+    const ContractionHierarchy& hierarchy = query.hierarchy();
+    ShortestPathResult result;
+    result.startId = startVertexId;
+    result.endId = endVertexId;
+
+    int startVertex = hierarchy.indexOf(startVertexId);
+    int endVertex = hierarchy.indexOf(endVertexId);
+
+    if (startVertex < 0) {
+        result.status = AlgorithmStatus::StartVertexNotFound;
+    } else if (endVertex < 0) {
+        result.status = AlgorithmStatus::EndVertexNotFound;
+    } else if (startVertex == endVertex) {
+        result.status = AlgorithmStatus::SameEndpoints;
+    } else {
+        ContractionHierarchy::Result found = query.run(startVertex, endVertex);
+        if (found.distance == ContractionHierarchy::UNREACHABLE) {
+            result.status = AlgorithmStatus::NoPath;
+        } else {
+            result.distance = found.distance;
+            for (int vertex : found.path) {
+                result.path.append(hierarchy.vertexId(vertex));
             }
         }
     }
@@ -366,397 +410,473 @@ QString GraphAlgorithms::buildDijkstraResult(Vertex* startVertex, Vertex* endVer
     return result;
 }
 
+AlgorithmStatus GraphAlgorithms::validateEndpoints(const GraphSnapshot& snapshot, int startVertexId, int endVertexId,
+                                                   int& startVertex, int& endVertex){
+    AlgorithmStatus status = AlgorithmStatus::Ok;
 
+    startVertex = snapshot.indexOf(startVertexId);
+    endVertex = snapshot.indexOf(endVertexId);
 
-QString GraphAlgorithms::maxFlow(Graph* graph, int sourceId, int sinkId){
-    QString result = "";
-    Vertex* source = nullptr;
-    Vertex* sink = nullptr;
-
-    QString validationError = validateMaxFlowInput(graph, sourceId, sinkId, source, sink);
-    if (!validationError.isEmpty()) {
-        result = validationError;
-        return result;
+    if (startVertex < 0) {
+        status = AlgorithmStatus::StartVertexNotFound;
+    } else if (endVertex < 0) {
+        status = AlgorithmStatus::EndVertexNotFound;
+    } else if (startVertex == endVertex) {
+        status = AlgorithmStatus::SameEndpoints;
     }
 
-    QMap<Vertex*, QMap<Vertex*, int>> residual;
-    initializeResidualNetwork(graph, residual);
+    return status;
+}
 
-    int maxFlow = 0;
-    bool isPathFound = true;
+void GraphAlgorithms::initializeDijkstra(const GraphSnapshot& snapshot, QVector<int>& distances,
+                                        QVector<int>& previous, QVector<bool>& settled, int startVertex){
+    distances.fill(std::numeric_limits<int>::max(), snapshot.vertexCount());
+    previous.fill(-1, snapshot.vertexCount());
+    settled.fill(false, snapshot.vertexCount());
+    distances[startVertex] = 0;
+}
 
-    while (isPathFound) {
-        QMap<Vertex*, Vertex*> parent;
-        isPathFound = findAugmentingPathBFS(source, sink, residual, parent);
+bool GraphAlgorithms::hasNegativeWeights(const GraphSnapshot& snapshot){
+    bool hasNegative = false;
 
-        if (isPathFound) {
-            int pathFlow = calculatePathFlow(source, sink, parent, residual);
-            updateResidualNetwork(source, sink, pathFlow, parent, residual);
-            maxFlow += pathFlow;
+    for (int edge = 0; edge < snapshot.edgeCount() && !hasNegative; ++edge) {
+        if (snapshot.weight(edge) < 0) {
+            hasNegative = true;
         }
     }
 
-    result = "Maximum flow from source " + QString::number(sourceId) +
-             " to sink " + QString::number(sinkId) + ": " + QString::number(maxFlow);
-    return result;
+    return hasNegative;
 }
 
-QString GraphAlgorithms::validateMaxFlowInput(Graph* graph, int sourceId, int sinkId,
-                                             Vertex*& source, Vertex*& sink){
-    QString errorMessage = "";
+bool GraphAlgorithms::dijkstraWithDaryHeap(const GraphSnapshot& snapshot, int startVertex, int endVertex,
+                                           QVector<int>& distances, QVector<int>& previous, QVector<bool>& settled,
+                                           AlgorithmProgress* progress){
+    IndexedDaryHeap heap(snapshot.vertexCount());
+    heap.push(startVertex, 0);
 
-    if (!graph) {
-        errorMessage = "Graph is not initialized.";
-    } else {
-        source = graph->getVertexById(sourceId);
-        sink = graph->getVertexById(sinkId);
-
-        if (!source) {
-            errorMessage = "Source vertex with ID " + QString::number(sourceId) + " not found.";
-        } else if (!sink) {
-            errorMessage = "Sink vertex with ID " + QString::number(sinkId) + " not found.";
-        } else if (source == sink) {
-            errorMessage = "Source and sink vertices are the same. Max flow: 0";
-        }
-    }
+    bool isTargetSettled = false;
+    bool isCancelled = false;
+    int settledCount = 0;
+    while (!heap.isEmpty() && !isTargetSettled && !isCancelled) {
+        int current = heap.pop();
+        settled[current] = true;
 
-    return errorMessage;
-}
+        if (++settledCount % AlgorithmProgress::CHECK_INTERVAL == 0) {
+            isCancelled = AlgorithmProgress::checkpoint(progress, settledCount, snapshot.vertexCount());
+        }
 
-void GraphAlgorithms::initializeResidualNetwork(Graph* graph, QMap<Vertex*, QMap<Vertex*, int>>& residual){
-    for (Vertex* u : graph->vertices()) {
-        for (Vertex* v : u->outNeighbors()) {
-            Edge* edge = graph->getEdge(u, v);
-            if (edge) {
-                residual[u][v] = edge->weight();
-                if (!residual[v].contains(u)) {
-                    residual[v][u] = 0;
+        if (current == endVertex) {
+            isTargetSettled = true;
+        } else {
+            for (int edge = snapshot.outBegin(current); edge < snapshot.outEnd(current); ++edge) {
+                int neighbor = snapshot.target(edge);
+                int alternative = distances[current] + snapshot.weight(edge);
+                if (!settled[neighbor] && alternative < distances[neighbor]) {
+                    distances[neighbor] = alternative;
+                    previous[neighbor] = current;
+                    heap.push(neighbor, alternative);
                 }
             }
         }
     }
-}
-
-bool GraphAlgorithms::findAugmentingPathBFS(Vertex* source, Vertex* sink,
-                                           const QMap<Vertex*, QMap<Vertex*, int>>& residual,
-                                           QMap<Vertex*, Vertex*>& parent){
-    QQueue<Vertex*> queue;
-    QSet<Vertex*> visited;
-
-    queue.enqueue(source);
-    visited.insert(source);
-    parent[source] = nullptr;
 
-    bool isPathFound = false;
-    bool isBFSSearching = true;
+    return isCancelled;
+}
 
-    while (!queue.isEmpty() && isBFSSearching && !isPathFound) {
-        Vertex* current = queue.dequeue();
+bool GraphAlgorithms::dijkstraWithRadixHeap(const GraphSnapshot& snapshot, int startVertex, int endVertex,
+                                            QVector<int>& distances, QVector<int>& previous, QVector<bool>& settled,
+                                            AlgorithmProgress* progress){
+    RadixHeap heap;
+    heap.push(startVertex, 0);
 
-        QList<Vertex*> neighbors = residual[current].keys();
-        int neighborIndex = 0;
+    bool isTargetSettled = false;
+    bool isCancelled = false;
+    int settledCount = 0;
+    while (!heap.isEmpty() && !isTargetSettled && !isCancelled) {
+        int key = 0;
+        int current = heap.pop(key);
 
-        while (neighborIndex < neighbors.size() && !isPathFound) {
-            Vertex* neighbor = neighbors[neighborIndex];
+        if (!settled[current] && key == distances[current]) {
+            settled[current] = true;
 
-            if (!visited.contains(neighbor) && residual[current][neighbor] > 0) {
-                visited.insert(neighbor);
-                parent[neighbor] = current;
-                queue.enqueue(neighbor);
+            if (++settledCount % AlgorithmProgress::CHECK_INTERVAL == 0) {
+                isCancelled = AlgorithmProgress::checkpoint(progress, settledCount, snapshot.vertexCount());
+            }
 
-                if (neighbor == sink) {
-                    isPathFound = true;
+            if (current == endVertex) {
+                isTargetSettled = true;
+            } else {
+                for (int edge = snapshot.outBegin(current); edge < snapshot.outEnd(current); ++edge) {
+                    int neighbor = snapshot.target(edge);
+                    int alternative = distances[current] + snapshot.weight(edge);
+                    if (!settled[neighbor] && alternative < distances[neighbor]) {
+                        distances[neighbor] = alternative;
+                        previous[neighbor] = current;
+                        heap.push(neighbor, alternative);
+                    }
                 }
             }
-
-            neighborIndex++;
         }
     }
 
-    return isPathFound;
+    return isCancelled;
 }
 
-int GraphAlgorithms::calculatePathFlow(Vertex* source, Vertex* sink, const QMap<Vertex*, Vertex*>& parent,
-                                      QMap<Vertex*, QMap<Vertex*, int>>& residual){
-    int pathFlow = std::numeric_limits<int>::max();
-    Vertex* current = sink;
-    bool isFlowCalculationComplete = false;
-
-    while (!isFlowCalculationComplete) {
-        Vertex* prev = parent[current];
-        if (prev) {
-            pathFlow = std::min(pathFlow, residual[prev][current]);
-            current = prev;
-        } else {
-            isFlowCalculationComplete = true;
+void GraphAlgorithms::buildDijkstraResult(const GraphSnapshot& snapshot, int endVertex,
+                                          const QVector<int>& distances, const QVector<int>& previous,
+                                          ShortestPathResult& result){
+    if (distances[endVertex] == std::numeric_limits<int>::max()) {
+        result.status = AlgorithmStatus::NoPath;
+    } else {
+        QVector<int> path;
+        for (int current = endVertex; current >= 0; current = previous[current]) {
+            path.append(current);
         }
-    }
+        std::reverse(path.begin(), path.end());
 
-    return pathFlow;
-}
-
-void GraphAlgorithms::updateResidualNetwork(Vertex* source, Vertex* sink, int pathFlow,
-                                          const QMap<Vertex*, Vertex*>& parent,
-                                          QMap<Vertex*, QMap<Vertex*, int>>& residual){
-    Vertex* current = sink;
-    bool isNetworkUpdateComplete = false;
-
-    while (!isNetworkUpdateComplete) {
-        Vertex* prev = parent[current];
-        if (prev) {
-            residual[prev][current] -= pathFlow;
-            residual[current][prev] += pathFlow;
-            current = prev;
-        } else {
-            isNetworkUpdateComplete = true;
-        }
+        result.distance = distances[endVertex];
+        result.path = toVertexIds(snapshot, path);
+        result.edgeIds = pathEdgeIds(snapshot, path);
     }
 }
 
 
 
-QString GraphAlgorithms::stronglyConnectedComponents(Graph* graph)
-{
-    QString result = "";
+MaxFlowResult GraphAlgorithms::maxFlow(Graph* graph, int sourceId, int sinkId, MaxFlow::Method method){
+    MaxFlowResult result;
 
     if (!graph) {
-        result = "Graph is not initialized.";
-        return result;
+        result.status = AlgorithmStatus::GraphNotInitialized;
+        result.sourceId = sourceId;
+        result.sinkId = sinkId;
+    } else {
+        result = maxFlow(graph->snapshot(), sourceId, sinkId, method);
     }
 
-    if (graph->vertexCount() == 0) {
-        result = "Graph is empty. No vertices for SCC analysis.";
+    return result;
+}
+
+MaxFlowResult GraphAlgorithms::maxFlow(const GraphSnapshot& snapshot, int sourceId, int sinkId,
+                                       MaxFlow::Method method, AlgorithmProgress* progress){
+    MaxFlowResult result;
+    result.sourceId = sourceId;
+    result.sinkId = sinkId;
+
+    int source = -1;
+    int sink = -1;
+
+    result.status = validateEndpoints(snapshot, sourceId, sinkId, source, sink);
+    if (!result.isOk()) {
         return result;
     }
 
-    QSet<Vertex*> visited;
-    QStack<Vertex*> finishOrder;
+    MaxFlow engine(snapshot, progress);
+    MaxFlow::Result flow = engine.run(source, sink, method);
 
-    for (Vertex* vertex : graph->vertices()) {
-        if (!visited.contains(vertex)) {
-            kosarajuDFSFirstPass(vertex, visited, finishOrder);
-        }
+    if (flow.isCancelled) {
+        result.status = AlgorithmStatus::Cancelled;
+    } else {
+        buildMaxFlowResult(snapshot, flow, result);
     }
+    return result;
+}
 
-    Graph* transposedGraph = transposeGraph(graph);
-
-    visited.clear();
-    QVector<QVector<Vertex*>> components;
+void GraphAlgorithms::buildMaxFlowResult(const GraphSnapshot& snapshot, const MaxFlow::Result& flow,
+                                         MaxFlowResult& result){
+    result.value = flow.value;
+    result.edges.resize(snapshot.edgeCount());
 
-    while (!finishOrder.isEmpty()) {
-        Vertex* vertex = finishOrder.pop();
-        Vertex* transposedVertex = transposedGraph->getVertexById(vertex->id());
+    for (int edge = 0; edge < snapshot.edgeCount(); ++edge) {
+        int from = snapshot.source(edge);
+        int to = snapshot.target(edge);
 
-        if (!visited.contains(transposedVertex)) {
-            QVector<Vertex*> component;
-            kosarajuDFSSecondPass(transposedVertex, visited, component);
-            components.append(component);
-        }
+        FlowEdge &flowEdge = result.edges[edge];
+        flowEdge.edgeId = snapshot.edgeId(edge);
+        flowEdge.fromId = snapshot.vertexId(from);
+        flowEdge.toId = snapshot.vertexId(to);
+        flowEdge.capacity = snapshot.weight(edge);
+        flowEdge.flow = flow.edgeFlows[edge];
+        flowEdge.crossesCut = flow.sourceSide[from] && !flow.sourceSide[to];
     }
+}
+
+
 
-    result = "Strongly Connected Components:\n";
-    if (components.isEmpty()) {
-        result += "No strongly connected components found.";
+// A graph that tracks its components is answered from them without any
+// traversal.
+ComponentsResult GraphAlgorithms::stronglyConnectedComponents(Graph* graph)
+{
+    ComponentsResult result;
+
+    if (!graph) {
+        result.status = AlgorithmStatus::GraphNotInitialized;
+    } else if (!graph->strongComponents()) {
+        result = stronglyConnectedComponents(graph->snapshot());
+    } else if (graph->vertexCount() == 0) {
+        result.status = AlgorithmStatus::EmptyGraph;
     } else {
-        for (int i = 0; i < components.size(); ++i) {
-            result += "Component " + QString::number(i + 1) + " (" +
-                     QString::number(components[i].size()) + " vertices): ";
-
-            for (int j = 0; j < components[i].size(); ++j) {
-                result += QString::number(components[i][j]->id());
-                if (j < components[i].size() - 1) {
-                    result += " → ";
-                }
-            }
-            result += "\n";
-        }
-        result += "Total: " + QString::number(components.size()) + " components";
+        result = trackedComponents(*graph);
     }
 
-    delete transposedGraph;
     return result;
 }
 
-void GraphAlgorithms::kosarajuDFSFirstPass(Vertex* vertex, QSet<Vertex*>& visited, QStack<Vertex*>& finishOrder)
+// Same layout as the snapshot overload: components in topological order of
+// the condensation, componentOf indexed like Graph::vertices().
+ComponentsResult GraphAlgorithms::trackedComponents(const Graph& graph)
 {
-    visited.insert(vertex);
+    const DynamicComponents &tracked = *graph.strongComponents();
+    QVector<int> order = tracked.topologicalOrder();
+    QHash<int, int> positionOf;
+    ComponentsResult result;
 
-    for (Vertex* neighbor : vertex->outNeighbors()) {
-        if (!visited.contains(neighbor)) {
-            kosarajuDFSFirstPass(neighbor, visited, finishOrder);
+    positionOf.reserve(order.size());
+    result.components.reserve(order.size());
+    for (int component : order) {
+        QVector<int> memberIds;
+        memberIds.reserve(tracked.members(component).size());
+        for (const Vertex *member : tracked.members(component)) {
+            memberIds.append(member->id());
         }
+        positionOf.insert(component, result.components.size());
+        result.components.append(memberIds);
     }
 
-    finishOrder.push(vertex);
+    result.vertexIds.reserve(graph.vertexCount());
+    result.componentOf.reserve(graph.vertexCount());
+    for (const Vertex *vertex : graph.vertices()) {
+        result.vertexIds.append(vertex->id());
+        result.componentOf.append(positionOf.value(tracked.componentOf(vertex), -1));
+    }
+
+    return result;
 }
 
-void GraphAlgorithms::kosarajuDFSSecondPass(Vertex* vertex, QSet<Vertex*>& visited, QVector<Vertex*>& component)
+ComponentsResult GraphAlgorithms::stronglyConnectedComponents(const GraphSnapshot& snapshot, AlgorithmProgress* progress)
 {
-    visited.insert(vertex);
-    component.append(vertex);
+    ComponentsResult result;
 
-    for (Vertex* neighbor : vertex->outNeighbors()) {
-        if (!visited.contains(neighbor)) {
-            kosarajuDFSSecondPass(neighbor, visited, component);
-        }
+    if (snapshot.vertexCount() == 0) {
+        result.status = AlgorithmStatus::EmptyGraph;
+        return result;
     }
-}
 
-Graph* GraphAlgorithms::transposeGraph(Graph* graph)
-{
-    Graph* transposed = new Graph();
+    QVector<QVector<int>> components;
+    if (!tarjanComponents(snapshot, components, progress)) {
+        result.status = AlgorithmStatus::Cancelled;
+        return result;
+    }
 
-    for (Vertex* vertex : graph->vertices()) {
-        transposed->addVertex(vertex->position());
+    result.vertexIds.reserve(snapshot.vertexCount());
+    for (int vertex = 0; vertex < snapshot.vertexCount(); ++vertex) {
+        result.vertexIds.append(snapshot.vertexId(vertex));
     }
 
-    for (Edge* edge : graph->edges()) {
-        Vertex* from = transposed->getVertexById(edge->to()->id());
-        Vertex* to = transposed->getVertexById(edge->from()->id());
-        if (from && to) {
-            transposed->addEdge(from, to);
+    result.componentOf.fill(-1, snapshot.vertexCount());
+    result.components.reserve(components.size());
+    for (int i = 0; i < components.size(); ++i) {
+        for (int vertex : components[i]) {
+            result.componentOf[vertex] = i;
         }
+        result.components.append(toVertexIds(snapshot, components[i]));
     }
 
-    return transposed;
+    return result;
 }
 
-
-QString GraphAlgorithms::eulerianPath(Graph* graph)
+// Iterative Tarjan. Components are found sinks-first, so the list is
+// reversed to report them in topological order of the condensation.
+bool GraphAlgorithms::tarjanComponents(const GraphSnapshot& snapshot, QVector<QVector<int>>& components,
+                                       AlgorithmProgress* progress)
 {
-    QString result = "";
+    int vertexCount = snapshot.vertexCount();
+    QVector<int> index(vertexCount, -1);
+    QVector<int> lowLink(vertexCount, 0);
+    QVector<bool> onStack(vertexCount, false);
+    QVector<int> componentStack;
+    QVector<int> callStack;
+    QVector<int> nextEdge;
+    int counter = 0;
+    bool isCancelled = false;
+
+    for (int root = 0; root < vertexCount && !isCancelled; ++root) {
+        if (index[root] < 0) {
+            index[root] = lowLink[root] = counter++;
+            componentStack.append(root);
+            onStack[root] = true;
+            callStack.append(root);
+            nextEdge.append(snapshot.outBegin(root));
+
+            while (!callStack.isEmpty() && !isCancelled) {
+                int vertex = callStack.last();
+
+                if (nextEdge.last() < snapshot.outEnd(vertex)) {
+                    int neighbor = snapshot.target(nextEdge.last()++);
+
+                    if (index[neighbor] < 0) {
+                        index[neighbor] = lowLink[neighbor] = counter++;
+                        componentStack.append(neighbor);
+                        onStack[neighbor] = true;
+                        callStack.append(neighbor);
+                        nextEdge.append(snapshot.outBegin(neighbor));
+
+                        if (counter % AlgorithmProgress::CHECK_INTERVAL == 0) {
+                            isCancelled = AlgorithmProgress::checkpoint(progress, counter, vertexCount);
+                        }
+                    } else if (onStack[neighbor]) {
+                        lowLink[vertex] = std::min(lowLink[vertex], index[neighbor]);
+                    }
+                } else {
+                    callStack.removeLast();
+                    nextEdge.removeLast();
+
+                    if (lowLink[vertex] == index[vertex]) {
+                        int start = componentStack.lastIndexOf(vertex);
+                        QVector<int> component(componentStack.begin() + start, componentStack.end());
+                        for (int member : component) {
+                            onStack[member] = false;
+                        }
+                        componentStack.resize(start);
+                        components.append(component);
+                    }
 
-    if (!graph) {
-        result = "Graph is not initialized.";
-        return result;
+                    if (!callStack.isEmpty()) {
+                        int parent = callStack.last();
+                        lowLink[parent] = std::min(lowLink[parent], lowLink[vertex]);
+                    }
+                }
+            }
+        }
     }
 
-    if (graph->vertexCount() == 0) {
-        result = "Graph is empty. No vertices for Eulerian path.";
-        return result;
-    }
+    std::reverse(components.begin(), components.end());
+    return !isCancelled;
+}
 
-    Vertex* startVertex = nullptr;
-    Vertex* endVertex = nullptr;
 
-    bool hasEulerianPath = hasEulerianPathConditions(graph, startVertex, endVertex);
+VertexSequenceResult GraphAlgorithms::eulerianPath(Graph* graph)
+{
+    VertexSequenceResult result;
 
-    if (!hasEulerianPath) {
-        result = "Graph does not satisfy conditions for Eulerian path.";
-        return result;
+    if (!graph) {
+        result.status = AlgorithmStatus::GraphNotInitialized;
+    } else {
+        result = eulerianPath(graph->snapshot());
     }
 
-    if (!startVertex) {
-        startVertex = findEulerianStartVertex(graph);
-    }
+    return result;
+}
 
-    if (!startVertex) {
-        result = "Cannot find start vertex for Eulerian path.";
-        return result;
-    }
+VertexSequenceResult GraphAlgorithms::eulerianPath(const GraphSnapshot& snapshot)
+{
+    VertexSequenceResult result;
 
-    QMap<Vertex*, QList<Vertex*>> availableEdges;
-    for (Vertex* vertex : graph->vertices()) {
-        availableEdges[vertex] = vertex->outNeighbors().values();
+    if (snapshot.vertexCount() == 0) {
+        result.status = AlgorithmStatus::EmptyGraph;
+    } else {
+        result = eulerianTrail(snapshot, EulerianTrail::Kind::Path);
     }
 
-    QVector<Vertex*> path;
-    QStack<Vertex*> stack;
-    stack.push(startVertex);
-
-    while (!stack.isEmpty()) {
-        Vertex* current = stack.top();
-
-        if (!availableEdges[current].isEmpty()) {
-            Vertex* next = availableEdges[current].first();
-            availableEdges[current].removeFirst();
-            stack.push(next);
-        } else {
-            path.append(current);
-            stack.pop();
-        }
-    }
+    return result;
+}
 
-    QVector<Vertex*> eulerPath;
-    for (int i = path.size() - 1; i >= 0; --i) {
-        eulerPath.append(path[i]);
-    }
+DegreesResult GraphAlgorithms::vertexDegrees(Graph* graph)
+{
+    DegreesResult result;
 
-    result = "Eulerian Path found:\n";
-    for (int i = 0; i < eulerPath.size(); ++i) {
-        result += QString::number(eulerPath[i]->id());
-        if (i < eulerPath.size() - 1) {
-            result += " → ";
-        }
+    if (!graph) {
+        result.status = AlgorithmStatus::GraphNotInitialized;
+    } else {
+        result = vertexDegrees(graph->snapshot());
     }
 
     return result;
 }
 
-bool GraphAlgorithms::hasEulerianPathConditions(Graph* graph, Vertex*& startVertex, Vertex*& endVertex)
+DegreesResult GraphAlgorithms::vertexDegrees(const GraphSnapshot& snapshot)
 {
-    int startCount = 0;
-    int endCount = 0;
-
-    for (Vertex* vertex : graph->vertices()) {
-        int outDegree = vertex->outDegree();
-        int inDegree = vertex->inDegree();
-
-        if (outDegree - inDegree == 1) {
-            startCount++;
-            startVertex = vertex;
-        } else if (inDegree - outDegree == 1) {
-            endCount++;
-            endVertex = vertex;
-        } else if (inDegree != outDegree) {
-            return false;
-        }
+    DegreesResult result;
+
+    if (snapshot.vertexCount() == 0) {
+        result.status = AlgorithmStatus::EmptyGraph;
+        return result;
     }
 
-    bool isValid = (startCount == 0 && endCount == 0) || (startCount == 1 && endCount == 1);
-    return isValid;
+    result.degrees.resize(snapshot.vertexCount());
+    for (int vertex = 0; vertex < snapshot.vertexCount(); ++vertex) {
+        VertexDegree &degree = result.degrees[vertex];
+        degree.vertexId = snapshot.vertexId(vertex);
+        degree.inDegree = snapshot.inDegree(vertex);
+        degree.outDegree = snapshot.outDegree(vertex);
+    }
+
+    return result;
 }
 
-Vertex* GraphAlgorithms::findEulerianStartVertex(Graph* graph)
+ReachabilityResult GraphAlgorithms::reachability(Graph* graph, const QVector<int>& sourceIds,
+                                                 MultiSourcePaths::Metric metric)
 {
-    Vertex* startVertex = nullptr;
+    ReachabilityResult result;
 
-    for (Vertex* vertex : graph->vertices()) {
-        if (vertex->outDegree() > 0) {
-            startVertex = vertex;
-            break;
-        }
+    if (!graph) {
+        result.status = AlgorithmStatus::GraphNotInitialized;
+    } else {
+        result = reachability(graph->snapshot(), sourceIds, metric);
     }
 
-    return startVertex;
+    return result;
 }
 
-QString GraphAlgorithms::vertexDegrees(Graph* graph)
+ReachabilityResult GraphAlgorithms::reachability(const GraphSnapshot& snapshot, const QVector<int>& sourceIds,
+                                                 MultiSourcePaths::Metric metric, AlgorithmProgress* progress)
 {
-    QString result = "";
+    ReachabilityResult result;
 
-    if (!graph) {
-        result = "Graph is not initialized.";
+    if (snapshot.vertexCount() == 0) {
+        result.status = AlgorithmStatus::EmptyGraph;
         return result;
     }
 
-    if (graph->vertexCount() == 0) {
-        result = "Graph is empty. No vertices for degree analysis.";
-        return result;
+    QVector<int> sources;
+    if (sourceIds.isEmpty()) {
+        sources.resize(snapshot.vertexCount());
+        for (int vertex = 0; vertex < snapshot.vertexCount(); ++vertex) {
+            sources[vertex] = vertex;
+        }
+    } else {
+        sources.reserve(sourceIds.size());
+        for (int i = 0; i < sourceIds.size() && result.isOk(); ++i) {
+            int vertex = snapshot.indexOf(sourceIds[i]);
+            if (vertex < 0) {
+                result.status = AlgorithmStatus::StartVertexNotFound;
+            } else {
+                sources.append(vertex);
+            }
+        }
     }
 
-    result = "Vertex degrees:\n";
+    if (!result.isOk()) {
+        return result;
+    }
 
-    for (Vertex* vertex : graph->vertices()) {
-        int inDegree = vertex->inDegree();
-        int outDegree = vertex->outDegree();
-        int totalDegree = inDegree + outDegree;
+    // Every source owns its own slot, so workers never write to the same one.
+    result.sources.resize(sources.size());
+    MultiSourcePaths paths(snapshot);
+    bool isCompleted = paths.run(sources, metric,
+        [&snapshot, &sources, &result](int sourceIndex, const QVector<int>& distances, const QVector<int>& reached) {
+            SourceReach &reach = result.sources[sourceIndex];
+            reach.sourceId = snapshot.vertexId(sources[sourceIndex]);
+            reach.reachedCount = reached.size();
+            for (int vertex : reached) {
+                reach.distanceSum += distances[vertex];
+                reach.eccentricity = qMax(reach.eccentricity, distances[vertex]);
+            }
+        }, progress);
 
-        result += "Vertex " + QString::number(vertex->id()) + ": ";
-        result += "in=" + QString::number(inDegree) + ", ";
-        result += "out=" + QString::number(outDegree) + ", ";
-        result += "total=" + QString::number(totalDegree) + "\n";
+    if (!isCompleted) {
+        result.status = AlgorithmStatus::Cancelled;
+        result.sources.clear();
     }
 
     return result;
-}
\ No newline at end of file
+}
@@ -2,59 +2,103 @@
 #define GRAPHALGORITHMS_H
 
 #include "Graph.h"
-#include <QString>
+#include "GraphSnapshot.h"
+#include "MaxFlow.h"
+#include "MultiSourcePaths.h"
+#include "PointToPointSearch.h"
+#include "ContractionHierarchy.h"
+#include "EulerianTrail.h"
+#include "AlgorithmResults.h"
+#include "AlgorithmProgress.h"
 
 class GraphAlgorithms
 {
 public:
-    static QString topologicalSort(Graph* graph);
-    static QString eulerianCycle(Graph* graph);
-    static QString dijkstra(Graph* graph, int startVertexId, int endVertexId);
-    static QString maxFlow(Graph* graph, int sourceId, int sinkId);
-    static QString stronglyConnectedComponents(Graph* graph);
-    static QString eulerianPath(Graph* graph);
-    static QString vertexDegrees(Graph* graph);
+    enum class PriorityQueueKind { DaryHeap, RadixHeap };
+
+    static VertexSequenceResult topologicalSort(Graph* graph);
+    static VertexSequenceResult eulerianCycle(Graph* graph);
+    static ShortestPathResult dijkstra(Graph* graph, int startVertexId, int endVertexId,
+                                       PriorityQueueKind queueKind = PriorityQueueKind::RadixHeap);
+    static ShortestPathResult shortestPath(Graph* graph, int startVertexId, int endVertexId,
+                                           PointToPointSearch::Method method = PointToPointSearch::Method::Bidirectional);
+    static MaxFlowResult maxFlow(Graph* graph, int sourceId, int sinkId,
+                                 MaxFlow::Method method = MaxFlow::Method::Dinic);
+    static ComponentsResult stronglyConnectedComponents(Graph* graph);
+    static VertexSequenceResult eulerianPath(Graph* graph);
+    static DegreesResult vertexDegrees(Graph* graph);
+    static ReachabilityResult reachability(Graph* graph, const QVector<int>& sourceIds,
+                                           MultiSourcePaths::Metric metric = MultiSourcePaths::Metric::Hops);
+
+    // Snapshot overloads, safe to run on a worker thread. The long-running
+    // ones poll progress and return AlgorithmStatus::Cancelled when asked to stop.
+    static VertexSequenceResult topologicalSort(const GraphSnapshot& snapshot);
+    // Isolated vertices do not count against an Eulerian cycle or path.
+    // EulerianTrail gives the same trail as a sequence of edge slots.
+    static VertexSequenceResult eulerianCycle(const GraphSnapshot& snapshot);
+    static ShortestPathResult dijkstra(const GraphSnapshot& snapshot, int startVertexId, int endVertexId,
+                                       PriorityQueueKind queueKind = PriorityQueueKind::RadixHeap,
+                                       AlgorithmProgress* progress = nullptr);
+    // Same answer as dijkstra, found by a search that stops early. Graphs
+    // with negative weights fall back to dijkstra with the d-ary heap.
+    static ShortestPathResult shortestPath(const GraphSnapshot& snapshot, int startVertexId, int endVertexId,
+                                           PointToPointSearch::Method method = PointToPointSearch::Method::Bidirectional,
+                                           AlgorithmProgress* progress = nullptr);
+    // The same with an engine built once for the snapshot, so that repeated
+    // queries reuse its arrays and landmark tables.
+    static ShortestPathResult shortestPath(PointToPointSearch& search, int startVertexId, int endVertexId,
+                                           PointToPointSearch::Method method = PointToPointSearch::Method::Bidirectional,
+                                           AlgorithmProgress* progress = nullptr);
+    // Same answer again, from a prebuilt contraction hierarchy. The query
+    // keeps its scratch between calls, so each one takes microseconds.
+    static ShortestPathResult shortestPath(ContractionHierarchy::Query& query, int startVertexId, int endVertexId);
+    static MaxFlowResult maxFlow(const GraphSnapshot& snapshot, int sourceId, int sinkId,
+                                 MaxFlow::Method method = MaxFlow::Method::Dinic,
+                                 AlgorithmProgress* progress = nullptr);
+    static ComponentsResult stronglyConnectedComponents(const GraphSnapshot& snapshot,
+                                                        AlgorithmProgress* progress = nullptr);
+    static VertexSequenceResult eulerianPath(const GraphSnapshot& snapshot);
+    static DegreesResult vertexDegrees(const GraphSnapshot& snapshot);
+    // Searches from every listed vertex, or from all vertices when sourceIds
+    // is empty, spreading the sources over all cores.
+    static ReachabilityResult reachability(const GraphSnapshot& snapshot, const QVector<int>& sourceIds,
+                                           MultiSourcePaths::Metric metric = MultiSourcePaths::Metric::Hops,
+                                           AlgorithmProgress* progress = nullptr);
 private:
-    static bool hasCycleDFS(Vertex* vertex, QSet<Vertex*>& visited, QSet<Vertex*>& recursionStack);
-    static bool isWeaklyConnected(Graph* graph);
-    static void topologicalSortDFS(Vertex* vertex, QSet<Vertex*>& visited, QVector<Vertex*>& result);
-    static bool hasEulerianCycleConditions(Graph* graph);
-    static void eulerianDFS(Vertex* vertex, QVector<Vertex*>& path, QMap<Vertex*, QList<Vertex*>>& availableEdges);
-    static QString validateGraph(Graph* graph);
-
-    static QString validateDijkstraInput(Graph* graph, int startVertexId, int endVertexId,
-                                        Vertex*& startVertex, Vertex*& endVertex);
-    static void initializeDijkstra(Graph* graph, QMap<Vertex*, int>& distances,
-                                  QMap<Vertex*, Vertex*>& previous, QSet<Vertex*>& unvisited,
-                                  Vertex* startVertex);
-    static Vertex* findMinDistanceVertex(const QSet<Vertex*>& unvisited, const QMap<Vertex*, int>& distances);
-    static void updateNeighborDistances(Vertex* current, Graph* graph, QMap<Vertex*, int>& distances,
-                                      QMap<Vertex*, Vertex*>& previous, const QSet<Vertex*>& unvisited);
-    static QString buildDijkstraResult(Vertex* startVertex, Vertex* endVertex,
-                                      const QMap<Vertex*, int>& distances, const QMap<Vertex*, Vertex*>& previous);
-
-    static QString validateMaxFlowInput(Graph* graph, int sourceId, int sinkId,
-                                       Vertex*& source, Vertex*& sink);
-    static void initializeResidualNetwork(Graph* graph, QMap<Vertex*, QMap<Vertex*, int>>& residual);
-    static bool findAugmentingPathBFS(Vertex* source, Vertex* sink,
-                                     const QMap<Vertex*, QMap<Vertex*, int>>& residual,
-                                     QMap<Vertex*, Vertex*>& parent);
-    static int calculatePathFlow(Vertex* source, Vertex* sink, const QMap<Vertex*, Vertex*>& parent,
-                                QMap<Vertex*, QMap<Vertex*, int>>& residual);
-    static void updateResidualNetwork(Vertex* source, Vertex* sink, int pathFlow,
-                                     const QMap<Vertex*, Vertex*>& parent,
-                                     QMap<Vertex*, QMap<Vertex*, int>>& residual);
-
-
-    static void kosarajuDFSFirstPass(Vertex* vertex, QSet<Vertex*>& visited, QStack<Vertex*>& finishOrder);
-    static void kosarajuDFSSecondPass(Vertex* vertex, QSet<Vertex*>& visited, QVector<Vertex*>& component);
-    static Graph* transposeGraph(Graph* graph);
-    static bool hasEulerianPathConditions(Graph* graph, Vertex*& startVertex, Vertex*& endVertex);
-    static Vertex* findEulerianStartVertex(Graph* graph);
+    static bool hasCycleDFS(const GraphSnapshot& snapshot, int vertex, QVector<bool>& visited, QVector<bool>& recursionStack);
+    static bool isWeaklyConnected(const GraphSnapshot& snapshot);
+    static void topologicalSortDFS(const GraphSnapshot& snapshot, int vertex, QVector<bool>& visited, QVector<int>& result);
+    static VertexSequenceResult eulerianTrail(const GraphSnapshot& snapshot, EulerianTrail::Kind kind);
+    static AlgorithmStatus validateGraph(const GraphSnapshot& snapshot);
+    static QVector<int> toVertexIds(const GraphSnapshot& snapshot, const QVector<int>& vertices);
+    static QVector<int> pathEdgeIds(const GraphSnapshot& snapshot, const QVector<int>& vertices);
+
+    static AlgorithmStatus validateEndpoints(const GraphSnapshot& snapshot, int startVertexId, int endVertexId,
+                                             int& startVertex, int& endVertex);
+    static void initializeDijkstra(const GraphSnapshot& snapshot, QVector<int>& distances,
+                                  QVector<int>& previous, QVector<bool>& settled, int startVertex);
+    static bool hasNegativeWeights(const GraphSnapshot& snapshot);
+    static bool dijkstraWithDaryHeap(const GraphSnapshot& snapshot, int startVertex, int endVertex,
+                                    QVector<int>& distances, QVector<int>& previous, QVector<bool>& settled,
+                                    AlgorithmProgress* progress);
+    static bool dijkstraWithRadixHeap(const GraphSnapshot& snapshot, int startVertex, int endVertex,
+                                     QVector<int>& distances, QVector<int>& previous, QVector<bool>& settled,
+                                     AlgorithmProgress* progress);
+    static void buildDijkstraResult(const GraphSnapshot& snapshot, int endVertex,
+                                    const QVector<int>& distances, const QVector<int>& previous,
+                                    ShortestPathResult& result);
+
+    static void buildMaxFlowResult(const GraphSnapshot& snapshot, const MaxFlow::Result& flow,
+                                   MaxFlowResult& result);
+
+
+    static ComponentsResult trackedComponents(const Graph& graph);
+    static bool tarjanComponents(const GraphSnapshot& snapshot, QVector<QVector<int>>& components,
+                                 AlgorithmProgress* progress);
 
 };
 
 
 
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,498 @@
+#include "GraphCli.h"
+#include "Graph.h"
+#include "GraphFile.h"
+#include "ResultFormatter.h"
+#include <QCommandLineParser>
+#include <QScopedPointer>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QTextStream>
+#include <algorithm>
+
+int GraphCli::run(const QStringList &arguments)
+{
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    Options options;
+    QString message;
+    if (!parseArguments(arguments, options, message)) {
+        err << message << Qt::endl;
+        return UsageError;
+    }
+    if (options.filename.isEmpty()) {
+        out << message;
+        return Success;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    GraphSnapshot snapshot;
+    QString loadError;
+    if (!loadSnapshot(options, snapshot, loadError)) {
+        err << "Failed to load graph from: " << options.filename;
+        if (!loadError.isEmpty()) {
+            err << ": " << loadError;
+        }
+        err << Qt::endl;
+        return LoadError;
+    }
+    double loadMs = timer.nsecsElapsed() / 1e6;
+
+    // Preprocessing is timed apart from the runs it is meant to speed up.
+    ContractionHierarchy hierarchy;
+    QScopedPointer<ContractionHierarchy::Query> query;
+    bool isHierarchySearch = options.isHierarchySearch && options.algorithm == "shortest-path";
+    HierarchySource hierarchySource = HierarchySource::Unavailable;
+    double preprocessMs = 0.0;
+    if (isHierarchySearch) {
+        timer.start();
+        hierarchySource = prepareHierarchy(options.filename, snapshot, hierarchy);
+        preprocessMs = timer.nsecsElapsed() / 1e6;
+        if (hierarchySource != HierarchySource::Unavailable) {
+            query.reset(new ContractionHierarchy::Query(hierarchy));
+        }
+    }
+
+    // Without a hierarchy, one search engine serves every run, with its
+    // landmark tables built here rather than in the first run. It also
+    // stands in when the hierarchy could not be built; its preprocessing
+    // then adds to the failed attempt's.
+    QScopedPointer<PointToPointSearch> search;
+    if (!query && options.algorithm == "shortest-path") {
+        timer.start();
+        search.reset(new PointToPointSearch(snapshot));
+        search->prepare(options.searchMethod);
+        preprocessMs += timer.nsecsElapsed() / 1e6;
+    }
+
+    Outcome outcome;
+    QJsonArray runTimes;
+    double totalMs = 0.0;
+    double minMs = 0.0;
+    bool isKnownAlgorithm = true;
+
+    for (int i = 0; i < options.repeat && isKnownAlgorithm; ++i) {
+        double runMs = 0.0;
+        isKnownAlgorithm = runAlgorithm(snapshot, options, query.data(), search.data(), outcome, runMs);
+
+        runTimes.append(runMs);
+        totalMs += runMs;
+        minMs = (i == 0) ? runMs : std::min(minMs, runMs);
+    }
+
+    if (!isKnownAlgorithm) {
+        err << "Unknown algorithm: " << options.algorithm << Qt::endl;
+        return UsageError;
+    }
+
+    double meanMs = totalMs / options.repeat;
+
+    if (options.isJson) {
+        QJsonObject timings;
+        timings["loadMs"] = loadMs;
+        if (query || search) {
+            timings["preprocessMs"] = preprocessMs;
+        }
+        if (isHierarchySearch) {
+            timings["hierarchy"] = (hierarchySource == HierarchySource::Loaded) ? "loaded"
+                                   : (hierarchySource == HierarchySource::Saved) ? "built"
+                                   : (hierarchySource == HierarchySource::NotSaved) ? "built-unsaved"
+                                                                                    : "unavailable";
+        }
+        timings["runMs"] = runTimes;
+        timings["minRunMs"] = minMs;
+        timings["meanRunMs"] = meanMs;
+
+        QJsonObject report;
+        report["file"] = options.filename;
+        report["algorithm"] = options.algorithm;
+        report["vertices"] = snapshot.vertexCount();
+        report["edges"] = snapshot.edgeCount();
+        report["status"] = statusName(outcome.status);
+        report["message"] = outcome.text;
+        report["result"] = outcome.json;
+        report["timings"] = timings;
+
+        out << QJsonDocument(report).toJson(QJsonDocument::Indented);
+    } else {
+        out << outcome.text << "\n\n";
+        out << "Vertices: " << snapshot.vertexCount() << ", edges: " << snapshot.edgeCount() << "\n";
+        out << "Load: " << QString::number(loadMs, 'f', 3) << " ms\n";
+        QString hierarchyFilename = ContractionHierarchy::fileNameFor(options.filename);
+        QString hierarchyNote;
+        if (hierarchySource == HierarchySource::Loaded) {
+            hierarchyNote = " (loaded " + hierarchyFilename + ")";
+        } else if (hierarchySource == HierarchySource::Saved) {
+            hierarchyNote = " (built, saved to " + hierarchyFilename + ")";
+        } else if (hierarchySource == HierarchySource::NotSaved) {
+            hierarchyNote = " (built, could not save " + hierarchyFilename + ")";
+        } else {
+            hierarchyNote = " (no hierarchy for negative weights, searched without one)";
+        }
+        if (query || search) {
+            out << "Preprocess: " << QString::number(preprocessMs, 'f', 3) << " ms"
+                << (isHierarchySearch ? hierarchyNote : QString()) << "\n";
+        }
+        out << "Run: min " << QString::number(minMs, 'f', 3) << " ms, mean "
+            << QString::number(meanMs, 'f', 3) << " ms over " << options.repeat << " run(s)\n";
+    }
+
+    return outcome.status == AlgorithmStatus::Ok ? Success : AlgorithmFailed;
+}
+
+// On success with an empty filename, message holds the help text.
+bool GraphCli::parseArguments(const QStringList &arguments, Options &options, QString &message)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Runs UltimateGraph algorithms on .graph files and edge lists.");
+    parser.addPositionalArgument("file", "Graph file or edge list to load.");
+    parser.addPositionalArgument("algorithm",
+        "topological-sort, eulerian-cycle, eulerian-path, dijkstra, shortest-path, max-flow, scc, degrees or reachability.");
+
+    QCommandLineOption helpOption(QStringList() << "h" << "help", "Show this help.");
+    QCommandLineOption fromOption(QStringList() << "f" << "from", "Start or source vertex id.", "id");
+    QCommandLineOption toOption(QStringList() << "t" << "to", "End or sink vertex id.", "id");
+    QCommandLineOption methodOption("method", "Max-flow method: dinic or push-relabel.", "method", "dinic");
+    QCommandLineOption queueOption("queue", "Dijkstra queue: radix or dary.", "queue", "radix");
+    QCommandLineOption searchOption("search", "Shortest-path search: bidirectional, astar, landmarks or hierarchy.",
+                                    "search", "bidirectional");
+    QCommandLineOption metricOption("metric", "Reachability distances: hops or weights.", "metric", "hops");
+    QCommandLineOption repeatOption(QStringList() << "r" << "repeat", "Run the algorithm this many times.", "count", "1");
+    QCommandLineOption jsonOption("json", "Print a JSON report instead of text.");
+    QCommandLineOption formatOption("format",
+        "Edge list format: snap, mtx, dimacs or csv; auto picks it from the extension.", "format", "auto");
+    parser.addOption(helpOption);
+    parser.addOption(fromOption);
+    parser.addOption(toOption);
+    parser.addOption(methodOption);
+    parser.addOption(queueOption);
+    parser.addOption(searchOption);
+    parser.addOption(metricOption);
+    parser.addOption(repeatOption);
+    parser.addOption(jsonOption);
+    parser.addOption(formatOption);
+
+    bool isValid = parser.parse(arguments);
+    if (!isValid) {
+        message = parser.errorText();
+    } else if (parser.isSet(helpOption)) {
+        message = parser.helpText();
+    } else if (parser.positionalArguments().size() != 2) {
+        message = "Expected a graph file and an algorithm name. Use --help for usage.";
+        isValid = false;
+    } else {
+        bool isFromValid = true;
+        bool isToValid = true;
+        bool isRepeatValid = true;
+
+        options.filename = parser.positionalArguments().at(0);
+        options.algorithm = parser.positionalArguments().at(1);
+        options.fromId = parser.isSet(fromOption) ? parser.value(fromOption).toInt(&isFromValid) : -1;
+        options.toId = parser.isSet(toOption) ? parser.value(toOption).toInt(&isToValid) : -1;
+        options.repeat = parser.value(repeatOption).toInt(&isRepeatValid);
+        options.isJson = parser.isSet(jsonOption);
+
+        QString method = parser.value(methodOption);
+        QString queue = parser.value(queueOption);
+        QString search = parser.value(searchOption);
+        QString metric = parser.value(metricOption);
+        QString format = parser.value(formatOption);
+        options.flowMethod = (method == "push-relabel") ? MaxFlow::Method::PushRelabel : MaxFlow::Method::Dinic;
+        options.queueKind = (queue == "dary") ? GraphAlgorithms::PriorityQueueKind::DaryHeap
+                                              : GraphAlgorithms::PriorityQueueKind::RadixHeap;
+        options.searchMethod = (search == "astar") ? PointToPointSearch::Method::AStar
+                             : (search == "landmarks") ? PointToPointSearch::Method::Landmarks
+                                                       : PointToPointSearch::Method::Bidirectional;
+        options.isHierarchySearch = (search == "hierarchy");
+        options.metric = (metric == "weights") ? MultiSourcePaths::Metric::Weights : MultiSourcePaths::Metric::Hops;
+        options.edgeListFormat = (format == "mtx") ? EdgeListImporter::Format::MatrixMarket
+                               : (format == "dimacs") ? EdgeListImporter::Format::Dimacs
+                               : (format == "csv") ? EdgeListImporter::Format::Csv
+                                                   : EdgeListImporter::Format::Snap;
+        options.isEdgeList = (format == "auto") ? EdgeListImporter::formatFor(options.filename, options.edgeListFormat)
+                                                : true;
+
+        if (!isFromValid || !isToValid) {
+            message = "Vertex ids must be integers.";
+            isValid = false;
+        } else if (!isRepeatValid || options.repeat < 1) {
+            message = "--repeat expects a positive integer.";
+            isValid = false;
+        } else if (method != "dinic" && method != "push-relabel") {
+            message = "Unknown max-flow method: " + method;
+            isValid = false;
+        } else if (queue != "radix" && queue != "dary") {
+            message = "Unknown Dijkstra queue: " + queue;
+            isValid = false;
+        } else if (search != "bidirectional" && search != "astar" && search != "landmarks" && search != "hierarchy") {
+            message = "Unknown shortest-path search: " + search;
+            isValid = false;
+        } else if (metric != "hops" && metric != "weights") {
+            message = "Unknown reachability metric: " + metric;
+            isValid = false;
+        } else if (format != "auto" && format != "snap" && format != "mtx" && format != "dimacs" && format != "csv") {
+            message = "Unknown edge list format: " + format;
+            isValid = false;
+        }
+    }
+
+    return isValid;
+}
+
+// Versioned files and edge lists go straight into a snapshot; legacy files
+// are read through Graph.
+bool GraphCli::loadSnapshot(const Options &options, GraphSnapshot &snapshot, QString &error)
+{
+    const QString &filename = options.filename;
+    bool isLoadSuccessful = false;
+
+    if (GraphFile::isGraphFile(filename)) {
+        isLoadSuccessful = GraphFile::read(filename, snapshot);
+    } else if (options.isEdgeList) {
+        EdgeListImporter importer;
+        isLoadSuccessful = importer.read(filename, options.edgeListFormat, snapshot);
+        error = importer.errorString();
+    } else {
+        Graph graph;
+        isLoadSuccessful = graph.loadFromFile(filename);
+        if (isLoadSuccessful) {
+            snapshot = graph.snapshot();
+        }
+    }
+
+    return isLoadSuccessful;
+}
+
+// Uses the hierarchy saved next to the file when it still matches the
+// graph; otherwise builds one and tries to save it there for the next run.
+GraphCli::HierarchySource GraphCli::prepareHierarchy(const QString &filename, const GraphSnapshot &snapshot,
+                                                     ContractionHierarchy &hierarchy)
+{
+    QString hierarchyFilename = ContractionHierarchy::fileNameFor(filename);
+    HierarchySource source = HierarchySource::Loaded;
+
+    if (!hierarchy.read(hierarchyFilename) || !hierarchy.matches(snapshot)) {
+        if (!hierarchy.build(snapshot)) {
+            source = HierarchySource::Unavailable;
+        } else if (hierarchy.write(hierarchyFilename)) {
+            source = HierarchySource::Saved;
+        } else {
+            source = HierarchySource::NotSaved;
+        }
+    }
+
+    return source;
+}
+
+// runMs covers the algorithm alone, not formatting. With a query the
+// shortest path comes from its contraction hierarchy, otherwise from search.
+bool GraphCli::runAlgorithm(const GraphSnapshot &snapshot, const Options &options,
+                            ContractionHierarchy::Query *query, PointToPointSearch *search,
+                            Outcome &outcome, double &runMs)
+{
+    bool isKnown = true;
+    const QString &name = options.algorithm;
+    QElapsedTimer timer;
+    auto timed = [&timer, &runMs](auto algorithm) {
+        timer.start();
+        auto result = algorithm();
+        runMs = timer.nsecsElapsed() / 1e6;
+        return result;
+    };
+
+    if (name == "topological-sort") {
+        VertexSequenceResult result = timed([&] { return GraphAlgorithms::topologicalSort(snapshot); });
+        outcome.status = result.status;
+        outcome.text = ResultFormatter::topologicalSort(result);
+        outcome.json = toJson(result);
+    } else if (name == "eulerian-cycle") {
+        VertexSequenceResult result = timed([&] { return GraphAlgorithms::eulerianCycle(snapshot); });
+        outcome.status = result.status;
+        outcome.text = ResultFormatter::eulerianCycle(result);
+        outcome.json = toJson(result);
+    } else if (name == "eulerian-path") {
+        VertexSequenceResult result = timed([&] { return GraphAlgorithms::eulerianPath(snapshot); });
+        outcome.status = result.status;
+        outcome.text = ResultFormatter::eulerianPath(result);
+        outcome.json = toJson(result);
+    } else if (name == "dijkstra") {
+        ShortestPathResult result = timed([&] {
+            return GraphAlgorithms::dijkstra(snapshot, options.fromId, options.toId, options.queueKind);
+        });
+        outcome.status = result.status;
+        outcome.text = ResultFormatter::dijkstra(result);
+        outcome.json = toJson(result);
+    } else if (name == "shortest-path") {
+        ShortestPathResult result = timed([&] {
+            return query ? GraphAlgorithms::shortestPath(*query, options.fromId, options.toId)
+                         : GraphAlgorithms::shortestPath(*search, options.fromId, options.toId, options.searchMethod);
+        });
+        outcome.status = result.status;
+        outcome.text = ResultFormatter::dijkstra(result);
+        outcome.json = toJson(result);
+    } else if (name == "max-flow") {
+        MaxFlowResult result = timed([&] {
+            return GraphAlgorithms::maxFlow(snapshot, options.fromId, options.toId, options.flowMethod);
+        });
+        outcome.status = result.status;
+        outcome.text = ResultFormatter::maxFlow(result);
+        outcome.json = toJson(result);
+    } else if (name == "scc") {
+        ComponentsResult result = timed([&] { return GraphAlgorithms::stronglyConnectedComponents(snapshot); });
+        outcome.status = result.status;
+        outcome.text = ResultFormatter::stronglyConnectedComponents(result);
+        outcome.json = toJson(result);
+    } else if (name == "degrees") {
+        DegreesResult result = timed([&] { return GraphAlgorithms::vertexDegrees(snapshot); });
+        outcome.status = result.status;
+        outcome.text = ResultFormatter::vertexDegrees(result);
+        outcome.json = toJson(result);
+    } else if (name == "reachability") {
+        // Without --from every vertex is a source.
+        QVector<int> sourceIds;
+        if (options.fromId >= 0) {
+            sourceIds.append(options.fromId);
+        }
+        ReachabilityResult result = timed([&] {
+            return GraphAlgorithms::reachability(snapshot, sourceIds, options.metric);
+        });
+        outcome.status = result.status;
+        outcome.text = ResultFormatter::reachability(result);
+        outcome.json = toJson(result);
+    } else {
+        isKnown = false;
+    }
+
+    return isKnown;
+}
+
+QString GraphCli::statusName(AlgorithmStatus status)
+{
+    QString name = "";
+
+    switch (status) {
+    case AlgorithmStatus::Ok: name = "ok"; break;
+    case AlgorithmStatus::GraphNotInitialized: name = "graph-not-initialized"; break;
+    case AlgorithmStatus::EmptyGraph: name = "empty-graph"; break;
+    case AlgorithmStatus::NotWeaklyConnected: name = "not-weakly-connected"; break;
+    case AlgorithmStatus::ContainsCycle: name = "contains-cycle"; break;
+    case AlgorithmStatus::ConditionsNotMet: name = "conditions-not-met"; break;
+    case AlgorithmStatus::NoEdges: name = "no-edges"; break;
+    case AlgorithmStatus::StartVertexNotFound: name = "start-vertex-not-found"; break;
+    case AlgorithmStatus::EndVertexNotFound: name = "end-vertex-not-found"; break;
+    case AlgorithmStatus::SameEndpoints: name = "same-endpoints"; break;
+    case AlgorithmStatus::NoPath: name = "no-path"; break;
+    case AlgorithmStatus::Cancelled: name = "cancelled"; break;
+    }
+
+    return name;
+}
+
+static QJsonArray toJsonArray(const QVector<int> &values)
+{
+    QJsonArray array;
+    for (int value : values) {
+        array.append(value);
+    }
+    return array;
+}
+
+QJsonObject GraphCli::toJson(const VertexSequenceResult &result)
+{
+    QJsonObject json;
+    json["vertices"] = toJsonArray(result.vertexIds);
+    if (!result.edgeIds.isEmpty()) {
+        json["edges"] = toJsonArray(result.edgeIds);
+    }
+    return json;
+}
+
+QJsonObject GraphCli::toJson(const ShortestPathResult &result)
+{
+    QJsonObject json;
+    json["from"] = result.startId;
+    json["to"] = result.endId;
+    if (result.isOk()) {
+        json["distance"] = result.distance;
+        json["path"] = toJsonArray(result.path);
+        if (!result.edgeIds.isEmpty()) {
+            json["edges"] = toJsonArray(result.edgeIds);
+        }
+    }
+    return json;
+}
+
+// Only edges that carry flow or cross the minimum cut are listed.
+QJsonObject GraphCli::toJson(const MaxFlowResult &result)
+{
+    QJsonObject json;
+    json["source"] = result.sourceId;
+    json["sink"] = result.sinkId;
+
+    if (result.isOk()) {
+        QJsonArray edges;
+        for (const FlowEdge &edge : result.edges) {
+            if (edge.flow > 0 || edge.crossesCut) {
+                QJsonObject entry;
+                entry["id"] = edge.edgeId;
+                entry["from"] = edge.fromId;
+                entry["to"] = edge.toId;
+                entry["capacity"] = edge.capacity;
+                entry["flow"] = edge.flow;
+                entry["cut"] = edge.crossesCut;
+                edges.append(entry);
+            }
+        }
+        json["value"] = result.value;
+        json["edges"] = edges;
+    }
+    return json;
+}
+
+QJsonObject GraphCli::toJson(const ComponentsResult &result)
+{
+    QJsonArray components;
+    for (const QVector<int> &component : result.components) {
+        components.append(toJsonArray(component));
+    }
+
+    QJsonObject json;
+    json["count"] = static_cast<int>(result.components.size());
+    json["components"] = components;
+    return json;
+}
+
+QJsonObject GraphCli::toJson(const DegreesResult &result)
+{
+    QJsonArray degrees;
+    for (const VertexDegree &degree : result.degrees) {
+        QJsonObject entry;
+        entry["id"] = degree.vertexId;
+        entry["in"] = degree.inDegree;
+        entry["out"] = degree.outDegree;
+        degrees.append(entry);
+    }
+
+    QJsonObject json;
+    json["degrees"] = degrees;
+    return json;
+}
+
+QJsonObject GraphCli::toJson(const ReachabilityResult &result)
+{
+    QJsonArray sources;
+    for (const SourceReach &reach : result.sources) {
+        QJsonObject entry;
+        entry["id"] = reach.sourceId;
+        entry["reached"] = reach.reachedCount;
+        entry["eccentricity"] = reach.eccentricity;
+        entry["distanceSum"] = reach.distanceSum;
+        sources.append(entry);
+    }
+
+    QJsonObject json;
+    json["sources"] = sources;
+    return json;
+}
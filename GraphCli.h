@@ -0,0 +1,63 @@
+#ifndef GRAPHCLI_H
+#define GRAPHCLI_H
+
+#include "EdgeListImporter.h"
+#include "GraphAlgorithms.h"
+#include <QJsonObject>
+#include <QStringList>
+
+// Headless front end for ultimategraph-cli: loads a .graph file or a text
+// edge list, runs one algorithm a given number of times and prints the
+// result with timings, either as the output-pane text or as a JSON object.
+class GraphCli
+{
+public:
+    enum ExitCode { Success = 0, AlgorithmFailed = 1, UsageError = 2, LoadError = 3 };
+
+    static int run(const QStringList &arguments);
+
+private:
+    // Where the hierarchy for --search hierarchy came from. Unavailable means
+    // it could not be built, as for negative weights.
+    enum class HierarchySource { Loaded, Saved, NotSaved, Unavailable };
+
+    struct Options {
+        QString filename;
+        QString algorithm;
+        bool isEdgeList = false;
+        EdgeListImporter::Format edgeListFormat = EdgeListImporter::Format::Snap;
+        int fromId = -1;
+        int toId = -1;
+        MaxFlow::Method flowMethod = MaxFlow::Method::Dinic;
+        GraphAlgorithms::PriorityQueueKind queueKind = GraphAlgorithms::PriorityQueueKind::RadixHeap;
+        MultiSourcePaths::Metric metric = MultiSourcePaths::Metric::Hops;
+        PointToPointSearch::Method searchMethod = PointToPointSearch::Method::Bidirectional;
+        bool isHierarchySearch = false;
+        int repeat = 1;
+        bool isJson = false;
+    };
+
+    struct Outcome {
+        AlgorithmStatus status = AlgorithmStatus::Ok;
+        QString text;
+        QJsonObject json;
+    };
+
+    static bool parseArguments(const QStringList &arguments, Options &options, QString &message);
+    static bool loadSnapshot(const Options &options, GraphSnapshot &snapshot, QString &error);
+    static HierarchySource prepareHierarchy(const QString &filename, const GraphSnapshot &snapshot,
+                                            ContractionHierarchy &hierarchy);
+    static bool runAlgorithm(const GraphSnapshot &snapshot, const Options &options,
+                             ContractionHierarchy::Query *query, PointToPointSearch *search,
+                             Outcome &outcome, double &runMs);
+
+    static QString statusName(AlgorithmStatus status);
+    static QJsonObject toJson(const VertexSequenceResult &result);
+    static QJsonObject toJson(const ShortestPathResult &result);
+    static QJsonObject toJson(const MaxFlowResult &result);
+    static QJsonObject toJson(const ComponentsResult &result);
+    static QJsonObject toJson(const DegreesResult &result);
+    static QJsonObject toJson(const ReachabilityResult &result);
+};
+
+#endif
@@ -0,0 +1,435 @@
+#include "GraphFile.h"
+#include <QFile>
+#include <QSaveFile>
+#include <QtEndian>
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
+#include <numeric>
+
+namespace {
+
+const char MAGIC[8] = {'U', 'G', 'R', 'A', 'P', 'H', '\r', '\n'};
+const quint16 FORMAT_VERSION = 1;
+const quint16 FLAG_VARINT_EDGES = 0x1;
+const quint16 FLAG_EDGE_IDS = 0x2;
+const int HEADER_SIZE = 64;
+const int VERTEX_RECORD_SIZE = 12;
+
+struct Header {
+    quint16 flags = 0;
+    quint32 vertexCount = 0;
+    quint32 edgeCount = 0;
+    quint64 vertexOffset = 0;
+    quint64 edgeOffset = 0;
+    quint64 edgeBytes = 0;
+    quint64 fileSize = 0;
+    quint32 payloadCrc = 0;
+};
+
+// CRC-32 (IEEE 802.3, reflected), slicing-by-8.
+constexpr std::array<std::array<quint32, 256>, 8> makeCrcTables()
+{
+    std::array<std::array<quint32, 256>, 8> tables{};
+    for (quint32 i = 0; i < 256; ++i) {
+        quint32 crc = i;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+        }
+        tables[0][i] = crc;
+    }
+    for (int slice = 1; slice < 8; ++slice) {
+        for (int i = 0; i < 256; ++i) {
+            quint32 previous = tables[slice - 1][i];
+            tables[slice][i] = (previous >> 8) ^ tables[0][previous & 0xff];
+        }
+    }
+    return tables;
+}
+
+constexpr std::array<std::array<quint32, 256>, 8> CRC_TABLES = makeCrcTables();
+
+quint32 crc32(const uchar *data, qint64 size)
+{
+    quint32 crc = 0xFFFFFFFFu;
+
+    while (size >= 8) {
+        quint32 low = qFromLittleEndian<quint32>(data) ^ crc;
+        quint32 high = qFromLittleEndian<quint32>(data + 4);
+        crc = CRC_TABLES[7][low & 0xff] ^ CRC_TABLES[6][(low >> 8) & 0xff]
+            ^ CRC_TABLES[5][(low >> 16) & 0xff] ^ CRC_TABLES[4][low >> 24]
+            ^ CRC_TABLES[3][high & 0xff] ^ CRC_TABLES[2][(high >> 8) & 0xff]
+            ^ CRC_TABLES[1][(high >> 16) & 0xff] ^ CRC_TABLES[0][high >> 24];
+        data += 8;
+        size -= 8;
+    }
+    while (size-- > 0) {
+        crc = CRC_TABLES[0][(crc ^ *data++) & 0xff] ^ (crc >> 8);
+    }
+
+    return ~crc;
+}
+
+quint32 zigzag(qint32 value)
+{
+    return (static_cast<quint32>(value) << 1) ^ static_cast<quint32>(value >> 31);
+}
+
+qint32 unzigzag(quint32 value)
+{
+    return static_cast<qint32>(value >> 1) ^ -static_cast<qint32>(value & 1);
+}
+
+void appendVarint(QByteArray &buffer, quint32 value)
+{
+    while (value >= 0x80) {
+        buffer.append(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    buffer.append(static_cast<char>(value));
+}
+
+bool readVarint(const uchar *&cursor, const uchar *end, quint32 &value)
+{
+    value = 0;
+    bool isComplete = false;
+
+    for (int shift = 0; shift < 35 && cursor < end && !isComplete; shift += 7) {
+        uchar byte = *cursor++;
+        value |= static_cast<quint32>(byte & 0x7f) << shift;
+        isComplete = (byte & 0x80) == 0;
+    }
+
+    return isComplete;
+}
+
+void appendFixedEdges(QByteArray &buffer, const GraphSnapshot &snapshot)
+{
+    int vertexCount = snapshot.vertexCount();
+    int edgeCount = snapshot.edgeCount();
+    qsizetype offset = buffer.size();
+    buffer.resize(offset + 4 * (vertexCount + 1) + 8 * qsizetype(edgeCount));
+    uchar *cursor = reinterpret_cast<uchar*>(buffer.data()) + offset;
+
+    for (int vertex = 0; vertex < vertexCount; ++vertex) {
+        qToLittleEndian<quint32>(snapshot.outBegin(vertex), cursor);
+        cursor += 4;
+    }
+    qToLittleEndian<quint32>(edgeCount, cursor);
+    cursor += 4;
+
+    for (int edge = 0; edge < edgeCount; ++edge) {
+        qToLittleEndian<quint32>(snapshot.target(edge), cursor);
+        cursor += 4;
+    }
+    for (int edge = 0; edge < edgeCount; ++edge) {
+        qToLittleEndian<qint32>(snapshot.weight(edge), cursor);
+        cursor += 4;
+    }
+}
+
+void appendEdgeIds(QByteArray &buffer, const GraphSnapshot &snapshot, const QVector<int> &order)
+{
+    qsizetype offset = buffer.size();
+    buffer.resize(offset + 4 * qsizetype(order.size()));
+    uchar *cursor = reinterpret_cast<uchar*>(buffer.data()) + offset;
+
+    for (int edge : order) {
+        qToLittleEndian<qint32>(snapshot.edgeId(edge), cursor);
+        cursor += 4;
+    }
+}
+
+// Returns the slots in the order they were written, for the id section.
+QVector<int> appendVarintEdges(QByteArray &buffer, const GraphSnapshot &snapshot)
+{
+    QVector<int> order;
+    order.reserve(snapshot.edgeCount());
+    QVector<int> edges;
+
+    for (int vertex = 0; vertex < snapshot.vertexCount(); ++vertex) {
+        edges.clear();
+        for (int edge = snapshot.outBegin(vertex); edge < snapshot.outEnd(vertex); ++edge) {
+            edges.append(edge);
+        }
+        std::sort(edges.begin(), edges.end(), [&snapshot](int a, int b) {
+            return qMakePair(snapshot.target(a), snapshot.weight(a)) < qMakePair(snapshot.target(b), snapshot.weight(b));
+        });
+
+        appendVarint(buffer, static_cast<quint32>(edges.size()));
+        int previous = vertex;
+        for (int i = 0; i < edges.size(); ++i) {
+            int target = snapshot.target(edges[i]);
+            appendVarint(buffer, i == 0 ? zigzag(target - vertex) : static_cast<quint32>(target - previous));
+            previous = target;
+        }
+        for (int edge : edges) {
+            appendVarint(buffer, zigzag(snapshot.weight(edge)));
+        }
+        order.append(edges);
+    }
+
+    return order;
+}
+
+bool parseHeader(const uchar *data, qint64 size, Header &header)
+{
+    bool isValid = size >= HEADER_SIZE && std::memcmp(data, MAGIC, sizeof(MAGIC)) == 0
+        && qFromLittleEndian<quint32>(data + 60) == crc32(data, 60);
+
+    if (isValid) {
+        quint16 version = qFromLittleEndian<quint16>(data + 8);
+        quint32 headerSize = qFromLittleEndian<quint32>(data + 12);
+        header.flags = qFromLittleEndian<quint16>(data + 10);
+        header.vertexCount = qFromLittleEndian<quint32>(data + 16);
+        header.edgeCount = qFromLittleEndian<quint32>(data + 20);
+        header.vertexOffset = qFromLittleEndian<quint64>(data + 24);
+        header.edgeOffset = qFromLittleEndian<quint64>(data + 32);
+        header.edgeBytes = qFromLittleEndian<quint64>(data + 40);
+        header.fileSize = qFromLittleEndian<quint64>(data + 48);
+        header.payloadCrc = qFromLittleEndian<quint32>(data + 56);
+
+        quint64 maxCount = static_cast<quint64>(std::numeric_limits<int>::max()) / 2;
+        bool isVarint = (header.flags & FLAG_VARINT_EDGES) != 0;
+        quint64 idBytes = (header.flags & FLAG_EDGE_IDS) ? 4 * quint64(header.edgeCount) : 0;
+        quint64 fixedEdgeBytes = 4 * (quint64(header.vertexCount) + 1) + 8 * quint64(header.edgeCount) + idBytes;
+
+        isValid = version == FORMAT_VERSION && headerSize == HEADER_SIZE
+            && (header.flags & ~(FLAG_VARINT_EDGES | FLAG_EDGE_IDS)) == 0
+            && header.vertexCount <= maxCount && header.edgeCount <= maxCount
+            && header.fileSize == static_cast<quint64>(size)
+            && header.vertexOffset == HEADER_SIZE
+            && header.edgeOffset == header.vertexOffset + VERTEX_RECORD_SIZE * quint64(header.vertexCount)
+            && header.edgeOffset <= header.fileSize
+            && header.edgeBytes == header.fileSize - header.edgeOffset
+            && (isVarint ? header.edgeBytes >= idBytes : header.edgeBytes == fixedEdgeBytes);
+    }
+
+    return isValid;
+}
+
+bool decodeFixedEdges(const uchar *data, const Header &header,
+                      QVector<int> &outOffsets, QVector<int> &targets, QVector<int> &weights)
+{
+    int vertexCount = static_cast<int>(header.vertexCount);
+    int edgeCount = static_cast<int>(header.edgeCount);
+    const uchar *offsetData = data + header.edgeOffset;
+    const uchar *targetData = offsetData + 4 * (qsizetype(vertexCount) + 1);
+    const uchar *weightData = targetData + 4 * qsizetype(edgeCount);
+
+    outOffsets.resize(vertexCount + 1);
+    targets.resize(edgeCount);
+    weights.resize(edgeCount);
+    qFromLittleEndian<qint32>(offsetData, vertexCount + 1, outOffsets.data());
+    qFromLittleEndian<qint32>(targetData, edgeCount, targets.data());
+    qFromLittleEndian<qint32>(weightData, edgeCount, weights.data());
+
+    bool isValid = outOffsets.first() == 0 && outOffsets.last() == edgeCount;
+    for (int vertex = 0; vertex < vertexCount && isValid; ++vertex) {
+        isValid = outOffsets[vertex] <= outOffsets[vertex + 1];
+    }
+    for (int edge = 0; edge < edgeCount && isValid; ++edge) {
+        isValid = targets[edge] >= 0 && targets[edge] < vertexCount;
+    }
+
+    return isValid;
+}
+
+bool decodeVarintEdges(const uchar *data, const Header &header,
+                       QVector<int> &outOffsets, QVector<int> &targets, QVector<int> &weights)
+{
+    qint64 vertexCount = header.vertexCount;
+    qint64 edgeCount = header.edgeCount;
+    qint64 idBytes = (header.flags & FLAG_EDGE_IDS) ? 4 * edgeCount : 0;
+    const uchar *cursor = data + header.edgeOffset;
+    const uchar *end = cursor + header.edgeBytes - idBytes;
+
+    outOffsets.resize(vertexCount + 1);
+    targets.resize(edgeCount);
+    weights.resize(edgeCount);
+    outOffsets[0] = 0;
+
+    bool isValid = true;
+    qint64 slot = 0;
+
+    for (qint64 vertex = 0; vertex < vertexCount && isValid; ++vertex) {
+        quint32 degree = 0;
+        isValid = readVarint(cursor, end, degree) && slot + degree <= edgeCount;
+
+        qint64 target = vertex;
+        for (quint32 i = 0; i < degree && isValid; ++i) {
+            quint32 value = 0;
+            isValid = readVarint(cursor, end, value);
+            target += (i == 0) ? unzigzag(value) : static_cast<qint64>(value);
+            isValid = isValid && target >= 0 && target < vertexCount;
+            if (isValid) {
+                targets[slot + i] = static_cast<int>(target);
+            }
+        }
+        for (quint32 i = 0; i < degree && isValid; ++i) {
+            quint32 value = 0;
+            isValid = readVarint(cursor, end, value);
+            weights[slot + i] = unzigzag(value);
+        }
+
+        slot += degree;
+        outOffsets[vertex + 1] = static_cast<int>(slot);
+    }
+
+    return isValid && slot == edgeCount && cursor == end;
+}
+
+bool decode(const uchar *data, qint64 size, GraphSnapshot &snapshot)
+{
+    Header header;
+    bool isValid = parseHeader(data, size, header)
+        && header.payloadCrc == crc32(data + HEADER_SIZE, size - HEADER_SIZE);
+
+    if (isValid) {
+        int vertexCount = static_cast<int>(header.vertexCount);
+        const uchar *idData = data + header.vertexOffset;
+        const uchar *positionData = idData + 4 * qsizetype(vertexCount);
+
+        QVector<int> vertexIds(vertexCount);
+        QVector<int> coordinates(2 * vertexCount);
+        qFromLittleEndian<qint32>(idData, vertexCount, vertexIds.data());
+        qFromLittleEndian<qint32>(positionData, 2 * vertexCount, coordinates.data());
+
+        QVector<int> sortedIds = vertexIds;
+        std::sort(sortedIds.begin(), sortedIds.end());
+        isValid = std::adjacent_find(sortedIds.begin(), sortedIds.end()) == sortedIds.end();
+
+        QVector<QPoint> positions(vertexCount);
+        for (int vertex = 0; vertex < vertexCount; ++vertex) {
+            positions[vertex] = QPoint(coordinates[2 * vertex], coordinates[2 * vertex + 1]);
+        }
+
+        QVector<int> outOffsets;
+        QVector<int> targets;
+        QVector<int> weights;
+        if (isValid) {
+            isValid = (header.flags & FLAG_VARINT_EDGES)
+                ? decodeVarintEdges(data, header, outOffsets, targets, weights)
+                : decodeFixedEdges(data, header, outOffsets, targets, weights);
+        }
+
+        QVector<int> edgeIds;
+        if (isValid && (header.flags & FLAG_EDGE_IDS)) {
+            int edgeCount = static_cast<int>(header.edgeCount);
+            edgeIds.resize(edgeCount);
+            qFromLittleEndian<qint32>(data + header.fileSize - 4 * qsizetype(edgeCount), edgeCount, edgeIds.data());
+        }
+
+        if (isValid) {
+            snapshot = GraphSnapshot(vertexIds, positions, outOffsets, targets, weights, edgeIds);
+        }
+    }
+
+    return isValid;
+}
+
+}
+
+bool GraphFile::write(const GraphSnapshot &snapshot, const QString &filename, Encoding encoding)
+{
+    int vertexCount = snapshot.vertexCount();
+    QByteArray buffer(HEADER_SIZE + VERTEX_RECORD_SIZE * qsizetype(vertexCount), '\0');
+    uchar *vertexData = reinterpret_cast<uchar*>(buffer.data()) + HEADER_SIZE;
+
+    for (int vertex = 0; vertex < vertexCount; ++vertex) {
+        QPoint position = snapshot.position(vertex);
+        qToLittleEndian<qint32>(snapshot.vertexId(vertex), vertexData + 4 * vertex);
+        qToLittleEndian<qint32>(position.x(), vertexData + 4 * (vertexCount + 2 * qsizetype(vertex)));
+        qToLittleEndian<qint32>(position.y(), vertexData + 4 * (vertexCount + 2 * qsizetype(vertex) + 1));
+    }
+
+    qint64 edgeOffset = buffer.size();
+    QVector<int> order;
+    if (encoding == Encoding::Varint) {
+        order = appendVarintEdges(buffer, snapshot);
+    } else {
+        appendFixedEdges(buffer, snapshot);
+    }
+
+    // Ids are left out when the reader would number the edges the same way.
+    quint16 flags = (encoding == Encoding::Varint) ? FLAG_VARINT_EDGES : 0;
+    bool isOrdered = true;
+    for (int i = 0; i < order.size() && isOrdered; ++i) {
+        isOrdered = order[i] == i;
+    }
+    if (!isOrdered || !snapshot.hasSequentialEdgeIds()) {
+        if (order.isEmpty()) {
+            order.resize(snapshot.edgeCount());
+            std::iota(order.begin(), order.end(), 0);
+        }
+        appendEdgeIds(buffer, snapshot, order);
+        flags |= FLAG_EDGE_IDS;
+    }
+
+    uchar *header = reinterpret_cast<uchar*>(buffer.data());
+    std::memcpy(header, MAGIC, sizeof(MAGIC));
+    qToLittleEndian<quint16>(FORMAT_VERSION, header + 8);
+    qToLittleEndian<quint16>(flags, header + 10);
+    qToLittleEndian<quint32>(HEADER_SIZE, header + 12);
+    qToLittleEndian<quint32>(vertexCount, header + 16);
+    qToLittleEndian<quint32>(snapshot.edgeCount(), header + 20);
+    qToLittleEndian<quint64>(HEADER_SIZE, header + 24);
+    qToLittleEndian<quint64>(edgeOffset, header + 32);
+    qToLittleEndian<quint64>(buffer.size() - edgeOffset, header + 40);
+    qToLittleEndian<quint64>(buffer.size(), header + 48);
+    qToLittleEndian<quint32>(crc32(header + HEADER_SIZE, buffer.size() - HEADER_SIZE), header + 56);
+    qToLittleEndian<quint32>(crc32(header, 60), header + 60);
+
+    QSaveFile file(filename);
+    bool isSaveSuccessful = file.open(QIODevice::WriteOnly)
+        && file.write(buffer) == buffer.size()
+        && file.commit();
+
+    return isSaveSuccessful;
+}
+
+// The file is mapped when possible, so a load costs one pass over the bytes
+// for the checksum plus the copies into the snapshot arrays.
+bool GraphFile::read(const QString &filename, GraphSnapshot &snapshot)
+{
+    QFile file(filename);
+    bool isLoadSuccessful = false;
+
+    if (file.open(QIODevice::ReadOnly)) {
+        qint64 size = file.size();
+        const uchar *data = size > 0 ? file.map(0, size) : nullptr;
+        QByteArray contents;
+
+        if (!data) {
+            contents = file.readAll();
+            data = reinterpret_cast<const uchar*>(contents.constData());
+            size = contents.size();
+        }
+
+        isLoadSuccessful = decode(data, size, snapshot);
+        file.close();
+    }
+
+    return isLoadSuccessful;
+}
+
+bool GraphFile::isGraphFile(const QString &filename)
+{
+    QFile file(filename);
+    bool isGraph = false;
+
+    if (file.open(QIODevice::ReadOnly)) {
+        char magic[sizeof(MAGIC)];
+        isGraph = file.read(magic, sizeof(MAGIC)) == sizeof(MAGIC)
+            && std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+        file.close();
+    }
+
+    return isGraph;
+}
+
+quint32 GraphFile::checksum(const uchar *data, qint64 size)
+{
+    return crc32(data, size);
+}
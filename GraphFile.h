@@ -0,0 +1,43 @@
+#ifndef GRAPHFILE_H
+#define GRAPHFILE_H
+
+#include "GraphSnapshot.h"
+#include <QString>
+
+// Binary .graph format, version 1. All integers are little-endian.
+//
+//   0  char[8]  magic "UGRAPH\r\n"
+//   8  quint16  version
+//  10  quint16  flags (bit 0: varint edge section, bit 1: edge ids)
+//  12  quint32  header size (64)
+//  16  quint32  vertex count n
+//  20  quint32  edge count m
+//  24  quint64  vertex section offset
+//  32  quint64  edge section offset
+//  40  quint64  edge section size in bytes
+//  48  quint64  file size
+//  56  quint32  CRC-32 of everything after the header
+//  60  quint32  CRC-32 of bytes 0..59
+//
+// Vertex section: qint32 ids[n], then qint32 (x, y) pairs[n].
+// Fixed edge section: quint32 outOffsets[n + 1], quint32 targets[m],
+// qint32 weights[m], i.e. the forward CSR of a GraphSnapshot.
+// Varint edge section, per vertex v: degree, then targets sorted ascending
+// (the first as zigzag(target - v), the rest as gaps), then the zigzag
+// weights in the same order, all as LEB128 varints.
+// With bit 1 set, the edge section ends with qint32 edgeIds[m] in the order
+// the edges were written; without it, edges are numbered 1..m that way.
+class GraphFile
+{
+public:
+    enum class Encoding { Fixed, Varint };
+
+    static bool write(const GraphSnapshot &snapshot, const QString &filename,
+                      Encoding encoding = Encoding::Fixed);
+    static bool read(const QString &filename, GraphSnapshot &snapshot);
+    static bool isGraphFile(const QString &filename);
+    // The CRC-32 used by the format, for files that sit next to it.
+    static quint32 checksum(const uchar *data, qint64 size);
+};
+
+#endif
@@ -0,0 +1,124 @@
+#include "GraphSnapshot.h"
+#include "Graph.h"
+#include "Vertex.h"
+#include "Edge.h"
+
+GraphSnapshot::GraphSnapshot()
+{
+    m_outOffsets.fill(0, 1);
+    m_inOffsets.fill(0, 1);
+}
+
+GraphSnapshot::GraphSnapshot(const Graph &graph)
+{
+    const QVector<Vertex*> &vertices = graph.vertices();
+    const QVector<Edge*> &edges = graph.edges();
+    int vertexCount = graph.vertexCount();
+    int edgeCount = graph.edgeCount();
+
+    QHash<const Vertex*, int> indexByVertex;
+    indexByVertex.reserve(vertexCount);
+    m_indexById.reserve(vertexCount);
+    m_vertexIds.resize(vertexCount);
+    m_positions.resize(vertexCount);
+
+    for (int i = 0; i < vertexCount; ++i) {
+        Vertex *vertex = vertices[i];
+        m_vertexIds[i] = vertex->id();
+        m_positions[i] = vertex->position();
+        m_indexById.insert(vertex->id(), i);
+        indexByVertex.insert(vertex, i);
+    }
+
+    QVector<int> edgeFrom(edgeCount);
+    m_outOffsets.fill(0, vertexCount + 1);
+
+    for (int i = 0; i < edgeCount; ++i) {
+        edgeFrom[i] = indexByVertex.value(edges[i]->from());
+        m_outOffsets[edgeFrom[i] + 1]++;
+    }
+
+    for (int v = 0; v < vertexCount; ++v) {
+        m_outOffsets[v + 1] += m_outOffsets[v];
+    }
+
+    m_targets.resize(edgeCount);
+    m_weights.resize(edgeCount);
+    m_edgeIds.resize(edgeCount);
+
+    QVector<int> outCursor(m_outOffsets.begin(), m_outOffsets.end() - 1);
+
+    for (int i = 0; i < edgeCount; ++i) {
+        int slot = outCursor[edgeFrom[i]]++;
+        m_targets[slot] = indexByVertex.value(edges[i]->to());
+        m_weights[slot] = edges[i]->weight();
+        m_edgeIds[slot] = edges[i]->id();
+    }
+
+    buildReverse();
+}
+
+GraphSnapshot::GraphSnapshot(const QVector<int> &vertexIds, const QVector<QPoint> &positions,
+                             const QVector<int> &outOffsets, const QVector<int> &targets, const QVector<int> &weights,
+                             const QVector<int> &edgeIds)
+    : m_vertexIds(vertexIds)
+    , m_positions(positions)
+    , m_outOffsets(outOffsets)
+    , m_targets(targets)
+    , m_weights(weights)
+    , m_edgeIds(edgeIds)
+{
+    m_indexById.reserve(m_vertexIds.size());
+    for (int i = 0; i < m_vertexIds.size(); ++i) {
+        m_indexById.insert(m_vertexIds[i], i);
+    }
+
+    if (m_edgeIds.isEmpty()) {
+        m_edgeIds.resize(m_targets.size());
+        for (int edge = 0; edge < m_targets.size(); ++edge) {
+            m_edgeIds[edge] = edge + 1;
+        }
+    }
+
+    buildReverse();
+}
+
+bool GraphSnapshot::hasSequentialEdgeIds() const
+{
+    bool isSequential = true;
+
+    for (int edge = 0; edge < m_edgeIds.size() && isSequential; ++edge) {
+        isSequential = m_edgeIds[edge] == edge + 1;
+    }
+
+    return isSequential;
+}
+
+// Derives edge sources and the incoming CSR from the outgoing one. In-edges
+// of a vertex are listed in slot order.
+void GraphSnapshot::buildReverse()
+{
+    int vertexCount = m_vertexIds.size();
+    int edgeCount = m_targets.size();
+
+    m_sources.resize(edgeCount);
+    m_inOffsets.fill(0, vertexCount + 1);
+
+    for (int v = 0; v < vertexCount; ++v) {
+        for (int slot = m_outOffsets[v]; slot < m_outOffsets[v + 1]; ++slot) {
+            m_sources[slot] = v;
+            m_inOffsets[m_targets[slot] + 1]++;
+        }
+    }
+
+    for (int v = 0; v < vertexCount; ++v) {
+        m_inOffsets[v + 1] += m_inOffsets[v];
+    }
+
+    m_inEdges.resize(edgeCount);
+    QVector<int> inCursor(m_inOffsets.begin(), m_inOffsets.end() - 1);
+
+    for (int slot = 0; slot < edgeCount; ++slot) {
+        m_inEdges[inCursor[m_targets[slot]]++] = slot;
+    }
+}
@@ -0,0 +1,67 @@
+#ifndef GRAPHSNAPSHOT_H
+#define GRAPHSNAPSHOT_H
+
+#include <QVector>
+#include <QHash>
+#include <QPoint>
+
+class Graph;
+
+// Read-only compressed-sparse-row copy of a Graph. Vertices get dense indices
+// 0..n-1 in Graph::vertices() order; outgoing edges of vertex v occupy slots
+// outBegin(v)..outEnd(v)-1, incoming edges inBegin(v)..inEnd(v)-1. Each
+// slot also carries the id of the Graph edge it was taken from.
+class GraphSnapshot
+{
+public:
+    GraphSnapshot();
+    explicit GraphSnapshot(const Graph &graph);
+    // Adopts a forward CSR as stored in a .graph file. The caller guarantees
+    // unique vertex ids, non-decreasing offsets ending at targets.size(), and
+    // targets in 0..n-1. Without edge ids, slot i gets id i + 1.
+    GraphSnapshot(const QVector<int> &vertexIds, const QVector<QPoint> &positions,
+                  const QVector<int> &outOffsets, const QVector<int> &targets, const QVector<int> &weights,
+                  const QVector<int> &edgeIds = QVector<int>());
+
+    int vertexCount() const { return m_vertexIds.size(); }
+    int edgeCount() const { return m_targets.size(); }
+    bool isEmpty() const { return m_vertexIds.isEmpty(); }
+
+    int vertexId(int vertex) const { return m_vertexIds[vertex]; }
+    QPoint position(int vertex) const { return m_positions[vertex]; }
+    int indexOf(int vertexId) const { return m_indexById.value(vertexId, -1); }
+
+    int outBegin(int vertex) const { return m_outOffsets[vertex]; }
+    int outEnd(int vertex) const { return m_outOffsets[vertex + 1]; }
+    int outDegree(int vertex) const { return m_outOffsets[vertex + 1] - m_outOffsets[vertex]; }
+    int source(int edge) const { return m_sources[edge]; }
+    int target(int edge) const { return m_targets[edge]; }
+    int weight(int edge) const { return m_weights[edge]; }
+    int edgeId(int edge) const { return m_edgeIds[edge]; }
+    // Whether edge ids are 1..m in slot order, as files without ids load.
+    bool hasSequentialEdgeIds() const;
+
+    int inBegin(int vertex) const { return m_inOffsets[vertex]; }
+    int inEnd(int vertex) const { return m_inOffsets[vertex + 1]; }
+    int inDegree(int vertex) const { return m_inOffsets[vertex + 1] - m_inOffsets[vertex]; }
+    int inSource(int slot) const { return m_sources[m_inEdges[slot]]; }
+    int inEdge(int slot) const { return m_inEdges[slot]; }
+
+private:
+    void buildReverse();
+
+    QVector<int> m_vertexIds;
+    QVector<QPoint> m_positions;
+    QHash<int, int> m_indexById;
+
+    QVector<int> m_outOffsets;
+    QVector<int> m_sources;
+    QVector<int> m_targets;
+    QVector<int> m_weights;
+    QVector<int> m_edgeIds;
+
+    QVector<int> m_inOffsets;
+    QVector<int> m_inEdges;
+};
+
+#endif
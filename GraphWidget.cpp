@@ -1,9 +1,12 @@
 #include "GraphWidget.h"
 #include <QPainter>
 #include <QMouseEvent>
+#include <QWheelEvent>
 #include <QDebug>
 #include <cmath>
 #include <QInputDialog>
+#include <algorithm>
+#include <tuple>
 
 GraphWidget::GraphWidget(QWidget *parent) : QWidget(parent)
     , m_graph(new Graph())
@@ -15,6 +18,14 @@ GraphWidget::GraphWidget(QWidget *parent) : QWidget(parent)
     m_clickedEdge(nullptr), m_cursorEdge(nullptr)
      , m_isWaitingForWeightInput(false)
    , m_tempWeightInput("")
+    , m_zoom(1.0)
+    , m_pan(0, 0)
+    , m_isPanning(false)
+    , m_staticRevision(0)
+    , m_staticExcludedEdge(nullptr)
+    , m_staticZoom(1.0)
+    , m_layerRevision(0)
+    , m_isLayerSorted(false)
 {
     setMinimumSize(600, 400);
     setMouseTracking(true);
@@ -41,9 +52,73 @@ void GraphWidget::clearGraph()
     m_selectedVertex = nullptr;
     m_clickedVertex = nullptr;
     m_clickedEdge = nullptr;
+    m_cursorVertex = nullptr;
+    m_cursorEdge = nullptr;
+    resetView();
+}
+
+void GraphWidget::setPlaceholderText(const QString &text)
+{
+    if (m_placeholderText != text) {
+        m_placeholderText = text;
+        m_staticLayer = QPixmap();
+        update();
+    }
+}
+
+void GraphWidget::resetView()
+{
+    m_zoom = 1.0;
+    m_pan = QPointF(0, 0);
+    update();
+}
+
+QTransform GraphWidget::viewTransform() const
+{
+    return QTransform(m_zoom, 0, 0, m_zoom, m_pan.x(), m_pan.y());
+}
+
+QPointF GraphWidget::toWorld(const QPointF &screenPoint) const
+{
+    return (screenPoint - m_pan) / m_zoom;
+}
+
+QPointF GraphWidget::toScreen(const QPointF &worldPoint) const
+{
+    return worldPoint * m_zoom + m_pan;
+}
+
+QRect GraphWidget::toScreen(const QRect &worldRect) const
+{
+    return viewTransform().mapRect(QRectF(worldRect)).toAlignedRect().adjusted(-1, -1, 1, 1);
+}
+
+QRect GraphWidget::toWorld(const QRect &screenRect) const
+{
+    return viewTransform().inverted().mapRect(QRectF(screenRect)).toAlignedRect();
+}
+
+// The part of the screen plane the cached layer covers.
+QRect GraphWidget::layerRect() const
+{
+    return rect().adjusted(-LAYER_MARGIN, -LAYER_MARGIN, LAYER_MARGIN, LAYER_MARGIN);
+}
+
+// Keeps the world point under screenPoint fixed while scaling.
+void GraphWidget::zoomAt(const QPointF &screenPoint, double factor)
+{
+    QPointF worldPoint = toWorld(screenPoint);
+    m_zoom = qBound(MIN_ZOOM, m_zoom * factor, MAX_ZOOM);
+    m_pan = screenPoint - worldPoint * m_zoom;
     update();
 }
 
+// Edges stay as easy to hit on screen at any zoom.
+int GraphWidget::edgeHitRadius() const
+{
+    return qMax(1, qRound(EDGE_HIT_RADIUS / m_zoom));
+}
+
 QPointF GraphWidget::calculatePointOnCircle(const QPointF &center, const QPointF &direction, double radius) const
 {
     double length = sqrt(direction.x() * direction.x() + direction.y() * direction.y());
@@ -72,26 +147,270 @@ QPointF GraphWidget::calculateEdgeEndPoint(Vertex *from, Vertex *to) const
     return calculatePointOnCircle(toPos, direction, VERTEX_RADIUS);
 }
 
-void GraphWidget::paintEvent(QPaintEvent *event)
+// Bounds of everything drawn for a vertex, including the selection ring.
+QRect GraphWidget::vertexBounds(Vertex *vertex) const
 {
-    Q_UNUSED(event);
+    int extent = VERTEX_RADIUS + PAINT_MARGIN;
+    QPoint position = vertex->position();
+    return QRect(position.x() - extent, position.y() - extent, 2 * extent + 1, 2 * extent + 1);
+}
 
-    QPainter painter(this);
-    painter.fillRect(rect(), QColor(255, 240, 240));
-    painter.setRenderHint(QPainter::Antialiasing);
+// Bounds of the line, arrow head and weight label of an edge at the widest
+// pen used for highlighting.
+QRect GraphWidget::edgeBounds(Edge *edge) const
+{
+    QPointF startPoint = calculateEdgeStartPoint(edge->from(), edge->to());
+    QPointF endPoint = calculateEdgeEndPoint(edge->from(), edge->to());
+    QPointF labelPosition = (startPoint + endPoint) / 2 - QPointF(0, 10);
+
+    QRectF lineBounds = QRectF(startPoint, endPoint).normalized()
+                            .adjusted(-ARROW_SIZE - PAINT_MARGIN, -ARROW_SIZE - PAINT_MARGIN,
+                                      ARROW_SIZE + PAINT_MARGIN, ARROW_SIZE + PAINT_MARGIN);
+    QRectF labelBounds(labelPosition.x() - PAINT_MARGIN, labelPosition.y() - WEIGHT_LABEL_HEIGHT,
+                       WEIGHT_LABEL_WIDTH, WEIGHT_LABEL_HEIGHT + PAINT_MARGIN);
+
+    return lineBounds.united(labelBounds).toAlignedRect();
+}
+
+void GraphWidget::updateVertex(Vertex *vertex)
+{
+    if (vertex) {
+        update(toScreen(vertexBounds(vertex)));
+    }
+}
+
+void GraphWidget::updateEdge(Edge *edge)
+{
+    if (edge) {
+        update(toScreen(edgeBounds(edge)));
+    }
+}
+
+void GraphWidget::updateIncidentEdges(Vertex *vertex)
+{
+    for (Edge *edge : vertex->outEdges()) {
+        updateEdge(edge);
+    }
+    for (Edge *edge : vertex->inEdges()) {
+        updateEdge(edge);
+    }
+}
+
+void GraphWidget::updateWeightInput()
+{
+    updateEdge(m_clickedEdge);
+    update(QRect(0, 0, width(), WEIGHT_PROMPT_HEIGHT));
+}
+
+// The clicked edge is left out because it is drawn with its own label while
+// a weight is being typed. Zooming always re-renders; panning only once the
+// view leaves the margin.
+bool GraphWidget::isStaticLayerStale() const
+{
+    QPointF shift = m_pan - m_staticPan;
+    return m_staticLayer.size() != layerRect().size() * devicePixelRatioF()
+           || m_staticRevision != m_graph->revision()
+           || m_staticExcludedEdge != m_clickedEdge
+           || m_staticZoom != m_zoom
+           || qAbs(shift.x()) > LAYER_MARGIN || qAbs(shift.y()) > LAYER_MARGIN;
+}
 
-    for (Edge *edge : m_graph->edges()) {
-        if (edge != m_cursorEdge && edge != m_clickedEdge) {
-            drawEdge(painter, edge, Qt::black, 2);
+// Redraws the cached layer. Graphs past MAX_DRAWN_ELEMENTS, such as imported
+// datasets, get a notice instead of their elements, and their edges are
+// never put in the spatial index.
+void GraphWidget::renderStaticLayer()
+{
+    qreal ratio = devicePixelRatioF();
+    QRect layer = layerRect();
+    if (m_staticLayer.size() != layer.size() * ratio) {
+        m_staticLayer = QPixmap(layer.size() * ratio);
+        m_staticLayer.setDevicePixelRatio(ratio);
+    }
+    m_staticLayer.fill(QColor(255, 240, 240));
+
+    QPainter painter(&m_staticLayer);
+    painter.translate(-layer.topLeft());
+
+    if (!m_placeholderText.isEmpty()) {
+        painter.setPen(Qt::darkGray);
+        painter.drawText(rect(), Qt::AlignCenter, m_placeholderText);
+    } else if (m_graph->vertexCount() + m_graph->edgeCount() > MAX_DRAWN_ELEMENTS) {
+        painter.setPen(Qt::darkGray);
+        painter.drawText(rect(), Qt::AlignCenter,
+                         QString("%1 vertices and %2 edges are too many to draw.\nAlgorithms still run on the whole graph.")
+                             .arg(m_graph->vertexCount()).arg(m_graph->edgeCount()));
+    } else {
+        m_graph->indexEdges();
+        drawStaticElements(painter, layer);
+    }
+
+    m_staticRevision = m_graph->revision();
+    m_staticExcludedEdge = m_clickedEdge;
+    m_staticZoom = m_zoom;
+    m_staticPan = m_pan;
+}
+
+// Renders the edges and vertices inside the layer, given in screen
+// coordinates. At full detail they are stacked in id order; denser views
+// drop arrow heads and labels, batch the edges and reduce vertices to points
+// or clusters drawn in screen space.
+void GraphWidget::drawStaticElements(QPainter &painter, const QRect &layer)
+{
+    QRect area = toWorld(layer);
+    collectLayerElements(area);
+
+    switch (detailLevel(layer, m_layerVertices.size() + m_layerEdges.size())) {
+    case FullDetail:
+        sortLayerElements();
+        painter.setRenderHint(QPainter::Antialiasing);
+        painter.setTransform(viewTransform(), true);
+
+        for (Edge *edge : m_layerEdges) {
+            if (edge != m_clickedEdge && edgeBounds(edge).intersects(area)) {
+                drawEdge(painter, edge, Qt::black, 2);
+            }
         }
+        for (Vertex *vertex : m_layerVertices) {
+            drawVertex(painter, vertex);
+        }
+        break;
+
+    case PointDetail:
+        painter.setRenderHint(QPainter::Antialiasing);
+        drawEdgeLines(painter, m_layerEdges, QPen(Qt::black, 1));
+        drawVertexPoints(painter, m_layerVertices);
+        break;
+
+    case ClusterDetail:
+        drawEdgeLines(painter, m_layerEdges, QPen(QColor(0, 0, 0, 40), 1));
+        drawVertexClusters(painter, m_layerVertices, layer);
+        break;
+    }
+}
+
+// Every edit bumps the graph revision, so the pointers stay valid as long
+// as it does not change.
+void GraphWidget::collectLayerElements(const QRect &area)
+{
+    if (m_layerRevision != m_graph->revision() || m_layerArea != area) {
+        int edgeReach = WEIGHT_LABEL_WIDTH + ARROW_SIZE;
+        int vertexReach = VERTEX_RADIUS + PAINT_MARGIN;
+        m_layerEdges = m_graph->edgesIn(area.adjusted(-edgeReach, -edgeReach, edgeReach, edgeReach));
+        m_layerVertices = m_graph->verticesIn(area.adjusted(-vertexReach, -vertexReach, vertexReach, vertexReach));
+        m_layerArea = area;
+        m_layerRevision = m_graph->revision();
+        m_isLayerSorted = false;
+    }
+}
+
+void GraphWidget::sortLayerElements()
+{
+    if (!m_isLayerSorted) {
+        std::sort(m_layerEdges.begin(), m_layerEdges.end(), [](Edge *a, Edge *b) {
+            return std::make_tuple(a->from()->id(), a->to()->id(), a->id())
+                   < std::make_tuple(b->from()->id(), b->to()->id(), b->id());
+        });
+        std::sort(m_layerVertices.begin(), m_layerVertices.end(), [](Vertex *a, Vertex *b) {
+            return a->id() < b->id();
+        });
+        m_isLayerSorted = true;
+    }
+}
+
+GraphWidget::DetailLevel GraphWidget::detailLevel(const QRect &area, int elementCount) const
+{
+    qint64 areaPerElement = static_cast<qint64>(area.width()) * area.height() / qMax(1, elementCount);
+    DetailLevel level = ClusterDetail;
+
+    if (areaPerElement >= DETAIL_AREA_PER_ELEMENT) {
+        level = FullDetail;
+    } else if (areaPerElement >= POINT_AREA_PER_ELEMENT) {
+        level = PointDetail;
     }
 
-    for (Vertex *vertex : m_graph->vertices()) {
-        drawVertex(painter, vertex);
+    return level;
+}
+
+// Centre-to-centre lines in a single call, without arrow heads or labels.
+void GraphWidget::drawEdgeLines(QPainter &painter, const QVector<Edge*> &edges, const QPen &pen)
+{
+    QVector<QLineF> lines;
+    lines.reserve(edges.size());
+
+    for (Edge *edge : edges) {
+        if (edge != m_clickedEdge) {
+            lines.append(QLineF(toScreen(edge->from()->position()), toScreen(edge->to()->position())));
+        }
     }
 
-    if (m_cursorEdge) {
-        drawEdge(painter, m_cursorEdge, QColor(255, 0, 0, 128), 4);
+    painter.setPen(pen);
+    painter.drawLines(lines);
+}
+
+void GraphWidget::drawVertexPoints(QPainter &painter, const QVector<Vertex*> &vertices)
+{
+    QPolygonF points;
+    points.reserve(vertices.size());
+
+    for (Vertex *vertex : vertices) {
+        points.append(toScreen(vertex->position()));
+    }
+
+    painter.setPen(QPen(Qt::darkGray, POINT_SIZE, Qt::SolidLine, Qt::RoundCap));
+    painter.drawPoints(points);
+}
+
+// Bins vertices into CLUSTER_CELL_SIZE squares and shades each occupied
+// square by how many vertices fell into it.
+void GraphWidget::drawVertexClusters(QPainter &painter, const QVector<Vertex*> &vertices, const QRect &area)
+{
+    int columns = area.width() / CLUSTER_CELL_SIZE + 1;
+    int rows = area.height() / CLUSTER_CELL_SIZE + 1;
+    QVector<int> counts(columns * rows, 0);
+
+    for (Vertex *vertex : vertices) {
+        QPoint screenPoint = toScreen(vertex->position()).toPoint();
+        if (area.contains(screenPoint)) {
+            QPoint offset = screenPoint - area.topLeft();
+            counts[(offset.y() / CLUSTER_CELL_SIZE) * columns + offset.x() / CLUSTER_CELL_SIZE]++;
+        }
+    }
+
+    painter.setPen(Qt::NoPen);
+    for (int cell = 0; cell < counts.size(); ++cell) {
+        if (counts[cell] > 0) {
+            int alpha = qMin(255, 80 + 35 * counts[cell]);
+            painter.setBrush(QColor(60, 60, 60, alpha));
+            painter.drawRect(area.left() + (cell % columns) * CLUSTER_CELL_SIZE,
+                             area.top() + (cell / columns) * CLUSTER_CELL_SIZE,
+                             CLUSTER_CELL_SIZE, CLUSTER_CELL_SIZE);
+        }
+    }
+}
+
+// Blits the cached graph for the exposed rectangle and draws hover and
+// selection overlays on top; the graph itself is only redrawn when it
+// changed since the layer was rendered.
+void GraphWidget::paintEvent(QPaintEvent *event)
+{
+    QRect exposed = event->rect();
+
+    if (isStaticLayerStale()) {
+        renderStaticLayer();
+    }
+
+    QPainter painter(this);
+    qreal ratio = m_staticLayer.devicePixelRatio();
+    QPointF origin = QPointF(exposed.topLeft()) - layerRect().topLeft() - (m_pan - m_staticPan);
+    QRectF source(origin * ratio, QSizeF(exposed.size()) * ratio);
+    painter.drawPixmap(QRectF(exposed), m_staticLayer, source);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setTransform(viewTransform());
+
+    // The hovered edge is also in the cached layer; an opaque pen hides the
+    // black line underneath, matching translucent red on the background.
+    if (m_cursorEdge && m_cursorEdge != m_clickedEdge) {
+        drawEdge(painter, m_cursorEdge, QColor(255, 120, 120), 4);
     }
     if (m_clickedEdge) {
         drawEdge(painter, m_clickedEdge, Qt::red, 4);
@@ -113,6 +432,7 @@ void GraphWidget::paintEvent(QPaintEvent *event)
         painter.drawEllipse(m_cursorVertex->position(), VERTEX_RADIUS + 2, VERTEX_RADIUS + 2);
     }
     if (m_isWaitingForWeightInput && m_clickedEdge) {
+        painter.resetTransform();
         painter.setPen(Qt::blue);
         painter.drawText(10, 20, "Enter weight: " + m_tempWeightInput);
     }
@@ -168,11 +488,17 @@ void GraphWidget::drawArrow(QPainter &painter, const QPointF &start, const QPoin
 }
 
 void GraphWidget::mouseMoveEvent(QMouseEvent *event) {
-    QPoint pos = event->pos();
+    QPoint pos = toWorld(event->pos()).toPoint();
 
-    if (m_currentMode == SelectMode) {
+    if (m_isPanning) {
+        m_pan += event->pos() - m_panAnchor;
+        m_panAnchor = event->pos();
+        update();
+    } else if (m_currentMode == SelectMode) {
+        Vertex* previousVertex = m_cursorVertex;
+        Edge* previousEdge = m_cursorEdge;
         Vertex* vertex = m_graph->findVertexAt(pos);
-        Edge* edge = m_graph->findEdgeAt(pos);
+        Edge* edge = m_graph->findEdgeAt(pos, edgeHitRadius());
         if (vertex) {
             m_cursorVertex = vertex;
             m_cursorEdge = nullptr;
@@ -183,37 +509,53 @@ void GraphWidget::mouseMoveEvent(QMouseEvent *event) {
             m_cursorVertex = nullptr;
             m_cursorEdge = nullptr;
         }
-        update();
+
+        if (m_cursorVertex != previousVertex || m_cursorEdge != previousEdge) {
+            updateVertex(previousVertex);
+            updateEdge(previousEdge);
+            updateVertex(m_cursorVertex);
+            updateEdge(m_cursorEdge);
+        }
     }
 }
 
 void GraphWidget::mousePressEvent(QMouseEvent *event) {
-    if (event->button() == Qt::LeftButton) {
-        QPoint pos = event->pos();
+    if (event->button() == Qt::MiddleButton || event->button() == Qt::RightButton) {
+        m_isPanning = true;
+        m_panAnchor = event->pos();
+        setCursor(Qt::ClosedHandCursor);
+    } else if (event->button() == Qt::LeftButton) {
+        QPoint pos = toWorld(event->pos()).toPoint();
 
         switch (m_currentMode) {
         case AddVertexMode:
-            m_graph->addVertex(pos);
-            update();
+            updateVertex(m_graph->addVertex(pos));
             break;
 
         case AddEdgeMode:
+            updateVertex(m_selectedVertex);
             if (Vertex *vertex = m_graph->findVertexAt(pos)) {
                 if (!m_selectedVertex) {
                     m_selectedVertex = vertex;
                 } else if (m_selectedVertex != vertex) {
-                    m_graph->addEdge(m_selectedVertex, vertex);
+                    // Parallel edges would be drawn on top of each other, so
+                    // the editor only adds the first one.
+                    if (!m_graph->areConnected(m_selectedVertex, vertex)) {
+                        updateEdge(m_graph->addEdge(m_selectedVertex, vertex));
+                    }
                     m_selectedVertex = nullptr;
                 }
             } else {
                 m_selectedVertex = nullptr;
             }
-            update();
+            updateVertex(m_selectedVertex);
             break;
 
         case SelectMode:
+            updateVertex(m_clickedVertex);
+            updateEdge(m_clickedEdge);
             Vertex* vertex = m_graph->findVertexAt(pos);
-            Edge* edge = m_graph->findEdgeAt(pos);
+            Edge* edge = m_graph->findEdgeAt(pos, edgeHitRadius());
 
             if (vertex) {
                 m_clickedVertex = vertex;
@@ -225,28 +567,43 @@ void GraphWidget::mousePressEvent(QMouseEvent *event) {
                 m_clickedVertex = nullptr;
                 m_clickedEdge = nullptr;
             }
-            update();
+            updateVertex(m_clickedVertex);
+            updateEdge(m_clickedEdge);
             break;
         }
     }
 }
 
+void GraphWidget::mouseReleaseEvent(QMouseEvent *event) {
+    if (m_isPanning && (event->button() == Qt::MiddleButton || event->button() == Qt::RightButton)) {
+        m_isPanning = false;
+        unsetCursor();
+    }
+}
+
+void GraphWidget::wheelEvent(QWheelEvent *event) {
+    double steps = event->angleDelta().y() / 120.0;
+    zoomAt(event->position(), std::pow(ZOOM_STEP, steps));
+    event->accept();
+}
+
 void GraphWidget::keyPressEvent(QKeyEvent *event) {
     if (m_currentMode == SelectMode && event->key() == Qt::Key_Delete) {
         if (m_clickedVertex) {
+            updateVertex(m_clickedVertex);
+            updateIncidentEdges(m_clickedVertex);
             m_graph->removeVertex(m_clickedVertex);
             if (m_cursorVertex == m_clickedVertex) {
                 m_cursorVertex = nullptr;
             }
             m_clickedVertex = nullptr;
-            update();
         } else if (m_clickedEdge) {
+            updateEdge(m_clickedEdge);
             m_graph->removeEdge(m_clickedEdge);
             if (m_cursorEdge == m_clickedEdge) {
                 m_cursorEdge = nullptr;
             }
             m_clickedEdge = nullptr;
-            update();
         }
     }
     else if (event->key() == Qt::Key_Return) {
@@ -254,31 +611,40 @@ void GraphWidget::keyPressEvent(QKeyEvent *event) {
         if (m_clickedEdge && !m_isWaitingForWeightInput) {
             m_isWaitingForWeightInput = true;
             m_tempWeightInput = "";
-            update();
+            updateWeightInput();
         }
         else if (m_isWaitingForWeightInput) {
             if (!m_tempWeightInput.isEmpty()) {
                 int weight = m_tempWeightInput.toInt();
                 if (weight >= 0) {
-                    m_clickedEdge->setWeight(weight);
+                    m_graph->setEdgeWeight(m_clickedEdge, weight);
                 }
             }
             m_isWaitingForWeightInput = false;
             m_tempWeightInput = "";
-            update();
+            updateWeightInput();
         }
     }
     else if (m_isWaitingForWeightInput) {
         if (event->key() >= Qt::Key_0 && event->key() <= Qt::Key_9) {
             m_tempWeightInput += event->text();
-            update();
+            updateWeightInput();
         }
         else if (event->key() == Qt::Key_Escape) {
             m_isWaitingForWeightInput = false;
             m_tempWeightInput = "";
-            update();
+            updateWeightInput();
         }
     }
+    else if (event->key() == Qt::Key_Plus || event->key() == Qt::Key_Equal) {
+        zoomAt(rect().center(), ZOOM_STEP);
+    }
+    else if (event->key() == Qt::Key_Minus) {
+        zoomAt(rect().center(), 1.0 / ZOOM_STEP);
+    }
+    else if (event->key() == Qt::Key_Home) {
+        resetView();
+    }
 }
 
 void GraphWidget::drawEdgeWeight(QPainter &painter, Edge *edge){
@@ -2,6 +2,8 @@
 #define GRAPHWIDGET_H
 
 #include <QWidget>
+#include <QPixmap>
+#include <QTransform>
 #include "Graph.h"
 #include "Edge.h"
 
@@ -12,11 +14,18 @@ class GraphWidget : public QWidget
 public:
     enum Mode { AddVertexMode, AddEdgeMode, SelectMode };
 
+    // Graphs with more vertices and edges together are not drawn.
+    static const int MAX_DRAWN_ELEMENTS = 1000000;
+
     explicit GraphWidget(QWidget *parent = nullptr);
     ~GraphWidget();
 
     void setMode(Mode mode);
     void clearGraph();
+    void resetView();
+    // Shown instead of the graph while not empty, e.g. for a graph that is
+    // held elsewhere because it is too large to draw.
+    void setPlaceholderText(const QString &text);
     Graph* getGraph() const {
         return m_graph;
     }
@@ -24,9 +33,15 @@ protected:
     void paintEvent(QPaintEvent *event) override;
     void mousePressEvent(QMouseEvent *event) override;
     void mouseMoveEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+    void wheelEvent(QWheelEvent *event) override;
     void keyPressEvent(QKeyEvent *event) override;
 
 private:
+    // Level of detail of the cached layer, chosen from the on-screen area
+    // available per visible vertex or edge.
+    enum DetailLevel { FullDetail, PointDetail, ClusterDetail };
+
     void drawVertex(QPainter &painter, Vertex *vertex);
     void drawEdge(QPainter &painter, Edge *edge, const QColor &color = Qt::black, int width = 2);
     void drawArrow(QPainter &painter, const QPointF &start, const QPointF &end, const QColor &color = Qt::black);
@@ -35,6 +50,31 @@ private:
     QPointF calculateEdgeEndPoint(Vertex *from, Vertex *to) const;
     QPointF calculatePointOnCircle(const QPointF &center, const QPointF &direction, double radius) const;
 
+    QTransform viewTransform() const;
+    QPointF toWorld(const QPointF &screenPoint) const;
+    QPointF toScreen(const QPointF &worldPoint) const;
+    QRect toScreen(const QRect &worldRect) const;
+    QRect toWorld(const QRect &screenRect) const;
+    QRect layerRect() const;
+    void zoomAt(const QPointF &screenPoint, double factor);
+    int edgeHitRadius() const;
+
+    QRect vertexBounds(Vertex *vertex) const;
+    QRect edgeBounds(Edge *edge) const;
+    void updateVertex(Vertex *vertex);
+    void updateEdge(Edge *edge);
+    void updateIncidentEdges(Vertex *vertex);
+    void updateWeightInput();
+    bool isStaticLayerStale() const;
+    void renderStaticLayer();
+    void drawStaticElements(QPainter &painter, const QRect &layer);
+    void collectLayerElements(const QRect &area);
+    void sortLayerElements();
+    DetailLevel detailLevel(const QRect &area, int elementCount) const;
+    void drawEdgeLines(QPainter &painter, const QVector<Edge*> &edges, const QPen &pen);
+    void drawVertexPoints(QPainter &painter, const QVector<Vertex*> &vertices);
+    void drawVertexClusters(QPainter &painter, const QVector<Vertex*> &vertices, const QRect &area);
+
     Vertex *m_clickedVertex;
     Vertex *m_cursorVertex;
     Edge *m_clickedEdge;
@@ -47,9 +87,46 @@ private:
 
     static const int VERTEX_RADIUS = 20;
     static const int ARROW_SIZE = 10;
+    static const int PAINT_MARGIN = 4;
+    static const int WEIGHT_LABEL_WIDTH = 100;
+    static const int WEIGHT_LABEL_HEIGHT = 16;
+    static const int WEIGHT_PROMPT_HEIGHT = 30;
+    static const int DETAIL_AREA_PER_ELEMENT = 400;
+    static const int POINT_AREA_PER_ELEMENT = 16;
+    static const int POINT_SIZE = 4;
+    static const int CLUSTER_CELL_SIZE = 6;
+    static const int LAYER_MARGIN = 256;
+    static const int EDGE_HIT_RADIUS = 5;
+    static constexpr double MIN_ZOOM = 0.02;
+    static constexpr double MAX_ZOOM = 8.0;
+    static constexpr double ZOOM_STEP = 1.15;
 
     bool m_isWaitingForWeightInput;
     QString m_tempWeightInput;
+    QString m_placeholderText;
+
+    // Screen position = world position * m_zoom + m_pan.
+    double m_zoom;
+    QPointF m_pan;
+    bool m_isPanning;
+    QPoint m_panAnchor;
+
+    // The cached layer covers the widget plus LAYER_MARGIN on every side, as
+    // seen at m_staticZoom and m_staticPan; panning within the margin only
+    // moves it.
+    QPixmap m_staticLayer;
+    quint64 m_staticRevision;
+    Edge *m_staticExcludedEdge;
+    double m_staticZoom;
+    QPointF m_staticPan;
+
+    // Elements inside m_layerArea as of m_layerRevision, put in id order the
+    // first time a full-detail render needs it.
+    QVector<Edge*> m_layerEdges;
+    QVector<Vertex*> m_layerVertices;
+    QRect m_layerArea;
+    quint64 m_layerRevision;
+    bool m_isLayerSorted;
 
     void drawEdgeWeight(QPainter &painter, Edge *edge);
 };
@@ -0,0 +1,104 @@
+#include "LayoutRunner.h"
+#include <QtConcurrent/QtConcurrent>
+#include <QElapsedTimer>
+
+LayoutRunner::LayoutRunner(QObject *parent)
+    : QObject(parent)
+    , m_isFramePending(false)
+    , m_generation(0)
+    , m_isDiscarded(false)
+{
+    connect(&m_watcher, &QFutureWatcher<QVector<QPoint>>::progressValueChanged, this, &LayoutRunner::progressChanged);
+    connect(&m_watcher, &QFutureWatcher<QVector<QPoint>>::finished, this, &LayoutRunner::onFinished);
+}
+
+LayoutRunner::~LayoutRunner()
+{
+    if (isRunning()) {
+        m_watcher.disconnect(this);
+        m_watcher.cancel();
+        m_watcher.waitForFinished();
+    }
+}
+
+bool LayoutRunner::isRunning() const
+{
+    return m_watcher.isRunning();
+}
+
+void LayoutRunner::start(const GraphSnapshot &snapshot, const ForceLayout::Settings &settings)
+{
+    if (!isRunning()) {
+        m_vertexIds.resize(snapshot.vertexCount());
+        for (int vertex = 0; vertex < snapshot.vertexCount(); ++vertex) {
+            m_vertexIds[vertex] = snapshot.vertexId(vertex);
+        }
+        m_isFramePending = false;
+        m_isDiscarded = false;
+        int generation = ++m_generation;
+
+        QFuture<QVector<QPoint>> future = QtConcurrent::run([this, snapshot, settings, generation](QPromise<QVector<QPoint>> &promise) {
+            PromiseProgress<QVector<QPoint>> progress(promise);
+            promise.setProgressRange(0, 100);
+
+            ForceLayout layout(snapshot, settings);
+            QElapsedTimer frameTimer;
+            frameTimer.start();
+
+            bool isCompleted = layout.run(&progress, [this, &layout, &frameTimer, generation]() {
+                if (frameTimer.elapsed() >= FRAME_INTERVAL && !m_isFramePending.exchange(true)) {
+                    publish(layout.roundedPositions(), generation);
+                    frameTimer.restart();
+                }
+            });
+
+            if (isCompleted && !promise.isCanceled()) {
+                promise.addResult(layout.roundedPositions());
+            }
+        });
+
+        m_watcher.setFuture(future);
+        emit started();
+    }
+}
+
+void LayoutRunner::cancel()
+{
+    if (isRunning()) {
+        m_watcher.cancel();
+    }
+}
+
+// Blocks until the worker has noticed the cancellation, which happens within
+// one layout iteration.
+void LayoutRunner::cancelAndWait()
+{
+    if (isRunning()) {
+        m_watcher.cancel();
+        m_watcher.waitForFinished();
+    }
+    m_generation++;
+    m_isDiscarded = true;
+}
+
+// Called on the worker thread; the frame is handed to the runner's thread.
+void LayoutRunner::publish(const QVector<QPoint> &positions, int generation)
+{
+    QMetaObject::invokeMethod(this, [this, positions, generation]() {
+        if (generation == m_generation) {
+            emit positionsReady(m_vertexIds, positions);
+        }
+        m_isFramePending = false;
+    }, Qt::QueuedConnection);
+}
+
+// A cancelled layout keeps whatever frame was shown last.
+void LayoutRunner::onFinished()
+{
+    if (m_isDiscarded || m_watcher.isCanceled() || m_watcher.future().resultCount() == 0) {
+        emit cancelled();
+    } else {
+        emit positionsReady(m_vertexIds, m_watcher.result());
+        emit finished();
+    }
+}
@@ -0,0 +1,57 @@
+#ifndef LAYOUTRUNNER_H
+#define LAYOUTRUNNER_H
+
+#include <QObject>
+#include <QFutureWatcher>
+#include <QVector>
+#include <QPoint>
+#include <atomic>
+#include "GraphSnapshot.h"
+#include "ForceLayout.h"
+
+// Runs a ForceLayout in the background against a snapshot taken on the GUI
+// thread. Intermediate positions are published at most every FRAME_INTERVAL
+// milliseconds and only once the previous frame has been delivered, so a
+// slow canvas never queues up stale frames. Before the graph the layout was
+// started on is replaced, cancelAndWait() stops it for good: neither a frame
+// still in the queue nor its final positions are delivered afterwards.
+class LayoutRunner : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit LayoutRunner(QObject *parent = nullptr);
+    ~LayoutRunner();
+
+    bool isRunning() const;
+    void start(const GraphSnapshot &snapshot, const ForceLayout::Settings &settings = ForceLayout::Settings());
+
+public slots:
+    void cancel();
+    void cancelAndWait();
+
+signals:
+    void started();
+    void progressChanged(int percent);
+    void positionsReady(const QVector<int> &vertexIds, const QVector<QPoint> &positions);
+    void finished();
+    void cancelled();
+
+private slots:
+    void onFinished();
+
+private:
+    static const int FRAME_INTERVAL = 100;
+
+    void publish(const QVector<QPoint> &positions, int generation);
+
+    QFutureWatcher<QVector<QPoint>> m_watcher;
+    QVector<int> m_vertexIds;
+    std::atomic<bool> m_isFramePending;
+    // Bumped by start() and cancelAndWait(); frames of an older generation
+    // are dropped on delivery.
+    int m_generation;
+    bool m_isDiscarded;
+};
+
+#endif
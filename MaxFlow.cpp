@@ -0,0 +1,411 @@
+#include "MaxFlow.h"
+#include <limits>
+
+MaxFlow::MaxFlow(const GraphSnapshot &snapshot, AlgorithmProgress *progress)
+    : m_snapshot(snapshot)
+    , m_progress(progress)
+    , m_isCancelled(false)
+    , m_pollCount(0)
+    , m_vertexCount(snapshot.vertexCount())
+    , m_highestActive(-1)
+    , m_highestLabel(0)
+    , m_relabelWork(0)
+    , m_source(-1)
+    , m_sink(-1)
+{
+    int arcCount = 2 * snapshot.edgeCount();
+
+    m_arcOffsets.resize(m_vertexCount + 1);
+    for (int vertex = 0; vertex <= m_vertexCount; ++vertex) {
+        m_arcOffsets[vertex] = (vertex < m_vertexCount)
+            ? snapshot.outBegin(vertex) + snapshot.inBegin(vertex)
+            : arcCount;
+    }
+
+    m_arcTargets.resize(arcCount);
+    m_arcPairs.resize(arcCount);
+    m_capacities.fill(0, arcCount);
+    m_forwardArcs.resize(snapshot.edgeCount());
+
+    // Forward arcs of a vertex come first, then the back arcs of its in-edges.
+    for (int vertex = 0; vertex < m_vertexCount; ++vertex) {
+        for (int edge = snapshot.outBegin(vertex); edge < snapshot.outEnd(vertex); ++edge) {
+            int arc = m_arcOffsets[vertex] + (edge - snapshot.outBegin(vertex));
+            m_arcTargets[arc] = snapshot.target(edge);
+            m_capacities[arc] = std::max(snapshot.weight(edge), 0);
+            m_forwardArcs[edge] = arc;
+        }
+
+        int backArcBase = m_arcOffsets[vertex] + snapshot.outDegree(vertex);
+        for (int slot = snapshot.inBegin(vertex); slot < snapshot.inEnd(vertex); ++slot) {
+            int backArc = backArcBase + (slot - snapshot.inBegin(vertex));
+            int edge = snapshot.inEdge(slot);
+            m_arcTargets[backArc] = snapshot.source(edge);
+        }
+    }
+
+    for (int vertex = 0; vertex < m_vertexCount; ++vertex) {
+        int backArcBase = m_arcOffsets[vertex] + snapshot.outDegree(vertex);
+        for (int slot = snapshot.inBegin(vertex); slot < snapshot.inEnd(vertex); ++slot) {
+            int backArc = backArcBase + (slot - snapshot.inBegin(vertex));
+            int forwardArc = m_forwardArcs[snapshot.inEdge(slot)];
+            m_arcPairs[backArc] = forwardArc;
+            m_arcPairs[forwardArc] = backArc;
+        }
+    }
+}
+
+MaxFlow::Result MaxFlow::run(int source, int sink, Method method)
+{
+    Result result;
+    m_residual = m_capacities;
+    m_source = source;
+    m_sink = sink;
+    m_isCancelled = false;
+    m_pollCount = 0;
+
+    if (method == Method::PushRelabel) {
+        result.value = runPushRelabel(source, sink);
+    } else {
+        result.value = runDinic(source, sink);
+    }
+
+    result.edgeFlows.resize(m_snapshot.edgeCount());
+    for (int edge = 0; edge < m_snapshot.edgeCount(); ++edge) {
+        int arc = m_forwardArcs[edge];
+        result.edgeFlows[edge] = m_capacities[arc] - m_residual[arc];
+    }
+    result.sourceSide = residualReachable(source);
+    result.isCancelled = m_isCancelled;
+
+    return result;
+}
+
+void MaxFlow::augment(int arc, int amount)
+{
+    m_residual[arc] -= amount;
+    m_residual[m_arcPairs[arc]] += amount;
+}
+
+// Polled from the inner loops; only every CHECK_INTERVAL-th call reaches
+// the progress object.
+bool MaxFlow::isCancelled()
+{
+    if (m_progress && !m_isCancelled && ++m_pollCount % AlgorithmProgress::CHECK_INTERVAL == 0) {
+        m_isCancelled = m_progress->isCancelled();
+    }
+    return m_isCancelled;
+}
+
+QVector<bool> MaxFlow::residualReachable(int source) const
+{
+    QVector<bool> reachable(m_vertexCount, false);
+    QVector<int> queue;
+    queue.reserve(m_vertexCount);
+    queue.append(source);
+    reachable[source] = true;
+
+    for (int head = 0; head < queue.size(); ++head) {
+        int current = queue[head];
+        for (int arc = m_arcOffsets[current]; arc < m_arcOffsets[current + 1]; ++arc) {
+            int neighbor = m_arcTargets[arc];
+            if (m_residual[arc] > 0 && !reachable[neighbor]) {
+                reachable[neighbor] = true;
+                queue.append(neighbor);
+            }
+        }
+    }
+
+    return reachable;
+}
+
+qint64 MaxFlow::runDinic(int source, int sink)
+{
+    qint64 totalFlow = 0;
+
+    // The source-sink distance grows every phase and never exceeds n.
+    while (!m_isCancelled && buildLevels(source, sink)) {
+        m_isCancelled = AlgorithmProgress::checkpoint(m_progress, m_levels[sink], m_vertexCount);
+        if (!m_isCancelled) {
+            m_currentArcs = QVector<int>(m_arcOffsets.begin(), m_arcOffsets.end() - 1);
+            totalFlow += blockingFlow(source, sink);
+        }
+    }
+
+    return totalFlow;
+}
+
+bool MaxFlow::buildLevels(int source, int sink)
+{
+    m_levels.fill(-1, m_vertexCount);
+    QVector<int> queue;
+    queue.reserve(m_vertexCount);
+    queue.append(source);
+    m_levels[source] = 0;
+
+    for (int head = 0; head < queue.size() && m_levels[sink] < 0; ++head) {
+        int current = queue[head];
+        for (int arc = m_arcOffsets[current]; arc < m_arcOffsets[current + 1]; ++arc) {
+            int neighbor = m_arcTargets[arc];
+            if (m_residual[arc] > 0 && m_levels[neighbor] < 0) {
+                m_levels[neighbor] = m_levels[current] + 1;
+                queue.append(neighbor);
+            }
+        }
+    }
+
+    return m_levels[sink] >= 0;
+}
+
+// Iterative DFS over the level graph. m_currentArcs only ever moves forward,
+// so every arc is either saturated or skipped at most once per phase.
+qint64 MaxFlow::blockingFlow(int source, int sink)
+{
+    qint64 phaseFlow = 0;
+    QVector<int> path;
+    int current = source;
+    bool isPhaseComplete = false;
+
+    while (!isPhaseComplete && !isCancelled()) {
+        if (current == sink) {
+            int bottleneck = std::numeric_limits<int>::max();
+            for (int arc : path) {
+                bottleneck = std::min(bottleneck, m_residual[arc]);
+            }
+
+            int firstSaturated = -1;
+            for (int i = 0; i < path.size(); ++i) {
+                augment(path[i], bottleneck);
+                if (firstSaturated < 0 && m_residual[path[i]] == 0) {
+                    firstSaturated = i;
+                }
+            }
+            phaseFlow += bottleneck;
+
+            path.resize(firstSaturated);
+            current = path.isEmpty() ? source : m_arcTargets[path.last()];
+        } else {
+            int end = m_arcOffsets[current + 1];
+            int &arc = m_currentArcs[current];
+            while (arc < end && (m_residual[arc] == 0 || m_levels[m_arcTargets[arc]] != m_levels[current] + 1)) {
+                ++arc;
+            }
+
+            if (arc < end) {
+                path.append(arc);
+                current = m_arcTargets[arc];
+            } else if (current == source) {
+                isPhaseComplete = true;
+            } else {
+                m_levels[current] = -1;
+                int deadArc = path.takeLast();
+                current = arcTail(deadArc);
+                m_currentArcs[current]++;
+            }
+        }
+    }
+
+    return phaseFlow;
+}
+
+// Highest-label push-relabel. Phase one pushes a maximum preflow into the sink
+// using heights below n; phase two returns the stranded excess to the source
+// using heights n..2n-1, which turns the preflow into a flow.
+qint64 MaxFlow::runPushRelabel(int source, int sink)
+{
+    int deadHeight = 2 * m_vertexCount;
+    m_heights.fill(deadHeight, m_vertexCount);
+    m_excess.fill(0, m_vertexCount);
+    m_activeByHeight = QVector<QVector<int>>(deadHeight + 1);
+    m_bucketHeads.fill(-1, deadHeight + 1);
+    m_bucketNext.fill(-1, m_vertexCount);
+    m_bucketPrev.fill(-1, m_vertexCount);
+
+    for (int arc = m_arcOffsets[source]; arc < m_arcOffsets[source + 1]; ++arc) {
+        if (m_residual[arc] > 0) {
+            int amount = m_residual[arc];
+            m_excess[source] -= amount;
+            m_excess[m_arcTargets[arc]] += amount;
+            augment(arc, amount);
+        }
+    }
+
+    pushRelabelPhase(sink, 0);
+    qint64 totalFlow = m_excess[sink];
+    m_isCancelled = m_isCancelled || AlgorithmProgress::checkpoint(m_progress, 1, 2);
+    pushRelabelPhase(source, m_vertexCount);
+
+    return totalFlow;
+}
+
+void MaxFlow::pushRelabelPhase(int target, int baseHeight)
+{
+    int globalRelabelThreshold = 6 * m_vertexCount + m_arcTargets.size();
+    globalRelabel(target, baseHeight);
+
+    while (m_highestActive >= 0 && !isCancelled()) {
+        QVector<int> &bucket = m_activeByHeight[m_highestActive];
+
+        if (bucket.isEmpty()) {
+            m_highestActive--;
+        } else {
+            int vertex = bucket.takeLast();
+
+            if (m_excess[vertex] > 0 && m_heights[vertex] == m_highestActive) {
+                discharge(vertex, baseHeight);
+
+                if (m_relabelWork > globalRelabelThreshold) {
+                    globalRelabel(target, baseHeight);
+                }
+            }
+        }
+    }
+}
+
+// Exact distance-to-target labels from a reverse BFS over residual arcs.
+// Vertices that cannot reach the target are parked at the dead height.
+void MaxFlow::globalRelabel(int target, int baseHeight)
+{
+    int deadHeight = 2 * m_vertexCount;
+
+    m_heights.fill(deadHeight);
+    m_bucketHeads.fill(-1);
+    for (QVector<int> &bucket : m_activeByHeight) {
+        bucket.clear();
+    }
+    m_currentArcs = QVector<int>(m_arcOffsets.begin(), m_arcOffsets.end() - 1);
+    m_highestActive = -1;
+    m_highestLabel = 0;
+    m_relabelWork = 0;
+
+    m_heights[m_source] = m_vertexCount;
+    m_heights[m_sink] = 0;
+
+    QVector<int> queue;
+    queue.reserve(m_vertexCount);
+    queue.append(target);
+
+    for (int head = 0; head < queue.size(); ++head) {
+        int current = queue[head];
+        for (int arc = m_arcOffsets[current]; arc < m_arcOffsets[current + 1]; ++arc) {
+            int neighbor = m_arcTargets[arc];
+            if (m_residual[m_arcPairs[arc]] > 0 && m_heights[neighbor] == deadHeight
+                && neighbor != m_source && neighbor != m_sink) {
+                int height = m_heights[current] + 1;
+                if (height < baseHeight + m_vertexCount) {
+                    setHeight(neighbor, height);
+                    queue.append(neighbor);
+                }
+            }
+        }
+    }
+
+    for (int vertex = 0; vertex < m_vertexCount; ++vertex) {
+        if (m_excess[vertex] > 0) {
+            activate(vertex);
+        }
+    }
+}
+
+void MaxFlow::discharge(int vertex, int baseHeight)
+{
+    int deadHeight = 2 * m_vertexCount;
+    int end = m_arcOffsets[vertex + 1];
+
+    while (m_excess[vertex] > 0 && m_heights[vertex] < deadHeight) {
+        int &arc = m_currentArcs[vertex];
+
+        if (arc < end) {
+            int neighbor = m_arcTargets[arc];
+            if (m_residual[arc] > 0 && m_heights[vertex] == m_heights[neighbor] + 1) {
+                push(arc, std::min<qint64>(m_excess[vertex], m_residual[arc]));
+            } else {
+                ++arc;
+            }
+        } else {
+            int oldHeight = m_heights[vertex];
+            int newHeight = deadHeight;
+            for (int candidate = m_arcOffsets[vertex]; candidate < end; ++candidate) {
+                int neighborHeight = m_heights[m_arcTargets[candidate]];
+                if (m_residual[candidate] > 0 && neighborHeight >= baseHeight) {
+                    newHeight = std::min(newHeight, neighborHeight + 1);
+                }
+            }
+            if (newHeight >= baseHeight + m_vertexCount) {
+                newHeight = deadHeight;
+            }
+
+            m_relabelWork += 12 + (end - m_arcOffsets[vertex]);
+            arc = m_arcOffsets[vertex];
+            setHeight(vertex, deadHeight);
+
+            // Gap: nothing is left at oldHeight, so no vertex above it can
+            // reach the target any more.
+            if (m_bucketHeads[oldHeight] < 0) {
+                int gapEnd = std::min(m_highestLabel, baseHeight + m_vertexCount - 1);
+                for (int height = oldHeight + 1; height <= gapEnd; ++height) {
+                    while (m_bucketHeads[height] >= 0) {
+                        setHeight(m_bucketHeads[height], deadHeight);
+                    }
+                }
+            } else {
+                setHeight(vertex, newHeight);
+            }
+        }
+    }
+}
+
+void MaxFlow::push(int arc, qint64 amount)
+{
+    int from = arcTail(arc);
+    int to = m_arcTargets[arc];
+    bool wasActive = m_excess[to] > 0;
+
+    augment(arc, static_cast<int>(amount));
+    m_excess[from] -= amount;
+    m_excess[to] += amount;
+
+    if (!wasActive) {
+        activate(to);
+    }
+}
+
+void MaxFlow::setHeight(int vertex, int height)
+{
+    int deadHeight = 2 * m_vertexCount;
+    int oldHeight = m_heights[vertex];
+
+    if (oldHeight < deadHeight) {
+        int next = m_bucketNext[vertex];
+        int prev = m_bucketPrev[vertex];
+        if (prev >= 0) {
+            m_bucketNext[prev] = next;
+        } else {
+            m_bucketHeads[oldHeight] = next;
+        }
+        if (next >= 0) {
+            m_bucketPrev[next] = prev;
+        }
+    }
+
+    m_heights[vertex] = height;
+
+    if (height < deadHeight) {
+        m_bucketPrev[vertex] = -1;
+        m_bucketNext[vertex] = m_bucketHeads[height];
+        if (m_bucketHeads[height] >= 0) {
+            m_bucketPrev[m_bucketHeads[height]] = vertex;
+        }
+        m_bucketHeads[height] = vertex;
+        m_highestLabel = std::max(m_highestLabel, height);
+    }
+}
+
+void MaxFlow::activate(int vertex)
+{
+    int height = m_heights[vertex];
+    if (vertex != m_source && vertex != m_sink && height < 2 * m_vertexCount) {
+        m_activeByHeight[height].append(vertex);
+        m_highestActive = std::max(m_highestActive, height);
+    }
+}
@@ -0,0 +1,74 @@
+#ifndef MAXFLOW_H
+#define MAXFLOW_H
+
+#include "GraphSnapshot.h"
+#include "AlgorithmProgress.h"
+#include <QVector>
+
+// Max-flow engine over a GraphSnapshot. Every snapshot edge becomes a forward
+// residual arc with capacity max(weight, 0) paired with a back arc of
+// capacity 0; the arcs of each vertex are stored contiguously.
+class MaxFlow
+{
+public:
+    enum class Method { Dinic, PushRelabel };
+
+    struct Result {
+        qint64 value = 0;
+        QVector<int> edgeFlows;
+        QVector<bool> sourceSide;
+        bool isCancelled = false;
+    };
+
+    explicit MaxFlow(const GraphSnapshot &snapshot, AlgorithmProgress *progress = nullptr);
+
+    Result run(int source, int sink, Method method);
+
+private:
+    qint64 runDinic(int source, int sink);
+    bool buildLevels(int source, int sink);
+    qint64 blockingFlow(int source, int sink);
+
+    qint64 runPushRelabel(int source, int sink);
+    void pushRelabelPhase(int target, int baseHeight);
+    void globalRelabel(int target, int baseHeight);
+    void discharge(int vertex, int baseHeight);
+    void push(int arc, qint64 amount);
+    void setHeight(int vertex, int height);
+    void activate(int vertex);
+    int arcTail(int arc) const { return m_arcTargets[m_arcPairs[arc]]; }
+
+    void augment(int arc, int amount);
+    QVector<bool> residualReachable(int source) const;
+    bool isCancelled();
+
+    const GraphSnapshot &m_snapshot;
+    AlgorithmProgress *m_progress;
+    bool m_isCancelled;
+    int m_pollCount;
+    int m_vertexCount;
+
+    QVector<int> m_arcOffsets;
+    QVector<int> m_arcTargets;
+    QVector<int> m_arcPairs;
+    QVector<int> m_residual;
+    QVector<int> m_forwardArcs;
+    QVector<int> m_capacities;
+
+    QVector<int> m_levels;
+    QVector<int> m_currentArcs;
+
+    QVector<int> m_heights;
+    QVector<qint64> m_excess;
+    QVector<QVector<int>> m_activeByHeight;
+    QVector<int> m_bucketHeads;
+    QVector<int> m_bucketNext;
+    QVector<int> m_bucketPrev;
+    int m_highestActive;
+    int m_highestLabel;
+    int m_relabelWork;
+    int m_source;
+    int m_sink;
+};
+
+#endif
@@ -0,0 +1,204 @@
+#include "MultiSourcePaths.h"
+#include <QThread>
+
+MultiSourcePaths::Scratch::Scratch(int vertexCount)
+    : distances(vertexCount, UNREACHABLE)
+    , settled(vertexCount, false)
+    , daryHeap(vertexCount)
+{
+    reached.reserve(vertexCount);
+}
+
+MultiSourcePaths::MultiSourcePaths(const GraphSnapshot &snapshot, int threadCount)
+    : m_snapshot(snapshot)
+    , m_hasNegativeWeights(false)
+    , m_nextSource(0)
+    , m_doneCount(0)
+    , m_isCancelled(false)
+{
+    m_pool.setMaxThreadCount(qMax(1, threadCount > 0 ? threadCount : QThread::idealThreadCount()));
+
+    for (int edge = 0; edge < snapshot.edgeCount() && !m_hasNegativeWeights; ++edge) {
+        if (snapshot.weight(edge) < 0) {
+            m_hasNegativeWeights = true;
+        }
+    }
+}
+
+// The calling thread only waits and polls progress; the workers never
+// touch it, so AlgorithmProgress is used from a single thread.
+bool MultiSourcePaths::run(const QVector<int> &sources, Metric metric, const Visitor &visitor,
+                           AlgorithmProgress *progress)
+{
+    m_nextSource = 0;
+    m_doneCount = 0;
+    m_isCancelled = false;
+
+    int workerCount = qMin(m_pool.maxThreadCount(), static_cast<int>(sources.size()));
+    for (int worker = 0; worker < workerCount; ++worker) {
+        m_pool.start([this, &sources, metric, &visitor]() {
+            runWorker(sources, metric, visitor);
+        });
+    }
+
+    while (!m_pool.waitForDone(PROGRESS_INTERVAL_MS)) {
+        if (AlgorithmProgress::checkpoint(progress, m_doneCount, sources.size())) {
+            m_isCancelled = true;
+        }
+    }
+
+    return !m_isCancelled;
+}
+
+void MultiSourcePaths::runWorker(const QVector<int> &sources, Metric metric, const Visitor &visitor)
+{
+    Scratch scratch(m_snapshot.vertexCount());
+    int next = m_nextSource.fetch_add(1);
+
+    while (next < sources.size() && !m_isCancelled) {
+        if (metric == Metric::Hops) {
+            breadthFirst(sources[next], scratch);
+        } else {
+            dijkstra(sources[next], scratch);
+        }
+
+        visitor(next, scratch.distances, scratch.reached);
+        reset(scratch);
+
+        m_doneCount.fetch_add(1);
+        next = m_nextSource.fetch_add(1);
+    }
+}
+
+// reached doubles as the queue: the vertices at distance level sit in
+// reached[levelBegin, levelEnd). unexploredEdges counts the out-edges of
+// vertices that have not been on a frontier yet.
+void MultiSourcePaths::breadthFirst(int source, Scratch &scratch) const
+{
+    int vertexCount = m_snapshot.vertexCount();
+    qint64 unexploredEdges = m_snapshot.edgeCount();
+    bool isBottomUp = false;
+    int levelBegin = 0;
+    int level = 0;
+
+    scratch.distances[source] = 0;
+    scratch.reached.append(source);
+
+    while (levelBegin < scratch.reached.size()) {
+        int levelEnd = scratch.reached.size();
+        qint64 frontierEdges = 0;
+        for (int i = levelBegin; i < levelEnd; ++i) {
+            frontierEdges += m_snapshot.outDegree(scratch.reached[i]);
+        }
+
+        if (!isBottomUp && frontierEdges * ALPHA > unexploredEdges) {
+            isBottomUp = true;
+        } else if (isBottomUp && static_cast<qint64>(levelEnd - levelBegin) * BETA < vertexCount) {
+            isBottomUp = false;
+        }
+
+        if (isBottomUp) {
+            bottomUpStep(level, scratch);
+        } else {
+            topDownStep(levelBegin, levelEnd, level, scratch);
+        }
+
+        unexploredEdges -= frontierEdges;
+        levelBegin = levelEnd;
+        level++;
+    }
+}
+
+void MultiSourcePaths::topDownStep(int levelBegin, int levelEnd, int level, Scratch &scratch) const
+{
+    for (int i = levelBegin; i < levelEnd; ++i) {
+        int current = scratch.reached[i];
+        for (int edge = m_snapshot.outBegin(current); edge < m_snapshot.outEnd(current); ++edge) {
+            int neighbor = m_snapshot.target(edge);
+            if (scratch.distances[neighbor] == UNREACHABLE) {
+                scratch.distances[neighbor] = level + 1;
+                scratch.reached.append(neighbor);
+            }
+        }
+    }
+}
+
+// Every unvisited vertex looks for a parent on the frontier among its
+// in-neighbours and stops at the first one.
+void MultiSourcePaths::bottomUpStep(int level, Scratch &scratch) const
+{
+    for (int vertex = 0; vertex < m_snapshot.vertexCount(); ++vertex) {
+        if (scratch.distances[vertex] == UNREACHABLE) {
+            bool hasParent = false;
+            for (int slot = m_snapshot.inBegin(vertex); slot < m_snapshot.inEnd(vertex) && !hasParent; ++slot) {
+                hasParent = scratch.distances[m_snapshot.inSource(slot)] == level;
+            }
+
+            if (hasParent) {
+                scratch.distances[vertex] = level + 1;
+                scratch.reached.append(vertex);
+            }
+        }
+    }
+}
+
+// The radix heap needs monotone keys, which negative weights would break.
+void MultiSourcePaths::dijkstra(int source, Scratch &scratch) const
+{
+    QVector<int> &distances = scratch.distances;
+
+    distances[source] = 0;
+    scratch.reached.append(source);
+
+    if (!m_hasNegativeWeights) {
+        scratch.radixHeap.push(source, 0);
+
+        while (!scratch.radixHeap.isEmpty()) {
+            int key = 0;
+            int current = scratch.radixHeap.pop(key);
+
+            if (key == distances[current]) {
+                for (int edge = m_snapshot.outBegin(current); edge < m_snapshot.outEnd(current); ++edge) {
+                    int neighbor = m_snapshot.target(edge);
+                    int alternative = key + m_snapshot.weight(edge);
+                    if (alternative < distances[neighbor]) {
+                        if (distances[neighbor] == UNREACHABLE) {
+                            scratch.reached.append(neighbor);
+                        }
+                        distances[neighbor] = alternative;
+                        scratch.radixHeap.push(neighbor, alternative);
+                    }
+                }
+            }
+        }
+    } else {
+        scratch.daryHeap.push(source, 0);
+
+        while (!scratch.daryHeap.isEmpty()) {
+            int current = scratch.daryHeap.pop();
+            scratch.settled[current] = true;
+
+            for (int edge = m_snapshot.outBegin(current); edge < m_snapshot.outEnd(current); ++edge) {
+                int neighbor = m_snapshot.target(edge);
+                int alternative = distances[current] + m_snapshot.weight(edge);
+                if (!scratch.settled[neighbor] && alternative < distances[neighbor]) {
+                    if (distances[neighbor] == UNREACHABLE) {
+                        scratch.reached.append(neighbor);
+                    }
+                    distances[neighbor] = alternative;
+                    scratch.daryHeap.push(neighbor, alternative);
+                }
+            }
+        }
+    }
+}
+
+void MultiSourcePaths::reset(Scratch &scratch) const
+{
+    for (int vertex : scratch.reached) {
+        scratch.distances[vertex] = UNREACHABLE;
+        scratch.settled[vertex] = false;
+    }
+    scratch.reached.clear();
+    scratch.radixHeap.clear();
+}
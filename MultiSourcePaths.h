@@ -0,0 +1,73 @@
+#ifndef MULTISOURCEPATHS_H
+#define MULTISOURCEPATHS_H
+
+#include "GraphSnapshot.h"
+#include "AlgorithmProgress.h"
+#include "PriorityQueues.h"
+#include <QVector>
+#include <QThreadPool>
+#include <atomic>
+#include <functional>
+#include <limits>
+
+// Single-source searches from many sources over one read-only snapshot.
+// Sources are handed out one at a time to the threads of a private pool;
+// each thread owns a Scratch whose arrays are sized once and reset only
+// where the previous search touched them. Hop counts use a
+// direction-optimizing BFS, weighted distances use Dijkstra with the same
+// queue choice as GraphAlgorithms::dijkstra.
+class MultiSourcePaths
+{
+public:
+    enum class Metric { Weights, Hops };
+
+    static constexpr int UNREACHABLE = std::numeric_limits<int>::max();
+
+    // Called on worker threads, possibly at the same time for different
+    // sources. distances is indexed by snapshot vertex; reached lists the
+    // vertices with a finite distance, the source first. Both are only valid
+    // during the call.
+    typedef std::function<void(int sourceIndex, const QVector<int> &distances, const QVector<int> &reached)> Visitor;
+
+    explicit MultiSourcePaths(const GraphSnapshot &snapshot, int threadCount = 0);
+
+    // Searches from every snapshot vertex in sources. Returns false when
+    // cancelled; the visitor may then have seen only some of the sources.
+    bool run(const QVector<int> &sources, Metric metric, const Visitor &visitor,
+             AlgorithmProgress *progress = nullptr);
+
+private:
+    // Beamer's heuristics: go bottom-up once the frontier's out-edges exceed
+    // 1/ALPHA of the unexplored edges, back top-down once the frontier
+    // shrinks below 1/BETA of the vertices. Beamer's ALPHA of 14 switched
+    // too early on the sparse directed graphs in graph_bench.
+    static const int ALPHA = 2;
+    static const int BETA = 24;
+    static const int PROGRESS_INTERVAL_MS = 50;
+
+    struct Scratch {
+        explicit Scratch(int vertexCount);
+
+        QVector<int> distances;
+        QVector<bool> settled;
+        QVector<int> reached;
+        RadixHeap radixHeap;
+        IndexedDaryHeap daryHeap;
+    };
+
+    void runWorker(const QVector<int> &sources, Metric metric, const Visitor &visitor);
+    void breadthFirst(int source, Scratch &scratch) const;
+    void topDownStep(int levelBegin, int levelEnd, int level, Scratch &scratch) const;
+    void bottomUpStep(int level, Scratch &scratch) const;
+    void dijkstra(int source, Scratch &scratch) const;
+    void reset(Scratch &scratch) const;
+
+    const GraphSnapshot &m_snapshot;
+    bool m_hasNegativeWeights;
+    QThreadPool m_pool;
+    std::atomic<int> m_nextSource;
+    std::atomic<int> m_doneCount;
+    std::atomic<bool> m_isCancelled;
+};
+
+#endif
@@ -0,0 +1,100 @@
+#ifndef OBJECTPOOL_H
+#define OBJECTPOOL_H
+
+#include <QVector>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Slab allocator for objects with stable addresses. Objects are carved out of
+// slabs in order and destroyed slots go onto a free list for reuse; clear()
+// releases whole slabs without visiting the objects, so T must be trivially
+// destructible.
+template <typename T>
+class ObjectPool
+{
+    static_assert(std::is_trivially_destructible<T>::value,
+                  "ObjectPool::clear() does not run destructors");
+
+public:
+    explicit ObjectPool(int slabSize = 1024)
+        : m_slabSize(slabSize)
+        , m_freeList(nullptr)
+        , m_current(nullptr)
+        , m_currentUsed(0)
+        , m_currentSize(0)
+    {
+    }
+
+    ~ObjectPool() { clear(); }
+
+    ObjectPool(const ObjectPool &) = delete;
+    ObjectPool &operator=(const ObjectPool &) = delete;
+
+    template <typename... Args>
+    T* create(Args &&...args)
+    {
+        Slot *slot = m_freeList;
+
+        if (slot) {
+            m_freeList = slot->next;
+        } else {
+            if (m_currentUsed == m_currentSize) {
+                addSlab(m_slabSize);
+            }
+            slot = &m_current[m_currentUsed++];
+        }
+
+        return new (slot->storage) T(std::forward<Args>(args)...);
+    }
+
+    void destroy(T *object)
+    {
+        Slot *slot = reinterpret_cast<Slot*>(object);
+        slot->next = m_freeList;
+        m_freeList = slot;
+    }
+
+    // Makes room for count more objects in a single slab.
+    void reserve(int count)
+    {
+        if (m_currentSize - m_currentUsed < count) {
+            addSlab(count > m_slabSize ? count : m_slabSize);
+        }
+    }
+
+    void clear()
+    {
+        for (Slot *slab : m_slabs) {
+            delete[] slab;
+        }
+        m_slabs.clear();
+        m_freeList = nullptr;
+        m_current = nullptr;
+        m_currentUsed = 0;
+        m_currentSize = 0;
+    }
+
+private:
+    union Slot {
+        Slot *next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    void addSlab(int size)
+    {
+        m_current = new Slot[size];
+        m_currentUsed = 0;
+        m_currentSize = size;
+        m_slabs.append(m_current);
+    }
+
+    int m_slabSize;
+    QVector<Slot*> m_slabs;
+    Slot *m_freeList;
+    Slot *m_current;
+    int m_currentUsed;
+    int m_currentSize;
+};
+
+#endif
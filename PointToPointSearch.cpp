@@ -0,0 +1,330 @@
+#include "PointToPointSearch.h"
+#include <QtMath>
+#include <algorithm>
+
+PointToPointSearch::PointToPointSearch(const GraphSnapshot &snapshot, int landmarkCount)
+    : m_snapshot(snapshot)
+    , m_landmarkCount(qMin(landmarkCount, snapshot.vertexCount()))
+    , m_geometricScale(0.0)
+    , m_hasNegativeWeights(false)
+    , m_forwardDistances(snapshot.vertexCount(), UNREACHABLE)
+    , m_backwardDistances(snapshot.vertexCount(), UNREACHABLE)
+    , m_forwardPrevious(snapshot.vertexCount(), -1)
+    , m_backwardNext(snapshot.vertexCount(), -1)
+    , m_heuristics(snapshot.vertexCount(), -1)
+    , m_isTouched(snapshot.vertexCount(), false)
+    , m_forwardHeap(snapshot.vertexCount())
+    , m_backwardHeap(snapshot.vertexCount())
+{
+    computeGeometricScale();
+
+    for (int edge = 0; edge < snapshot.edgeCount() && !m_hasNegativeWeights; ++edge) {
+        m_hasNegativeWeights = snapshot.weight(edge) < 0;
+    }
+}
+
+void PointToPointSearch::prepare(Method method)
+{
+    if (method == Method::Landmarks && m_landmarks.isEmpty()) {
+        buildLandmarks();
+    }
+}
+
+PointToPointSearch::Result PointToPointSearch::run(int source, int target, Method method, AlgorithmProgress *progress)
+{
+    Result result;
+
+    if (method == Method::Bidirectional) {
+        result = runBidirectional(source, target, progress);
+    } else {
+        prepare(method);
+        result = runAStar(source, target, method == Method::AStar, progress);
+    }
+
+    reset();
+    return result;
+}
+
+// Grows one search from the source over out-edges and one from the target
+// over in-edges, always on the side with the smaller tentative distance.
+// best is the shortest source-target path seen through any edge joining the
+// two; once the two queue minima add up to it, nothing shorter is left.
+PointToPointSearch::Result PointToPointSearch::runBidirectional(int source, int target, AlgorithmProgress *progress)
+{
+    Result result;
+    int best = UNREACHABLE;
+    int meeting = -1;
+
+    touch(source);
+    touch(target);
+    m_forwardDistances[source] = 0;
+    m_backwardDistances[target] = 0;
+    m_forwardHeap.push(source, 0);
+    m_backwardHeap.push(target, 0);
+
+    if (source == target) {
+        best = 0;
+        meeting = source;
+    }
+
+    bool isDone = false;
+    while (!isDone && !result.isCancelled) {
+        if (m_forwardHeap.isEmpty() || m_backwardHeap.isEmpty()
+            || static_cast<qint64>(m_forwardHeap.topKey()) + m_backwardHeap.topKey() >= best) {
+            isDone = true;
+        } else if (m_forwardHeap.topKey() <= m_backwardHeap.topKey()) {
+            int current = m_forwardHeap.pop();
+            for (int edge = m_snapshot.outBegin(current); edge < m_snapshot.outEnd(current); ++edge) {
+                int neighbor = m_snapshot.target(edge);
+                int alternative = m_forwardDistances[current] + m_snapshot.weight(edge);
+                touch(neighbor);
+                if (alternative < m_forwardDistances[neighbor]) {
+                    m_forwardDistances[neighbor] = alternative;
+                    m_forwardPrevious[neighbor] = current;
+                    m_forwardHeap.push(neighbor, alternative);
+                }
+                if (m_backwardDistances[neighbor] != UNREACHABLE
+                    && static_cast<qint64>(alternative) + m_backwardDistances[neighbor] < best) {
+                    best = alternative + m_backwardDistances[neighbor];
+                    meeting = neighbor;
+                }
+            }
+            result.settledCount++;
+        } else {
+            int current = m_backwardHeap.pop();
+            for (int slot = m_snapshot.inBegin(current); slot < m_snapshot.inEnd(current); ++slot) {
+                int neighbor = m_snapshot.inSource(slot);
+                int alternative = m_backwardDistances[current] + m_snapshot.weight(m_snapshot.inEdge(slot));
+                touch(neighbor);
+                if (alternative < m_backwardDistances[neighbor]) {
+                    m_backwardDistances[neighbor] = alternative;
+                    m_backwardNext[neighbor] = current;
+                    m_backwardHeap.push(neighbor, alternative);
+                }
+                if (m_forwardDistances[neighbor] != UNREACHABLE
+                    && static_cast<qint64>(alternative) + m_forwardDistances[neighbor] < best) {
+                    best = alternative + m_forwardDistances[neighbor];
+                    meeting = neighbor;
+                }
+            }
+            result.settledCount++;
+        }
+
+        if (result.settledCount % AlgorithmProgress::CHECK_INTERVAL == 0) {
+            result.isCancelled = AlgorithmProgress::checkpoint(progress, result.settledCount, m_snapshot.vertexCount());
+        }
+    }
+
+    if (!result.isCancelled && meeting >= 0) {
+        result.distance = best;
+        for (int vertex = meeting; vertex >= 0; vertex = m_forwardPrevious[vertex]) {
+            result.path.append(vertex);
+        }
+        std::reverse(result.path.begin(), result.path.end());
+        for (int vertex = m_backwardNext[meeting]; vertex >= 0; vertex = m_backwardNext[vertex]) {
+            result.path.append(vertex);
+        }
+    }
+
+    return result;
+}
+
+// Keys are distance plus heuristic. A vertex whose distance improves after
+// it was popped goes back into the heap, which keeps the search exact for
+// bounds that are admissible but not consistent (skipped ALT terms).
+PointToPointSearch::Result PointToPointSearch::runAStar(int source, int target, bool isEuclidean,
+                                                        AlgorithmProgress *progress)
+{
+    Result result;
+    bool isFound = false;
+
+    touch(source);
+    m_forwardDistances[source] = 0;
+    m_forwardHeap.push(source, heuristic(source, target, isEuclidean));
+
+    while (!m_forwardHeap.isEmpty() && !isFound && !result.isCancelled) {
+        int current = m_forwardHeap.pop();
+
+        if (current == target) {
+            isFound = true;
+        } else {
+            for (int edge = m_snapshot.outBegin(current); edge < m_snapshot.outEnd(current); ++edge) {
+                int neighbor = m_snapshot.target(edge);
+                int alternative = m_forwardDistances[current] + m_snapshot.weight(edge);
+                touch(neighbor);
+                if (alternative < m_forwardDistances[neighbor]) {
+                    int estimate = heuristic(neighbor, target, isEuclidean);
+                    if (estimate != UNREACHABLE) {
+                        m_forwardDistances[neighbor] = alternative;
+                        m_forwardPrevious[neighbor] = current;
+                        m_forwardHeap.push(neighbor, alternative + estimate);
+                    }
+                }
+            }
+        }
+
+        if (++result.settledCount % AlgorithmProgress::CHECK_INTERVAL == 0) {
+            result.isCancelled = AlgorithmProgress::checkpoint(progress, result.settledCount, m_snapshot.vertexCount());
+        }
+    }
+
+    if (isFound) {
+        result.distance = m_forwardDistances[target];
+        for (int vertex = target; vertex >= 0; vertex = m_forwardPrevious[vertex]) {
+            result.path.append(vertex);
+        }
+        std::reverse(result.path.begin(), result.path.end());
+    }
+
+    return result;
+}
+
+// Cached per vertex for the current query. UNREACHABLE means a landmark
+// proves the target cannot be reached from the vertex.
+int PointToPointSearch::heuristic(int vertex, int target, bool isEuclidean)
+{
+    if (m_heuristics[vertex] < 0) {
+        int estimate = 0;
+
+        if (isEuclidean) {
+            QPointF delta = QPointF(m_snapshot.position(target) - m_snapshot.position(vertex));
+            estimate = qFloor(m_geometricScale * qSqrt(QPointF::dotProduct(delta, delta)));
+        } else {
+            for (int i = 0; i < m_landmarkCount && estimate != UNREACHABLE; ++i) {
+                int landmarkToVertex = m_fromLandmark[vertex * m_landmarkCount + i];
+                int landmarkToTarget = m_fromLandmark[target * m_landmarkCount + i];
+                int vertexToLandmark = m_toLandmark[vertex * m_landmarkCount + i];
+                int targetToLandmark = m_toLandmark[target * m_landmarkCount + i];
+
+                if ((landmarkToVertex != UNREACHABLE && landmarkToTarget == UNREACHABLE)
+                    || (vertexToLandmark == UNREACHABLE && targetToLandmark != UNREACHABLE)) {
+                    estimate = UNREACHABLE;
+                } else {
+                    if (landmarkToVertex != UNREACHABLE) {
+                        estimate = qMax(estimate, landmarkToTarget - landmarkToVertex);
+                    }
+                    if (vertexToLandmark != UNREACHABLE) {
+                        estimate = qMax(estimate, vertexToLandmark - targetToLandmark);
+                    }
+                }
+            }
+        }
+
+        m_heuristics[vertex] = estimate;
+    }
+
+    return m_heuristics[vertex];
+}
+
+// The largest factor by which every edge weight still covers the straight
+// line between its endpoints.
+void PointToPointSearch::computeGeometricScale()
+{
+    double scale = std::numeric_limits<double>::max();
+
+    for (int vertex = 0; vertex < m_snapshot.vertexCount() && scale > 0; ++vertex) {
+        for (int edge = m_snapshot.outBegin(vertex); edge < m_snapshot.outEnd(vertex) && scale > 0; ++edge) {
+            QPointF delta = QPointF(m_snapshot.position(m_snapshot.target(edge)) - m_snapshot.position(vertex));
+            double length = qSqrt(QPointF::dotProduct(delta, delta));
+            if (length > 0) {
+                scale = qMin(scale, m_snapshot.weight(edge) / length);
+            }
+        }
+    }
+
+    m_geometricScale = scale == std::numeric_limits<double>::max() ? 0.0 : qMax(scale, 0.0);
+}
+
+// Farthest-point selection: the first landmark is the vertex farthest from
+// vertex 0, each next one maximises its smallest distance from the
+// landmarks chosen so far.
+void PointToPointSearch::buildLandmarks()
+{
+    int vertexCount = m_snapshot.vertexCount();
+    QVector<int> distances;
+    QVector<int> closest(vertexCount, UNREACHABLE);
+
+    m_fromLandmark.fill(UNREACHABLE, vertexCount * m_landmarkCount);
+    m_toLandmark.fill(UNREACHABLE, vertexCount * m_landmarkCount);
+
+    distancesFrom(0, false, distances);
+    int next = 0;
+    for (int vertex = 0; vertex < vertexCount; ++vertex) {
+        if (distances[vertex] != UNREACHABLE && distances[vertex] > distances[next]) {
+            next = vertex;
+        }
+    }
+
+    for (int i = 0; i < m_landmarkCount; ++i) {
+        m_landmarks.append(next);
+
+        distancesFrom(next, false, distances);
+        for (int vertex = 0; vertex < vertexCount; ++vertex) {
+            m_fromLandmark[vertex * m_landmarkCount + i] = distances[vertex];
+            closest[vertex] = qMin(closest[vertex], distances[vertex]);
+        }
+
+        distancesFrom(next, true, distances);
+        for (int vertex = 0; vertex < vertexCount; ++vertex) {
+            m_toLandmark[vertex * m_landmarkCount + i] = distances[vertex];
+        }
+
+        // Unreached vertices count as farthest, so other components get a
+        // landmark too.
+        for (int vertex = 0; vertex < vertexCount; ++vertex) {
+            if (!m_landmarks.contains(vertex) && (m_landmarks.contains(next) || closest[vertex] > closest[next])) {
+                next = vertex;
+            }
+        }
+    }
+}
+
+// Plain Dijkstra over out-edges, or over in-edges when isReverse.
+void PointToPointSearch::distancesFrom(int source, bool isReverse, QVector<int> &distances) const
+{
+    RadixHeap heap;
+    distances.fill(UNREACHABLE, m_snapshot.vertexCount());
+    distances[source] = 0;
+    heap.push(source, 0);
+
+    while (!heap.isEmpty()) {
+        int key = 0;
+        int current = heap.pop(key);
+
+        if (key == distances[current]) {
+            int begin = isReverse ? m_snapshot.inBegin(current) : m_snapshot.outBegin(current);
+            int end = isReverse ? m_snapshot.inEnd(current) : m_snapshot.outEnd(current);
+            for (int slot = begin; slot < end; ++slot) {
+                int neighbor = isReverse ? m_snapshot.inSource(slot) : m_snapshot.target(slot);
+                int weight = m_snapshot.weight(isReverse ? m_snapshot.inEdge(slot) : slot);
+                if (key + weight < distances[neighbor]) {
+                    distances[neighbor] = key + weight;
+                    heap.push(neighbor, key + weight);
+                }
+            }
+        }
+    }
+}
+
+void PointToPointSearch::touch(int vertex)
+{
+    if (!m_isTouched[vertex]) {
+        m_isTouched[vertex] = true;
+        m_touched.append(vertex);
+    }
+}
+
+void PointToPointSearch::reset()
+{
+    for (int vertex : m_touched) {
+        m_forwardDistances[vertex] = UNREACHABLE;
+        m_backwardDistances[vertex] = UNREACHABLE;
+        m_forwardPrevious[vertex] = -1;
+        m_backwardNext[vertex] = -1;
+        m_heuristics[vertex] = -1;
+        m_isTouched[vertex] = false;
+    }
+    m_touched.clear();
+    m_forwardHeap.clear();
+    m_backwardHeap.clear();
+}
@@ -0,0 +1,80 @@
+#ifndef POINTTOPOINTSEARCH_H
+#define POINTTOPOINTSEARCH_H
+
+#include "GraphSnapshot.h"
+#include "AlgorithmProgress.h"
+#include "PriorityQueues.h"
+#include <QVector>
+#include <limits>
+
+// Shortest path between one pair of vertices that stops as soon as the
+// answer is known instead of settling the whole graph. Weights must not be
+// negative. The engine keeps its arrays and landmark tables between runs,
+// so repeated queries on the same snapshot only pay for what they touch.
+//
+// A* uses the Euclidean distance between vertex positions, scaled by the
+// smallest weight-to-length ratio over all edges so that it never
+// overestimates; when some edge is cheaper than its length allows (zero
+// weight, coincident endpoints) the scale is 0 and A* degrades to
+// Dijkstra. Landmarks is A* with ALT bounds from the triangle inequality
+// over distances to and from a few far-apart landmark vertices, which are
+// computed on the first such query.
+class PointToPointSearch
+{
+public:
+    enum class Method { Bidirectional, AStar, Landmarks };
+
+    static constexpr int UNREACHABLE = std::numeric_limits<int>::max();
+
+    struct Result {
+        int distance = UNREACHABLE;
+        QVector<int> path;
+        int settledCount = 0;
+        bool isCancelled = false;
+    };
+
+    explicit PointToPointSearch(const GraphSnapshot &snapshot, int landmarkCount = DEFAULT_LANDMARK_COUNT);
+
+    Result run(int source, int target, Method method, AlgorithmProgress *progress = nullptr);
+    // Does up front what the first run with the method would, i.e. builds
+    // the landmark tables, so that timing runs leaves preprocessing out.
+    void prepare(Method method);
+
+    const GraphSnapshot &snapshot() const { return m_snapshot; }
+    bool isGeometric() const { return m_geometricScale > 0; }
+    bool hasNegativeWeights() const { return m_hasNegativeWeights; }
+
+private:
+    static const int DEFAULT_LANDMARK_COUNT = 8;
+
+    Result runBidirectional(int source, int target, AlgorithmProgress *progress);
+    Result runAStar(int source, int target, bool isEuclidean, AlgorithmProgress *progress);
+    int heuristic(int vertex, int target, bool isEuclidean);
+    void computeGeometricScale();
+    void buildLandmarks();
+    void distancesFrom(int source, bool isReverse, QVector<int> &distances) const;
+    void touch(int vertex);
+    void reset();
+
+    const GraphSnapshot &m_snapshot;
+    int m_landmarkCount;
+    double m_geometricScale;
+    bool m_hasNegativeWeights;
+
+    // Distances from and to landmark i for vertex v sit at v * count + i.
+    QVector<int> m_landmarks;
+    QVector<int> m_fromLandmark;
+    QVector<int> m_toLandmark;
+
+    QVector<int> m_forwardDistances;
+    QVector<int> m_backwardDistances;
+    QVector<int> m_forwardPrevious;
+    QVector<int> m_backwardNext;
+    QVector<int> m_heuristics;
+    QVector<bool> m_isTouched;
+    QVector<int> m_touched;
+    IndexedDaryHeap m_forwardHeap;
+    IndexedDaryHeap m_backwardHeap;
+};
+
+#endif
@@ -0,0 +1,171 @@
+#include "PriorityQueues.h"
+#include <algorithm>
+#include <bit>
+
+IndexedDaryHeap::IndexedDaryHeap(int capacity)
+{
+    m_items.reserve(capacity);
+    m_keys.reserve(capacity);
+    m_positions.fill(-1, capacity);
+}
+
+void IndexedDaryHeap::push(int item, int key)
+{
+    if (contains(item)) {
+        decreaseKey(item, key);
+    } else {
+        m_items.append(item);
+        m_keys.append(key);
+        m_positions[item] = m_items.size() - 1;
+        siftUp(m_items.size() - 1);
+    }
+}
+
+void IndexedDaryHeap::decreaseKey(int item, int key)
+{
+    int position = m_positions[item];
+    if (key < m_keys[position]) {
+        m_keys[position] = key;
+        siftUp(position);
+    }
+}
+
+int IndexedDaryHeap::pop()
+{
+    int top = m_items.first();
+    int lastItem = m_items.last();
+    int lastKey = m_keys.last();
+
+    m_items.removeLast();
+    m_keys.removeLast();
+    m_positions[top] = -1;
+
+    if (!m_items.isEmpty()) {
+        place(0, lastItem, lastKey);
+        siftDown(0);
+    }
+
+    return top;
+}
+
+void IndexedDaryHeap::clear()
+{
+    for (int item : m_items) {
+        m_positions[item] = -1;
+    }
+    m_items.clear();
+    m_keys.clear();
+}
+
+void IndexedDaryHeap::siftUp(int position)
+{
+    int item = m_items[position];
+    int key = m_keys[position];
+
+    while (position > 0) {
+        int parent = (position - 1) / ARITY;
+        if (m_keys[parent] <= key) {
+            break;
+        }
+        place(position, m_items[parent], m_keys[parent]);
+        position = parent;
+    }
+
+    place(position, item, key);
+}
+
+void IndexedDaryHeap::siftDown(int position)
+{
+    int item = m_items[position];
+    int key = m_keys[position];
+    int count = m_items.size();
+
+    while (true) {
+        int firstChild = position * ARITY + 1;
+        if (firstChild >= count) {
+            break;
+        }
+
+        int lastChild = std::min(firstChild + ARITY, count);
+        int bestChild = firstChild;
+        for (int child = firstChild + 1; child < lastChild; ++child) {
+            if (m_keys[child] < m_keys[bestChild]) {
+                bestChild = child;
+            }
+        }
+
+        if (m_keys[bestChild] >= key) {
+            break;
+        }
+        place(position, m_items[bestChild], m_keys[bestChild]);
+        position = bestChild;
+    }
+
+    place(position, item, key);
+}
+
+void IndexedDaryHeap::place(int position, int item, int key)
+{
+    m_items[position] = item;
+    m_keys[position] = key;
+    m_positions[item] = position;
+}
+
+RadixHeap::RadixHeap()
+    : m_buckets(BUCKET_COUNT)
+    , m_last(0)
+    , m_size(0)
+{
+}
+
+int RadixHeap::bucketIndex(quint32 key) const
+{
+    return key == m_last ? 0 : 32 - std::countl_zero(key ^ m_last);
+}
+
+void RadixHeap::push(int item, int key)
+{
+    quint32 value = static_cast<quint32>(key);
+    m_buckets[bucketIndex(value)].append(qMakePair(value, item));
+    m_size++;
+}
+
+// Bucket i holds keys whose highest bit differing from m_last is bit i-1.
+// Refilling bucket 0 moves the new minimum's bucket down, and every element
+// lands in a strictly lower bucket, so each key is moved at most 32 times.
+int RadixHeap::pop(int &key)
+{
+    if (m_buckets[0].isEmpty()) {
+        int bucket = 1;
+        while (m_buckets[bucket].isEmpty()) {
+            bucket++;
+        }
+
+        QVector<QPair<quint32, int>> entries;
+        entries.swap(m_buckets[bucket]);
+
+        quint32 minimum = entries.first().first;
+        for (const QPair<quint32, int> &entry : entries) {
+            minimum = std::min(minimum, entry.first);
+        }
+        m_last = minimum;
+
+        for (const QPair<quint32, int> &entry : entries) {
+            m_buckets[bucketIndex(entry.first)].append(entry);
+        }
+    }
+
+    QPair<quint32, int> entry = m_buckets[0].takeLast();
+    m_size--;
+    key = static_cast<int>(entry.first);
+    return entry.second;
+}
+
+void RadixHeap::clear()
+{
+    for (QVector<QPair<quint32, int>> &bucket : m_buckets) {
+        bucket.clear();
+    }
+    m_last = 0;
+    m_size = 0;
+}
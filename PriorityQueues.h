@@ -0,0 +1,63 @@
+#ifndef PRIORITYQUEUES_H
+#define PRIORITYQUEUES_H
+
+#include <QVector>
+#include <QPair>
+
+// Min-heap over items 0..capacity-1 with decrease-key. Each item is in the
+// heap at most once; m_positions maps an item to its heap slot.
+class IndexedDaryHeap
+{
+public:
+    explicit IndexedDaryHeap(int capacity);
+
+    bool isEmpty() const { return m_items.isEmpty(); }
+    int size() const { return m_items.size(); }
+    bool contains(int item) const { return m_positions[item] >= 0; }
+    int key(int item) const { return m_keys[m_positions[item]]; }
+    int top() const { return m_items.first(); }
+    int topKey() const { return m_keys.first(); }
+
+    void push(int item, int key);
+    void decreaseKey(int item, int key);
+    int pop();
+    void clear();
+
+private:
+    static const int ARITY = 4;
+
+    void siftUp(int position);
+    void siftDown(int position);
+    void place(int position, int item, int key);
+
+    QVector<int> m_items;
+    QVector<int> m_keys;
+    QVector<int> m_positions;
+};
+
+// Monotone integer priority queue: keys pushed must not be smaller than the
+// last popped key. Items may be pushed several times; callers skip stale
+// entries by comparing the popped key against their own state.
+class RadixHeap
+{
+public:
+    RadixHeap();
+
+    bool isEmpty() const { return m_size == 0; }
+    int size() const { return m_size; }
+
+    void push(int item, int key);
+    int pop(int &key);
+    void clear();
+
+private:
+    static const int BUCKET_COUNT = 33;
+
+    int bucketIndex(quint32 key) const;
+
+    QVector<QVector<QPair<quint32, int>>> m_buckets;
+    quint32 m_last;
+    int m_size;
+};
+
+#endif
@@ -0,0 +1,289 @@
+#include "ResultFormatter.h"
+
+QString ResultFormatter::joinIds(const QVector<int>& vertexIds, const QString& separator){
+    QStringList parts;
+    parts.reserve(vertexIds.size());
+
+    for (int vertexId : vertexIds) {
+        parts.append(QString::number(vertexId));
+    }
+
+    return parts.join(separator);
+}
+
+QString ResultFormatter::edgeName(int fromId, int toId){
+    return QString::number(fromId) + " → " + QString::number(toId);
+}
+
+QString ResultFormatter::topologicalSort(const VertexSequenceResult& result){
+    QString text = "";
+
+    switch (result.status) {
+    case AlgorithmStatus::Ok:
+        text = joinIds(result.vertexIds, " -> ");
+        break;
+    case AlgorithmStatus::GraphNotInitialized:
+        text = "Graph is not initialized.";
+        break;
+    case AlgorithmStatus::EmptyGraph:
+        text = "Graph is empty. No vertices for sorting.";
+        break;
+    case AlgorithmStatus::NotWeaklyConnected:
+        text = "Graph is not weakly connected. Topological sort is only possible for weakly connected directed graphs.";
+        break;
+    case AlgorithmStatus::ContainsCycle:
+        text = "Graph contains cycles. Topological sort is not possible for graphs with cycles.";
+        break;
+    default:
+        break;
+    }
+
+    return text;
+}
+
+QString ResultFormatter::eulerianCycle(const VertexSequenceResult& result){
+    QString text = "";
+
+    switch (result.status) {
+    case AlgorithmStatus::Ok:
+        text = joinIds(result.vertexIds, " -> ");
+        break;
+    case AlgorithmStatus::GraphNotInitialized:
+        text = "Graph is not initialized.";
+        break;
+    case AlgorithmStatus::EmptyGraph:
+        text = "Graph is empty. No vertices for finding Eulerian cycle.";
+        break;
+    case AlgorithmStatus::ConditionsNotMet:
+        text = "Graph does not satisfy conditions for Eulerian cycle.";
+        break;
+    case AlgorithmStatus::NoEdges:
+        text = "No edges found in the graph.";
+        break;
+    default:
+        break;
+    }
+
+    return text;
+}
+
+QString ResultFormatter::eulerianPath(const VertexSequenceResult& result){
+    QString text = "";
+
+    switch (result.status) {
+    case AlgorithmStatus::Ok:
+        text = "Eulerian Path found:\n" + joinIds(result.vertexIds, " → ");
+        break;
+    case AlgorithmStatus::GraphNotInitialized:
+        text = "Graph is not initialized.";
+        break;
+    case AlgorithmStatus::EmptyGraph:
+        text = "Graph is empty. No vertices for Eulerian path.";
+        break;
+    case AlgorithmStatus::ConditionsNotMet:
+        text = "Graph does not satisfy conditions for Eulerian path.";
+        break;
+    case AlgorithmStatus::NoEdges:
+        text = "Cannot find start vertex for Eulerian path.";
+        break;
+    default:
+        break;
+    }
+
+    return text;
+}
+
+QString ResultFormatter::dijkstra(const ShortestPathResult& result){
+    QString text = "";
+    QString startId = QString::number(result.startId);
+    QString endId = QString::number(result.endId);
+
+    switch (result.status) {
+    case AlgorithmStatus::Ok:
+        text = "Shortest path from " + startId + " to " + endId + ":\n" +
+               "Distance: " + QString::number(result.distance) + "\n" +
+               "Path: " + joinIds(result.path, " → ");
+        break;
+    case AlgorithmStatus::GraphNotInitialized:
+        text = "Graph is not initialized.";
+        break;
+    case AlgorithmStatus::StartVertexNotFound:
+        text = "Start vertex with ID " + startId + " not found.";
+        break;
+    case AlgorithmStatus::EndVertexNotFound:
+        text = "End vertex with ID " + endId + " not found.";
+        break;
+    case AlgorithmStatus::SameEndpoints:
+        text = "Start and end vertices are the same. Distance: 0";
+        break;
+    case AlgorithmStatus::NoPath:
+        text = "No path from vertex " + startId + " to vertex " + endId;
+        break;
+    case AlgorithmStatus::Cancelled:
+        text = "Cancelled.";
+        break;
+    default:
+        break;
+    }
+
+    return text;
+}
+
+QString ResultFormatter::maxFlow(const MaxFlowResult& result){
+    QString text = "";
+
+    switch (result.status) {
+    case AlgorithmStatus::Ok: {
+        QStringList lines;
+        lines.append("Maximum flow from source " + QString::number(result.sourceId) +
+                     " to sink " + QString::number(result.sinkId) + ": " + QString::number(result.value));
+
+        if (result.value > 0) {
+            QStringList cutEdges;
+            QStringList edgeFlows;
+
+            for (const FlowEdge& edge : result.edges) {
+                if (edge.crossesCut) {
+                    cutEdges.append(edgeName(edge.fromId, edge.toId));
+                }
+                if (edge.flow > 0) {
+                    edgeFlows.append(edgeName(edge.fromId, edge.toId) + ": " + QString::number(edge.flow) +
+                                     "/" + QString::number(edge.capacity));
+                }
+            }
+
+            lines.append("Minimum cut: " + cutEdges.join(", "));
+            lines.append("Edge flows:");
+            lines.append(edgeFlows);
+        }
+
+        text = lines.join("\n");
+        break;
+    }
+    case AlgorithmStatus::GraphNotInitialized:
+        text = "Graph is not initialized.";
+        break;
+    case AlgorithmStatus::StartVertexNotFound:
+        text = "Source vertex with ID " + QString::number(result.sourceId) + " not found.";
+        break;
+    case AlgorithmStatus::EndVertexNotFound:
+        text = "Sink vertex with ID " + QString::number(result.sinkId) + " not found.";
+        break;
+    case AlgorithmStatus::SameEndpoints:
+        text = "Source and sink vertices are the same. Max flow: 0";
+        break;
+    case AlgorithmStatus::Cancelled:
+        text = "Cancelled.";
+        break;
+    default:
+        break;
+    }
+
+    return text;
+}
+
+QString ResultFormatter::stronglyConnectedComponents(const ComponentsResult& result){
+    QString text = "";
+
+    switch (result.status) {
+    case AlgorithmStatus::Ok: {
+        QStringList lines;
+        lines.append("Strongly Connected Components:");
+
+        if (result.components.isEmpty()) {
+            lines.append("No strongly connected components found.");
+        } else {
+            for (int i = 0; i < result.components.size(); ++i) {
+                lines.append("Component " + QString::number(i + 1) + " (" +
+                             QString::number(result.components[i].size()) + " vertices): " +
+                             joinIds(result.components[i], " → "));
+            }
+            lines.append("Total: " + QString::number(result.components.size()) + " components");
+        }
+
+        text = lines.join("\n");
+        break;
+    }
+    case AlgorithmStatus::GraphNotInitialized:
+        text = "Graph is not initialized.";
+        break;
+    case AlgorithmStatus::EmptyGraph:
+        text = "Graph is empty. No vertices for SCC analysis.";
+        break;
+    case AlgorithmStatus::Cancelled:
+        text = "Cancelled.";
+        break;
+    default:
+        break;
+    }
+
+    return text;
+}
+
+QString ResultFormatter::vertexDegrees(const DegreesResult& result){
+    QString text = "";
+
+    switch (result.status) {
+    case AlgorithmStatus::Ok: {
+        QStringList lines;
+        lines.append("Vertex degrees:");
+
+        for (const VertexDegree& degree : result.degrees) {
+            lines.append("Vertex " + QString::number(degree.vertexId) + ": " +
+                         "in=" + QString::number(degree.inDegree) + ", " +
+                         "out=" + QString::number(degree.outDegree) + ", " +
+                         "total=" + QString::number(degree.inDegree + degree.outDegree));
+        }
+
+        text = lines.join("\n") + "\n";
+        break;
+    }
+    case AlgorithmStatus::GraphNotInitialized:
+        text = "Graph is not initialized.";
+        break;
+    case AlgorithmStatus::EmptyGraph:
+        text = "Graph is empty. No vertices for degree analysis.";
+        break;
+    default:
+        break;
+    }
+
+    return text;
+}
+
+QString ResultFormatter::reachability(const ReachabilityResult& result){
+    QString text = "";
+
+    switch (result.status) {
+    case AlgorithmStatus::Ok: {
+        QStringList lines;
+        lines.append("Reachability:");
+
+        for (const SourceReach& reach : result.sources) {
+            lines.append("Vertex " + QString::number(reach.sourceId) + ": " +
+                         "reaches=" + QString::number(reach.reachedCount) + ", " +
+                         "farthest=" + QString::number(reach.eccentricity) + ", " +
+                         "total=" + QString::number(reach.distanceSum));
+        }
+
+        text = lines.join("\n") + "\n";
+        break;
+    }
+    case AlgorithmStatus::GraphNotInitialized:
+        text = "Graph is not initialized.";
+        break;
+    case AlgorithmStatus::EmptyGraph:
+        text = "Graph is empty. No vertices for reachability analysis.";
+        break;
+    case AlgorithmStatus::StartVertexNotFound:
+        text = "Source vertex not found.";
+        break;
+    case AlgorithmStatus::Cancelled:
+        text = "Cancelled.";
+        break;
+    default:
+        break;
+    }
+
+    return text;
+}
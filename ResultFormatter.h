@@ -0,0 +1,27 @@
+#ifndef RESULTFORMATTER_H
+#define RESULTFORMATTER_H
+
+#include "AlgorithmResults.h"
+#include <QString>
+#include <QStringList>
+
+// Turns GraphAlgorithms results into the text shown in the output pane.
+// Lines are collected in a QStringList and joined once at the end.
+class ResultFormatter
+{
+public:
+    static QString topologicalSort(const VertexSequenceResult& result);
+    static QString eulerianCycle(const VertexSequenceResult& result);
+    static QString eulerianPath(const VertexSequenceResult& result);
+    static QString dijkstra(const ShortestPathResult& result);
+    static QString maxFlow(const MaxFlowResult& result);
+    static QString stronglyConnectedComponents(const ComponentsResult& result);
+    static QString vertexDegrees(const DegreesResult& result);
+    static QString reachability(const ReachabilityResult& result);
+
+private:
+    static QString joinIds(const QVector<int>& vertexIds, const QString& separator);
+    static QString edgeName(int fromId, int toId);
+};
+
+#endif
@@ -0,0 +1,207 @@
+#include "SpatialGrid.h"
+#include "Vertex.h"
+#include "Edge.h"
+#include <QPointF>
+#include <QSet>
+#include <cmath>
+
+SpatialGrid::SpatialGrid(int cellSize)
+    : m_cellSize(cellSize)
+    , m_edgeEntryCount(0)
+{
+}
+
+int SpatialGrid::cellCoordinate(double value) const
+{
+    return static_cast<int>(std::floor(value / m_cellSize));
+}
+
+quint64 SpatialGrid::cellKey(int cellX, int cellY) const
+{
+    return (static_cast<quint64>(static_cast<quint32>(cellX)) << 32) | static_cast<quint32>(cellY);
+}
+
+// Probes the cells covered by the rectangle, or scans the occupied cells
+// when there are fewer of them than the rectangle covers.
+template <typename Cells>
+QVector<quint64> SpatialGrid::occupiedCellsIn(const QRect &rect, const Cells &cells) const
+{
+    QVector<quint64> result;
+    int firstX = cellCoordinate(rect.left());
+    int lastX = cellCoordinate(rect.right());
+    int firstY = cellCoordinate(rect.top());
+    int lastY = cellCoordinate(rect.bottom());
+    qint64 coveredCount = static_cast<qint64>(lastX - firstX + 1) * (lastY - firstY + 1);
+
+    if (coveredCount > cells.size()) {
+        for (auto cell = cells.constBegin(); cell != cells.constEnd(); ++cell) {
+            int cellX = static_cast<qint32>(cell.key() >> 32);
+            int cellY = static_cast<qint32>(cell.key() & 0xffffffffu);
+            if (cellX >= firstX && cellX <= lastX && cellY >= firstY && cellY <= lastY) {
+                result.append(cell.key());
+            }
+        }
+    } else {
+        for (int cellX = firstX; cellX <= lastX; ++cellX) {
+            for (int cellY = firstY; cellY <= lastY; ++cellY) {
+                if (cells.contains(cellKey(cellX, cellY))) {
+                    result.append(cellKey(cellX, cellY));
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+void SpatialGrid::insertVertex(Vertex *vertex)
+{
+    QPoint position = vertex->position();
+    m_vertexCells[cellKey(cellCoordinate(position.x()), cellCoordinate(position.y()))].append(vertex);
+}
+
+void SpatialGrid::removeVertex(Vertex *vertex)
+{
+    QPoint position = vertex->position();
+    quint64 key = cellKey(cellCoordinate(position.x()), cellCoordinate(position.y()));
+
+    auto cell = m_vertexCells.find(key);
+    if (cell != m_vertexCells.end()) {
+        cell.value().removeOne(vertex);
+        if (cell.value().isEmpty()) {
+            m_vertexCells.erase(cell);
+        }
+    }
+}
+
+void SpatialGrid::insertEdge(Edge *edge)
+{
+    for (quint64 key : cellsAlongSegment(edge->from()->position(), edge->to()->position())) {
+        m_edgeCells[key].append(edge);
+        m_edgeEntryCount++;
+    }
+}
+
+void SpatialGrid::removeEdge(Edge *edge)
+{
+    for (quint64 key : cellsAlongSegment(edge->from()->position(), edge->to()->position())) {
+        auto cell = m_edgeCells.find(key);
+        if (cell != m_edgeCells.end()) {
+            if (cell.value().removeOne(edge)) {
+                m_edgeEntryCount--;
+            }
+            if (cell.value().isEmpty()) {
+                m_edgeCells.erase(cell);
+            }
+        }
+    }
+}
+
+void SpatialGrid::clear()
+{
+    m_vertexCells.clear();
+    m_edgeCells.clear();
+    m_edgeEntryCount = 0;
+}
+
+QVector<Vertex*> SpatialGrid::verticesNear(const QPoint &point, int radius) const
+{
+    QVector<Vertex*> result;
+    int firstX = cellCoordinate(point.x() - radius);
+    int lastX = cellCoordinate(point.x() + radius);
+    int firstY = cellCoordinate(point.y() - radius);
+    int lastY = cellCoordinate(point.y() + radius);
+
+    for (int cellX = firstX; cellX <= lastX; ++cellX) {
+        for (int cellY = firstY; cellY <= lastY; ++cellY) {
+            auto cell = m_vertexCells.constFind(cellKey(cellX, cellY));
+            if (cell != m_vertexCells.constEnd()) {
+                result.append(cell.value());
+            }
+        }
+    }
+
+    return result;
+}
+
+// An edge passing within radius of the point crosses a cell overlapping the
+// query square, so the result may contain duplicates but never misses one.
+QVector<Edge*> SpatialGrid::edgesNear(const QPoint &point, int radius) const
+{
+    QVector<Edge*> result;
+    int firstX = cellCoordinate(point.x() - radius);
+    int lastX = cellCoordinate(point.x() + radius);
+    int firstY = cellCoordinate(point.y() - radius);
+    int lastY = cellCoordinate(point.y() + radius);
+
+    for (int cellX = firstX; cellX <= lastX; ++cellX) {
+        for (int cellY = firstY; cellY <= lastY; ++cellY) {
+            auto cell = m_edgeCells.constFind(cellKey(cellX, cellY));
+            if (cell != m_edgeCells.constEnd()) {
+                result.append(cell.value());
+            }
+        }
+    }
+
+    return result;
+}
+
+QVector<Vertex*> SpatialGrid::verticesIn(const QRect &rect) const
+{
+    QVector<Vertex*> result;
+
+    for (quint64 key : occupiedCellsIn(rect, m_vertexCells)) {
+        result.append(m_vertexCells.value(key));
+    }
+
+    return result;
+}
+
+// Edges crossing a cell that overlaps the rectangle, each listed once.
+QVector<Edge*> SpatialGrid::edgesIn(const QRect &rect) const
+{
+    QVector<Edge*> result;
+    QSet<Edge*> seen;
+
+    for (quint64 key : occupiedCellsIn(rect, m_edgeCells)) {
+        for (Edge *edge : m_edgeCells.value(key)) {
+            if (!seen.contains(edge)) {
+                seen.insert(edge);
+                result.append(edge);
+            }
+        }
+    }
+
+    return result;
+}
+
+// Walks the segment one column of cells at a time and adds the cells spanned
+// by the part of the segment inside that column.
+QVector<quint64> SpatialGrid::cellsAlongSegment(const QPoint &start, const QPoint &end) const
+{
+    QVector<quint64> cells;
+
+    QPointF left = start.x() <= end.x() ? QPointF(start) : QPointF(end);
+    QPointF right = start.x() <= end.x() ? QPointF(end) : QPointF(start);
+    double deltaX = right.x() - left.x();
+    double slope = deltaX > 0 ? (right.y() - left.y()) / deltaX : 0.0;
+
+    int firstColumn = cellCoordinate(left.x());
+    int lastColumn = cellCoordinate(right.x());
+
+    for (int column = firstColumn; column <= lastColumn; ++column) {
+        double segmentStartX = std::max(left.x(), static_cast<double>(column) * m_cellSize);
+        double segmentEndX = std::min(right.x(), static_cast<double>(column + 1) * m_cellSize);
+
+        double startY = left.y() + (segmentStartX - left.x()) * slope;
+        double endY = deltaX > 0 ? left.y() + (segmentEndX - left.x()) * slope : right.y();
+
+        int firstRow = cellCoordinate(std::min(startY, endY));
+        int lastRow = cellCoordinate(std::max(startY, endY));
+        for (int row = firstRow; row <= lastRow; ++row) {
+            cells.append(cellKey(column, row));
+        }
+    }
+
+    return cells;
+}
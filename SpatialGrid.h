@@ -0,0 +1,49 @@
+#ifndef SPATIALGRID_H
+#define SPATIALGRID_H
+
+#include <QHash>
+#include <QVector>
+#include <QPoint>
+#include <QRect>
+
+class Vertex;
+class Edge;
+
+// Uniform grid over the canvas. A vertex lives in the cell containing its
+// position; an edge lives in every cell its from->to segment passes through.
+// Elements must be removed before the positions they were inserted with change.
+class SpatialGrid
+{
+public:
+    explicit SpatialGrid(int cellSize = 64);
+
+    void insertVertex(Vertex *vertex);
+    void removeVertex(Vertex *vertex);
+    void insertEdge(Edge *edge);
+    void removeEdge(Edge *edge);
+    void clear();
+
+    // Edge cells in use and the edge entries across them; removing an edge
+    // scans each of its cells, so together they tell what that costs.
+    int edgeCellCount() const { return m_edgeCells.size(); }
+    qint64 edgeEntryCount() const { return m_edgeEntryCount; }
+
+    QVector<Vertex*> verticesNear(const QPoint &point, int radius) const;
+    QVector<Edge*> edgesNear(const QPoint &point, int radius) const;
+    QVector<Vertex*> verticesIn(const QRect &rect) const;
+    QVector<Edge*> edgesIn(const QRect &rect) const;
+
+private:
+    int cellCoordinate(double value) const;
+    quint64 cellKey(int cellX, int cellY) const;
+    template <typename Cells>
+    QVector<quint64> occupiedCellsIn(const QRect &rect, const Cells &cells) const;
+    QVector<quint64> cellsAlongSegment(const QPoint &start, const QPoint &end) const;
+
+    int m_cellSize;
+    QHash<quint64, QVector<Vertex*>> m_vertexCells;
+    QHash<quint64, QVector<Edge*>> m_edgeCells;
+    qint64 m_edgeEntryCount;
+};
+
+#endif
@@ -1,4 +1,5 @@
 #include "Vertex.h"
+#include "Edge.h"
 
 Vertex::Vertex(int id, const QPoint &position)
     : m_id(id)
@@ -6,56 +7,52 @@ Vertex::Vertex(int id, const QPoint &position)
 {
 }
 
-Vertex::~Vertex()
+void Vertex::addOutEdge(Edge *edge, EdgeArena &arena)
 {
-    for (Vertex *neighbor : m_outNeighbors) {
-        neighbor->m_inNeighbors.remove(this);
-    }
-
-    for (Vertex *neighbor : m_inNeighbors) {
-        neighbor->m_outNeighbors.remove(this);
-    }
-
-    m_outNeighbors.clear();
-    m_inNeighbors.clear();
+    m_outEdges.append(edge, arena);
+    edge->to()->m_inEdges.append(edge, arena);
 }
 
-void Vertex::addOutNeighbor(Vertex *neighbor)
+void Vertex::removeOutEdge(Edge *edge)
 {
-    if (neighbor != this && !hasOutNeighbor(neighbor)) {
-        m_outNeighbors.insert(neighbor);
-        neighbor->addInNeighbor(this);
-    }
+    m_outEdges.removeOne(edge);
+    edge->to()->m_inEdges.removeOne(edge);
 }
 
-void Vertex::addInNeighbor(Vertex *neighbor)
+// Unlinks every incident edge from the other endpoint and gives spilled
+// blocks back.
+void Vertex::releaseEdges(EdgeArena &arena)
 {
-    if (neighbor != this && !hasInNeighbor(neighbor)) {
-        m_inNeighbors.insert(neighbor);
+    for (Edge *edge : m_outEdges) {
+        edge->to()->m_inEdges.removeOne(edge);
     }
-}
 
-void Vertex::removeOutNeighbor(Vertex *neighbor)
-{
-    if (m_outNeighbors.contains(neighbor)) {
-        m_outNeighbors.remove(neighbor);
-        neighbor->removeInNeighbor(this);
+    for (Edge *edge : m_inEdges) {
+        edge->from()->m_outEdges.removeOne(edge);
     }
+
+    m_outEdges.release(arena);
+    m_inEdges.release(arena);
 }
 
-void Vertex::removeInNeighbor(Vertex *neighbor)
+bool Vertex::hasOutNeighbor(const Vertex *neighbor) const
 {
-    if (m_inNeighbors.contains(neighbor)) {
-        m_inNeighbors.remove(neighbor);
+    bool isFound = false;
+
+    for (int i = 0; i < m_outEdges.size() && !isFound; ++i) {
+        isFound = m_outEdges.at(i)->to() == neighbor;
     }
-}
 
-bool Vertex::hasOutNeighbor(Vertex *neighbor) const
-{
-    return m_outNeighbors.contains(neighbor);
+    return isFound;
 }
 
-bool Vertex::hasInNeighbor(Vertex *neighbor) const
+bool Vertex::hasInNeighbor(const Vertex *neighbor) const
 {
-    return m_inNeighbors.contains(neighbor);
-}
\ No newline at end of file
+    bool isFound = false;
+
+    for (int i = 0; i < m_inEdges.size() && !isFound; ++i) {
+        isFound = m_inEdges.at(i)->from() == neighbor;
+    }
+
+    return isFound;
+}
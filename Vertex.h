@@ -1,38 +1,41 @@
 #ifndef VERTEX_H
 #define VERTEX_H
 
+#include "EdgeList.h"
 #include <QPoint>
-#include <QSet>
 
+// Vertices are owned by a Graph, which allocates them from a slab pool and
+// links every edge into the out-list of its source and the in-list of its
+// target. Parallel edges appear once each.
 class Vertex
 {
 public:
     Vertex(int id, const QPoint &position);
-    ~Vertex();
 
     int id() const { return m_id; }
     QPoint position() const { return m_position; }
-    const QSet<Vertex*>& outNeighbors() const { return m_outNeighbors; }
-    const QSet<Vertex*>& inNeighbors() const { return m_inNeighbors; }
+    const EdgeList& outEdges() const { return m_outEdges; }
+    const EdgeList& inEdges() const { return m_inEdges; }
 
-    void setPosition(const QPoint &position) { m_position = position; }
+    bool hasOutNeighbor(const Vertex *neighbor) const;
+    bool hasInNeighbor(const Vertex *neighbor) const;
 
-    void addOutNeighbor(Vertex *neighbor);
-    void removeOutNeighbor(Vertex *neighbor);
-    bool hasOutNeighbor(Vertex *neighbor) const;
+    int outDegree() const { return m_outEdges.size(); }
+    int inDegree() const { return m_inEdges.size(); }
 
-    void addInNeighbor(Vertex *neighbor);
-    void removeInNeighbor(Vertex *neighbor);
-    bool hasInNeighbor(Vertex *neighbor) const;
+private:
+    friend class Graph;
 
-    int outDegree() const { return m_outNeighbors.size(); }
-    int inDegree() const { return m_inNeighbors.size(); }
+    void setPosition(const QPoint &position) { m_position = position; }
+
+    void addOutEdge(Edge *edge, EdgeArena &arena);
+    void removeOutEdge(Edge *edge);
+    void releaseEdges(EdgeArena &arena);
 
-private:
     int m_id;
     QPoint m_position;
-    QSet<Vertex*> m_outNeighbors;
-    QSet<Vertex*> m_inNeighbors;
+    EdgeList m_outEdges;
+    EdgeList m_inEdges;
 };
 
-#endif
\ No newline at end of file
+#endif
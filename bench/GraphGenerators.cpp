@@ -0,0 +1,265 @@
+#include "GraphGenerators.h"
+#include <QRandomGenerator>
+#include <QtMath>
+#include <algorithm>
+
+namespace {
+const int SPACING = 60;
+const int ER_DEGREE = 8;
+const int ATTACHMENTS = 4;
+const int LAYER_FAN_OUT = 4;
+}
+
+GraphSnapshot GraphGenerators::erdosRenyi(int edgeCount, quint32 seed)
+{
+    int vertexCount = qMax(2, edgeCount / ER_DEGREE);
+    QRandomGenerator random(seed);
+    QVector<int> sources(edgeCount);
+    QVector<int> targets(edgeCount);
+
+    for (int i = 0; i < edgeCount; ++i) {
+        sources[i] = random.bounded(vertexCount);
+        targets[i] = random.bounded(vertexCount);
+    }
+
+    return fromEdgeList(scatter(vertexCount, seed), sources, targets, seed);
+}
+
+GraphSnapshot GraphGenerators::grid(int edgeCount, quint32 seed)
+{
+    int side = 2;
+    while (2LL * side * (side - 1) < edgeCount) {
+        side++;
+    }
+
+    QVector<QPoint> positions(side * side);
+    QVector<int> sources;
+    QVector<int> targets;
+    sources.reserve(2 * side * (side - 1));
+    targets.reserve(2 * side * (side - 1));
+
+    for (int row = 0; row < side; ++row) {
+        for (int column = 0; column < side; ++column) {
+            int vertex = row * side + column;
+            positions[vertex] = QPoint(column * SPACING, row * SPACING);
+            if (column + 1 < side) {
+                sources.append(vertex);
+                targets.append(vertex + 1);
+            }
+            if (row + 1 < side) {
+                sources.append(vertex);
+                targets.append(vertex + side);
+            }
+        }
+    }
+
+    return fromEdgeList(positions, sources, targets, seed);
+}
+
+GraphSnapshot GraphGenerators::roadNetwork(int edgeCount, quint32 seed)
+{
+    int side = 2;
+    while (4LL * side * (side - 1) < edgeCount) {
+        side++;
+    }
+
+    QRandomGenerator random(seed);
+    QVector<QPoint> positions(side * side);
+    QVector<int> sources;
+    QVector<int> targets;
+    sources.reserve(4 * side * (side - 1));
+    targets.reserve(4 * side * (side - 1));
+
+    for (int row = 0; row < side; ++row) {
+        for (int column = 0; column < side; ++column) {
+            int vertex = row * side + column;
+            positions[vertex] = QPoint(column * SPACING + random.bounded(SPACING / 2),
+                                       row * SPACING + random.bounded(SPACING / 2));
+            if (column + 1 < side) {
+                sources << vertex << vertex + 1;
+                targets << vertex + 1 << vertex;
+            }
+            if (row + 1 < side) {
+                sources << vertex << vertex + side;
+                targets << vertex + side << vertex;
+            }
+        }
+    }
+
+    return withGeometricWeights(fromEdgeList(positions, sources, targets, seed), seed);
+}
+
+GraphSnapshot GraphGenerators::scaleFree(int edgeCount, quint32 seed)
+{
+    int vertexCount = qMax(2, edgeCount / ATTACHMENTS + 1);
+    QRandomGenerator random(seed);
+    QVector<int> sources;
+    QVector<int> targets;
+    QVector<int> endpoints;
+    sources.reserve(edgeCount);
+    targets.reserve(edgeCount);
+    endpoints.reserve(2 * edgeCount + 1);
+    endpoints.append(0);
+
+    for (int vertex = 1; vertex < vertexCount; ++vertex) {
+        for (int k = 0; k < ATTACHMENTS; ++k) {
+            int other = endpoints[random.bounded(endpoints.size())];
+            bool isOutgoing = random.bounded(2) == 0;
+            sources.append(isOutgoing ? vertex : other);
+            targets.append(isOutgoing ? other : vertex);
+            endpoints.append(other);
+        }
+        for (int k = 0; k < ATTACHMENTS; ++k) {
+            endpoints.append(vertex);
+        }
+    }
+
+    return fromEdgeList(scatter(vertexCount, seed), sources, targets, seed);
+}
+
+GraphSnapshot GraphGenerators::chain(int edgeCount, bool isClosed, quint32 seed)
+{
+    int vertexCount = qMax(2, isClosed ? edgeCount : edgeCount + 1);
+    int columns = qMax(1, qCeil(qSqrt(vertexCount)));
+    QVector<QPoint> positions(vertexCount);
+    QVector<int> sources(vertexCount - 1);
+    QVector<int> targets(vertexCount - 1);
+
+    for (int vertex = 0; vertex < vertexCount; ++vertex) {
+        int row = vertex / columns;
+        int column = row % 2 == 0 ? vertex % columns : columns - 1 - vertex % columns;
+        positions[vertex] = QPoint(column * SPACING, row * SPACING);
+        if (vertex + 1 < vertexCount) {
+            sources[vertex] = vertex;
+            targets[vertex] = vertex + 1;
+        }
+    }
+
+    if (isClosed) {
+        sources.append(vertexCount - 1);
+        targets.append(0);
+    }
+
+    return fromEdgeList(positions, sources, targets, seed);
+}
+
+GraphSnapshot GraphGenerators::dagLayers(int edgeCount, quint32 seed)
+{
+    int width = qMax(LAYER_FAN_OUT, qFloor(qSqrt(edgeCount) / 2));
+    int layers = qMax(2, edgeCount / (LAYER_FAN_OUT * width) + 1);
+    QRandomGenerator random(seed);
+    QVector<QPoint> positions(layers * width);
+    QVector<int> sources;
+    QVector<int> targets;
+    sources.reserve((layers - 1) * width * LAYER_FAN_OUT);
+    targets.reserve((layers - 1) * width * LAYER_FAN_OUT);
+
+    for (int layer = 0; layer < layers; ++layer) {
+        for (int j = 0; j < width; ++j) {
+            int vertex = layer * width + j;
+            positions[vertex] = QPoint(layer * SPACING, j * SPACING);
+            if (layer + 1 < layers) {
+                sources.append(vertex);
+                targets.append(vertex + width);
+                for (int k = 1; k < LAYER_FAN_OUT; ++k) {
+                    sources.append(vertex);
+                    targets.append((layer + 1) * width + random.bounded(width));
+                }
+            }
+        }
+    }
+
+    return fromEdgeList(positions, sources, targets, seed);
+}
+
+// Buckets the edge list by source, drops self-loops and duplicates and
+// assigns weights in slot order.
+GraphSnapshot GraphGenerators::fromEdgeList(const QVector<QPoint> &positions, const QVector<int> &sources,
+                                            const QVector<int> &targets, quint32 seed)
+{
+    int vertexCount = positions.size();
+    QVector<int> vertexIds(vertexCount);
+    QVector<int> outOffsets(vertexCount + 1, 0);
+
+    for (int vertex = 0; vertex < vertexCount; ++vertex) {
+        vertexIds[vertex] = vertex + 1;
+    }
+
+    for (int i = 0; i < sources.size(); ++i) {
+        outOffsets[sources[i] + 1]++;
+    }
+
+    for (int vertex = 0; vertex < vertexCount; ++vertex) {
+        outOffsets[vertex + 1] += outOffsets[vertex];
+    }
+
+    QVector<int> bucketed(sources.size());
+    QVector<int> cursor(outOffsets.begin(), outOffsets.end() - 1);
+
+    for (int i = 0; i < sources.size(); ++i) {
+        bucketed[cursor[sources[i]]++] = targets[i];
+    }
+
+    QVector<int> compactOffsets(vertexCount + 1, 0);
+    QVector<int> compactTargets;
+    compactTargets.reserve(bucketed.size());
+
+    for (int vertex = 0; vertex < vertexCount; ++vertex) {
+        int begin = outOffsets[vertex];
+        int end = outOffsets[vertex + 1];
+        std::sort(bucketed.begin() + begin, bucketed.begin() + end);
+        for (int slot = begin; slot < end; ++slot) {
+            bool isDuplicate = slot > begin && bucketed[slot] == bucketed[slot - 1];
+            if (bucketed[slot] != vertex && !isDuplicate) {
+                compactTargets.append(bucketed[slot]);
+            }
+        }
+        compactOffsets[vertex + 1] = compactTargets.size();
+    }
+
+    QRandomGenerator random(seed ^ 0x9e3779b9u);
+    QVector<int> weights(compactTargets.size());
+
+    for (int i = 0; i < weights.size(); ++i) {
+        weights[i] = 1 + random.bounded(100);
+    }
+
+    return GraphSnapshot(vertexIds, positions, compactOffsets, compactTargets, weights);
+}
+
+QVector<QPoint> GraphGenerators::scatter(int vertexCount, quint32 seed)
+{
+    int side = qMax(1, qCeil(qSqrt(vertexCount))) * SPACING;
+    QRandomGenerator random(seed + 1);
+    QVector<QPoint> positions(vertexCount);
+
+    for (int vertex = 0; vertex < vertexCount; ++vertex) {
+        positions[vertex] = QPoint(random.bounded(side), random.bounded(side));
+    }
+
+    return positions;
+}
+
+GraphSnapshot GraphGenerators::withGeometricWeights(const GraphSnapshot &snapshot, quint32 seed)
+{
+    QRandomGenerator random(seed ^ 0x85ebca6bu);
+    QVector<int> vertexIds(snapshot.vertexCount());
+    QVector<QPoint> positions(snapshot.vertexCount());
+    QVector<int> outOffsets(snapshot.vertexCount() + 1, 0);
+    QVector<int> targets(snapshot.edgeCount());
+    QVector<int> weights(snapshot.edgeCount());
+
+    for (int vertex = 0; vertex < snapshot.vertexCount(); ++vertex) {
+        vertexIds[vertex] = snapshot.vertexId(vertex);
+        positions[vertex] = snapshot.position(vertex);
+        outOffsets[vertex + 1] = snapshot.outEnd(vertex);
+        for (int edge = snapshot.outBegin(vertex); edge < snapshot.outEnd(vertex); ++edge) {
+            QPoint delta = snapshot.position(snapshot.target(edge)) - snapshot.position(vertex);
+            double length = qSqrt(static_cast<double>(delta.x()) * delta.x() + static_cast<double>(delta.y()) * delta.y());
+            targets[edge] = snapshot.target(edge);
+            weights[edge] = qCeil(length * (1.0 + random.bounded(0.5)));
+        }
+    }
+
+    return GraphSnapshot(vertexIds, positions, outOffsets, targets, weights);
+}
@@ -0,0 +1,37 @@
+#ifndef GRAPHGENERATORS_H
+#define GRAPHGENERATORS_H
+
+#include "GraphSnapshot.h"
+
+// Deterministic synthetic graphs for graph_bench. Every generator takes a
+// target edge count and picks the vertex count that gets closest to it;
+// vertex ids are 1..n, positions are spread over a canvas that grows with n
+// and weights are drawn from 1..100. Self-loops and duplicate edges are
+// dropped, so a snapshot survives Graph::loadSnapshot unchanged.
+class GraphGenerators
+{
+public:
+    // Random directed graph with average out-degree 8.
+    static GraphSnapshot erdosRenyi(int edgeCount, quint32 seed = 1);
+    // Square grid with edges to the right and lower neighbours. Every vertex
+    // is reachable from index 0; the last index is the far corner.
+    static GraphSnapshot grid(int edgeCount, quint32 seed = 1);
+    // Road-like: a grid with jittered positions and two-way streets whose
+    // weights are their drawn length times a random detour factor of 1..1.5.
+    static GraphSnapshot roadNetwork(int edgeCount, quint32 seed = 1);
+    // Preferential attachment, 4 edges per new vertex in random directions.
+    static GraphSnapshot scaleFree(int edgeCount, quint32 seed = 1);
+    // Path 0 -> 1 -> ... -> n-1; closing it back to 0 makes it a cycle.
+    static GraphSnapshot chain(int edgeCount, bool isClosed = false, quint32 seed = 1);
+    // Layers of equal width; vertex j of a layer links to vertex j of the next
+    // layer and to 3 random others there.
+    static GraphSnapshot dagLayers(int edgeCount, quint32 seed = 1);
+
+private:
+    static GraphSnapshot fromEdgeList(const QVector<QPoint> &positions, const QVector<int> &sources,
+                                      const QVector<int> &targets, quint32 seed);
+    static QVector<QPoint> scatter(int vertexCount, quint32 seed);
+    static GraphSnapshot withGeometricWeights(const GraphSnapshot &snapshot, quint32 seed);
+};
+
+#endif
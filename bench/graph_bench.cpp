@@ -0,0 +1,585 @@
+#include "GraphGenerators.h"
+#include "Graph.h"
+#include "GraphAlgorithms.h"
+#include "GraphFile.h"
+#include "EdgeListImporter.h"
+#include "ContractionHierarchy.h"
+#include <benchmark/benchmark.h>
+#include <QFile>
+#include <QHash>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+#include <atomic>
+#include <utility>
+
+// Sizes are target edge counts. Run with --benchmark_format=json (or the
+// graph_bench_json target) to get results that can be compared across commits.
+namespace {
+
+const int MIN_EDGES = 1000;
+const int MAX_EDGES = 10000000;
+const int HIT_TEST_QUERIES = 1024;
+const int MULTI_SOURCE_COUNT = 64;
+const int QUERY_PAIR_COUNT = 64;
+// Contraction hierarchy preprocessing grows faster than linearly on the
+// grid-like road proxy.
+const int MAX_HIERARCHY_EDGES = 100000;
+
+enum class Shape { ErdosRenyi, Grid, RoadNetwork, ScaleFree, Chain, Cycle, DagLayers };
+
+// Keeps the most recent graph per shape; google benchmark calls each
+// function several times per size while it settles on an iteration count.
+const GraphSnapshot &generated(Shape shape, int edgeCount)
+{
+    static QHash<int, QPair<int, GraphSnapshot>> cache;
+    int key = static_cast<int>(shape);
+
+    if (!cache.contains(key) || cache[key].first != edgeCount) {
+        GraphSnapshot snapshot;
+        switch (shape) {
+        case Shape::ErdosRenyi:
+            snapshot = GraphGenerators::erdosRenyi(edgeCount);
+            break;
+        case Shape::Grid:
+            snapshot = GraphGenerators::grid(edgeCount);
+            break;
+        case Shape::RoadNetwork:
+            snapshot = GraphGenerators::roadNetwork(edgeCount);
+            break;
+        case Shape::ScaleFree:
+            snapshot = GraphGenerators::scaleFree(edgeCount);
+            break;
+        case Shape::Chain:
+            snapshot = GraphGenerators::chain(edgeCount);
+            break;
+        case Shape::Cycle:
+            snapshot = GraphGenerators::chain(edgeCount, true);
+            break;
+        case Shape::DagLayers:
+            snapshot = GraphGenerators::dagLayers(edgeCount);
+            break;
+        }
+        cache.insert(key, qMakePair(edgeCount, snapshot));
+    }
+
+    return cache[key].second;
+}
+
+QString scratchFile()
+{
+    static QTemporaryDir directory;
+    return directory.filePath("graph_bench.graph");
+}
+
+// The snapshot as a SNAP edge list: "from<TAB>to<TAB>weight" per line.
+void writeEdgeList(const GraphSnapshot &snapshot, const QString &filename)
+{
+    QByteArray text;
+    for (int vertex = 0; vertex < snapshot.vertexCount(); ++vertex) {
+        for (int edge = snapshot.outBegin(vertex); edge < snapshot.outEnd(vertex); ++edge) {
+            text += QByteArray::number(snapshot.vertexId(vertex)) + '\t'
+                + QByteArray::number(snapshot.vertexId(snapshot.target(edge))) + '\t'
+                + QByteArray::number(snapshot.weight(edge)) + '\n';
+        }
+    }
+
+    QFile file(filename);
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write(text);
+    }
+}
+
+// Fixed random start/end index pairs, so every method answers the same queries.
+QVector<QPair<int, int>> queryPairs(const GraphSnapshot &snapshot)
+{
+    QRandomGenerator random(7);
+    QVector<QPair<int, int>> pairs;
+
+    while (pairs.size() < QUERY_PAIR_COUNT) {
+        int start = random.bounded(snapshot.vertexCount());
+        int end = random.bounded(snapshot.vertexCount());
+        if (start != end) {
+            pairs.append(qMakePair(start, end));
+        }
+    }
+
+    return pairs;
+}
+
+void setCounters(benchmark::State &state, const GraphSnapshot &snapshot)
+{
+    state.counters["vertices"] = snapshot.vertexCount();
+    state.counters["edges"] = snapshot.edgeCount();
+    state.SetItemsProcessed(state.iterations() * snapshot.edgeCount());
+}
+
+void edgeSizes(benchmark::internal::Benchmark *benchmark)
+{
+    benchmark->RangeMultiplier(10)->Range(MIN_EDGES, MAX_EDGES)->Unit(benchmark::kMillisecond);
+}
+
+} // namespace
+
+static void BM_AddEdges(benchmark::State &state)
+{
+    const GraphSnapshot &snapshot = generated(Shape::ErdosRenyi, state.range(0));
+
+    for (auto _ : state) {
+        Graph graph;
+        QVector<Vertex*> vertices(snapshot.vertexCount());
+        for (int v = 0; v < snapshot.vertexCount(); ++v) {
+            vertices[v] = graph.addVertex(snapshot.position(v));
+        }
+        for (int v = 0; v < snapshot.vertexCount(); ++v) {
+            for (int edge = snapshot.outBegin(v); edge < snapshot.outEnd(v); ++edge) {
+                graph.addEdge(vertices[v], vertices[snapshot.target(edge)]);
+            }
+        }
+        benchmark::DoNotOptimize(graph.edgeCount());
+        state.PauseTiming();
+        graph.clear();
+        state.ResumeTiming();
+    }
+
+    setCounters(state, snapshot);
+}
+BENCHMARK(BM_AddEdges)->Apply(edgeSizes);
+
+static void BM_EdgeLookup(benchmark::State &state)
+{
+    const GraphSnapshot &snapshot = generated(Shape::ErdosRenyi, state.range(0));
+    Graph graph;
+    graph.loadSnapshot(snapshot);
+
+    for (auto _ : state) {
+        int hits = 0;
+        for (Edge *edge : graph.edges()) {
+            hits += graph.getEdge(edge->from(), edge->to()) ? 1 : 0;
+            hits += graph.getEdgeById(edge->id()) ? 1 : 0;
+        }
+        benchmark::DoNotOptimize(hits);
+    }
+
+    setCounters(state, snapshot);
+}
+BENCHMARK(BM_EdgeLookup)->Apply(edgeSizes);
+
+static void BM_LoadSnapshot(benchmark::State &state)
+{
+    const GraphSnapshot &snapshot = generated(Shape::ErdosRenyi, state.range(0));
+
+    for (auto _ : state) {
+        Graph graph;
+        graph.loadSnapshot(snapshot);
+        benchmark::DoNotOptimize(graph.edgeCount());
+        state.PauseTiming();
+        graph.clear();
+        state.ResumeTiming();
+    }
+
+    setCounters(state, snapshot);
+}
+BENCHMARK(BM_LoadSnapshot)->Apply(edgeSizes);
+
+static void BM_TakeSnapshot(benchmark::State &state)
+{
+    const GraphSnapshot &snapshot = generated(Shape::ErdosRenyi, state.range(0));
+    Graph graph;
+    graph.loadSnapshot(snapshot);
+
+    for (auto _ : state) {
+        GraphSnapshot copy = graph.snapshot();
+        benchmark::DoNotOptimize(copy.edgeCount());
+    }
+
+    setCounters(state, snapshot);
+}
+BENCHMARK(BM_TakeSnapshot)->Apply(edgeSizes);
+
+static void BM_SaveToFile(benchmark::State &state, GraphFile::Encoding encoding)
+{
+    const GraphSnapshot &snapshot = generated(Shape::ErdosRenyi, state.range(0));
+    Graph graph;
+    graph.loadSnapshot(snapshot);
+    QString filename = scratchFile();
+
+    for (auto _ : state) {
+        if (!graph.saveToFile(filename, encoding)) {
+            state.SkipWithError("saveToFile failed");
+        }
+    }
+
+    setCounters(state, snapshot);
+}
+BENCHMARK_CAPTURE(BM_SaveToFile, fixed, GraphFile::Encoding::Fixed)->Apply(edgeSizes);
+BENCHMARK_CAPTURE(BM_SaveToFile, varint, GraphFile::Encoding::Varint)->Apply(edgeSizes);
+
+static void BM_LoadFromFile(benchmark::State &state, GraphFile::Encoding encoding)
+{
+    const GraphSnapshot &snapshot = generated(Shape::ErdosRenyi, state.range(0));
+    QString filename = scratchFile();
+    GraphFile::write(snapshot, filename, encoding);
+
+    for (auto _ : state) {
+        Graph graph;
+        if (!graph.loadFromFile(filename)) {
+            state.SkipWithError("loadFromFile failed");
+        }
+        state.PauseTiming();
+        graph.clear();
+        state.ResumeTiming();
+    }
+
+    setCounters(state, snapshot);
+}
+BENCHMARK_CAPTURE(BM_LoadFromFile, fixed, GraphFile::Encoding::Fixed)->Apply(edgeSizes);
+BENCHMARK_CAPTURE(BM_LoadFromFile, varint, GraphFile::Encoding::Varint)->Apply(edgeSizes);
+
+static void BM_ReadSnapshot(benchmark::State &state, GraphFile::Encoding encoding)
+{
+    const GraphSnapshot &snapshot = generated(Shape::ErdosRenyi, state.range(0));
+    QString filename = scratchFile();
+    GraphFile::write(snapshot, filename, encoding);
+
+    for (auto _ : state) {
+        GraphSnapshot loaded;
+        if (!GraphFile::read(filename, loaded)) {
+            state.SkipWithError("GraphFile::read failed");
+        }
+        benchmark::DoNotOptimize(loaded.edgeCount());
+    }
+
+    setCounters(state, snapshot);
+}
+BENCHMARK_CAPTURE(BM_ReadSnapshot, fixed, GraphFile::Encoding::Fixed)->Apply(edgeSizes);
+BENCHMARK_CAPTURE(BM_ReadSnapshot, varint, GraphFile::Encoding::Varint)->Apply(edgeSizes);
+
+static void BM_ImportEdgeList(benchmark::State &state)
+{
+    const GraphSnapshot &snapshot = generated(Shape::ErdosRenyi, state.range(0));
+    QString filename = scratchFile() + ".txt";
+    writeEdgeList(snapshot, filename);
+    EdgeListImporter importer;
+
+    for (auto _ : state) {
+        GraphSnapshot imported;
+        if (!importer.read(filename, EdgeListImporter::Format::Snap, imported)) {
+            state.SkipWithError("EdgeListImporter::read failed");
+        }
+        benchmark::DoNotOptimize(imported.edgeCount());
+    }
+
+    setCounters(state, snapshot);
+}
+BENCHMARK(BM_ImportEdgeList)->Apply(edgeSizes);
+
+static void BM_TopologicalSort(benchmark::State &state, Shape shape)
+{
+    const GraphSnapshot &snapshot = generated(shape, state.range(0));
+
+    for (auto _ : state) {
+        VertexSequenceResult result = GraphAlgorithms::topologicalSort(snapshot);
+        benchmark::DoNotOptimize(result.vertexIds.data());
+    }
+
+    setCounters(state, snapshot);
+}
+BENCHMARK_CAPTURE(BM_TopologicalSort, dag_layers, Shape::DagLayers)->Apply(edgeSizes);
+BENCHMARK_CAPTURE(BM_TopologicalSort, chain, Shape::Chain)->Apply(edgeSizes);
+
+// An edit followed by a query, as in a DAG editor: each iteration inserts
+// an edge that agrees with the order and asks again. The graph tracks its
+// components, so the query only copies the maintained order out.
+static void BM_TrackedTopologicalSort(benchmark::State &state)
+{
+    const GraphSnapshot &snapshot = generated(Shape::DagLayers, state.range(0));
+    QVector<QPair<int, int>> pairs = queryPairs(snapshot);
+    Graph graph;
+    graph.loadSnapshot(snapshot);
+    graph.setTracksComponents(true);
+
+    const DynamicComponents &tracked = *graph.strongComponents();
+    QHash<int, int> positionOf;
+    for (int component : tracked.topologicalOrder()) {
+        positionOf.insert(tracked.members(component).first()->id(), positionOf.size());
+    }
+
+    int next = 0;
+    for (auto _ : state) {
+        Vertex *from = graph.vertices()[pairs[next].first];
+        Vertex *to = graph.vertices()[pairs[next].second];
+        if (positionOf.value(from->id()) > positionOf.value(to->id())) {
+            std::swap(from, to);
+        }
+        graph.addEdge(from, to);
+        next = (next + 1) % pairs.size();
+
+        VertexSequenceResult result = GraphAlgorithms::topologicalSort(&graph);
+        benchmark::DoNotOptimize(result.vertexIds.data());
+    }
+
+    setCounters(state, snapshot);
+}
+BENCHMARK(BM_TrackedTopologicalSort)->Apply(edgeSizes);
+
+static void BM_EulerianCycle(benchmark::State &state)
+{
+    const GraphSnapshot &snapshot = generated(Shape::Cycle, state.range(0));
+
+    for (auto _ : state) {
+        VertexSequenceResult result = GraphAlgorithms::eulerianCycle(snapshot);
+        benchmark::DoNotOptimize(result.vertexIds.data());
+    }
+
+    setCounters(state, snapshot);
+}
+BENCHMARK(BM_EulerianCycle)->Apply(edgeSizes);
+
+static void BM_EulerianPath(benchmark::State &state)
+{
+    const GraphSnapshot &snapshot = generated(Shape::Chain, state.range(0));
+
+    for (auto _ : state) {
+        VertexSequenceResult result = GraphAlgorithms::eulerianPath(snapshot);
+        benchmark::DoNotOptimize(result.vertexIds.data());
+    }
+
+    setCounters(state, snapshot);
+}
+BENCHMARK(BM_EulerianPath)->Apply(edgeSizes);
+
+static void BM_Dijkstra(benchmark::State &state, Shape shape, GraphAlgorithms::PriorityQueueKind queue)
+{
+    const GraphSnapshot &snapshot = generated(shape, state.range(0));
+    int startId = snapshot.vertexId(0);
+    int endId = snapshot.vertexId(snapshot.vertexCount() - 1);
+
+    for (auto _ : state) {
+        ShortestPathResult result = GraphAlgorithms::dijkstra(snapshot, startId, endId, queue);
+        benchmark::DoNotOptimize(result.distance);
+    }
+
+    setCounters(state, snapshot);
+}
+BENCHMARK_CAPTURE(BM_Dijkstra, grid_radix, Shape::Grid, GraphAlgorithms::PriorityQueueKind::RadixHeap)->Apply(edgeSizes);
+BENCHMARK_CAPTURE(BM_Dijkstra, grid_dary, Shape::Grid, GraphAlgorithms::PriorityQueueKind::DaryHeap)->Apply(edgeSizes);
+BENCHMARK_CAPTURE(BM_Dijkstra, erdos_renyi_radix, Shape::ErdosRenyi, GraphAlgorithms::PriorityQueueKind::RadixHeap)->Apply(edgeSizes);
+BENCHMARK_CAPTURE(BM_Dijkstra, erdos_renyi_dary, Shape::ErdosRenyi, GraphAlgorithms::PriorityQueueKind::DaryHeap)->Apply(edgeSizes);
+
+// Second argument is the thread count; wall time is what should shrink.
+static void BM_MultiSourcePaths(benchmark::State &state, Shape shape, MultiSourcePaths::Metric metric)
+{
+    const GraphSnapshot &snapshot = generated(shape, state.range(0));
+    QVector<int> sources;
+    for (int i = 0; i < MULTI_SOURCE_COUNT; ++i) {
+        sources.append(static_cast<int>(static_cast<qint64>(i) * snapshot.vertexCount() / MULTI_SOURCE_COUNT));
+    }
+
+    MultiSourcePaths paths(snapshot, state.range(1));
+    for (auto _ : state) {
+        std::atomic<qint64> reachedCount(0);
+        paths.run(sources, metric, [&reachedCount](int, const QVector<int> &, const QVector<int> &reached) {
+            reachedCount += reached.size();
+        });
+        benchmark::DoNotOptimize(reachedCount.load());
+    }
+
+    setCounters(state, snapshot);
+}
+BENCHMARK_CAPTURE(BM_MultiSourcePaths, grid_hops, Shape::Grid, MultiSourcePaths::Metric::Hops)
+    ->ArgsProduct({{100000, 1000000}, {1, 2, 4, 8}})->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_MultiSourcePaths, scale_free_hops, Shape::ScaleFree, MultiSourcePaths::Metric::Hops)
+    ->ArgsProduct({{100000, 1000000}, {1, 2, 4, 8}})->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_MultiSourcePaths, erdos_renyi_weights, Shape::ErdosRenyi, MultiSourcePaths::Metric::Weights)
+    ->ArgsProduct({{100000, 1000000}, {1, 2, 4, 8}})->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// One iteration answers QUERY_PAIR_COUNT queries. Landmarks are built by a
+// warm-up query outside the timed loop, as an interactive session would.
+static void BM_PointToPoint(benchmark::State &state, PointToPointSearch::Method method)
+{
+    const GraphSnapshot &snapshot = generated(Shape::RoadNetwork, state.range(0));
+    QVector<QPair<int, int>> pairs = queryPairs(snapshot);
+    PointToPointSearch search(snapshot);
+    search.run(pairs[0].first, pairs[0].second, method);
+
+    qint64 settledCount = 0;
+    for (auto _ : state) {
+        for (const QPair<int, int> &pair : pairs) {
+            PointToPointSearch::Result result = search.run(pair.first, pair.second, method);
+            settledCount += result.settledCount;
+        }
+    }
+
+    setCounters(state, snapshot);
+    state.counters["settled_per_query"] = static_cast<double>(settledCount) / (state.iterations() * pairs.size());
+}
+BENCHMARK_CAPTURE(BM_PointToPoint, bidirectional, PointToPointSearch::Method::Bidirectional)->Apply(edgeSizes);
+BENCHMARK_CAPTURE(BM_PointToPoint, astar, PointToPointSearch::Method::AStar)->Apply(edgeSizes);
+BENCHMARK_CAPTURE(BM_PointToPoint, landmarks, PointToPointSearch::Method::Landmarks)->Apply(edgeSizes);
+
+// Baseline for BM_PointToPoint: the same queries through plain Dijkstra.
+static void BM_PointToPointDijkstra(benchmark::State &state)
+{
+    const GraphSnapshot &snapshot = generated(Shape::RoadNetwork, state.range(0));
+    QVector<QPair<int, int>> pairs = queryPairs(snapshot);
+
+    for (auto _ : state) {
+        for (const QPair<int, int> &pair : pairs) {
+            ShortestPathResult result = GraphAlgorithms::dijkstra(snapshot, snapshot.vertexId(pair.first),
+                                                                  snapshot.vertexId(pair.second));
+            benchmark::DoNotOptimize(result.distance);
+        }
+    }
+
+    setCounters(state, snapshot);
+}
+BENCHMARK(BM_PointToPointDijkstra)->Apply(edgeSizes);
+
+static void BM_ContractionHierarchyBuild(benchmark::State &state)
+{
+    const GraphSnapshot &snapshot = generated(Shape::RoadNetwork, state.range(0));
+
+    int arcCount = 0;
+    for (auto _ : state) {
+        ContractionHierarchy hierarchy;
+        hierarchy.build(snapshot);
+        arcCount = hierarchy.arcCount();
+    }
+
+    setCounters(state, snapshot);
+    state.counters["arcs"] = arcCount;
+}
+BENCHMARK(BM_ContractionHierarchyBuild)->RangeMultiplier(10)->Range(MIN_EDGES, MAX_HIERARCHY_EDGES)
+    ->Iterations(1)->Unit(benchmark::kMillisecond);
+
+// Same queries as BM_PointToPoint; the hierarchy is built once per size.
+static void BM_ContractionHierarchyQuery(benchmark::State &state)
+{
+    static ContractionHierarchy hierarchy;
+    static int hierarchyEdges = 0;
+    const GraphSnapshot &snapshot = generated(Shape::RoadNetwork, state.range(0));
+    QVector<QPair<int, int>> pairs = queryPairs(snapshot);
+
+    if (hierarchyEdges != state.range(0)) {
+        hierarchy.build(snapshot);
+        hierarchyEdges = state.range(0);
+    }
+    ContractionHierarchy::Query query(hierarchy);
+
+    qint64 settledCount = 0;
+    for (auto _ : state) {
+        for (const QPair<int, int> &pair : pairs) {
+            ContractionHierarchy::Result result = query.run(pair.first, pair.second);
+            settledCount += result.settledCount;
+        }
+    }
+
+    setCounters(state, snapshot);
+    state.counters["settled_per_query"] = static_cast<double>(settledCount) / (state.iterations() * pairs.size());
+}
+BENCHMARK(BM_ContractionHierarchyQuery)->RangeMultiplier(10)->Range(MIN_EDGES, MAX_HIERARCHY_EDGES);
+
+static void BM_MaxFlow(benchmark::State &state, MaxFlow::Method method)
+{
+    const GraphSnapshot &snapshot = generated(Shape::Grid, state.range(0));
+    int sourceId = snapshot.vertexId(0);
+    int sinkId = snapshot.vertexId(snapshot.vertexCount() - 1);
+
+    for (auto _ : state) {
+        MaxFlowResult result = GraphAlgorithms::maxFlow(snapshot, sourceId, sinkId, method);
+        benchmark::DoNotOptimize(result.value);
+    }
+
+    setCounters(state, snapshot);
+}
+BENCHMARK_CAPTURE(BM_MaxFlow, dinic, MaxFlow::Method::Dinic)->Apply(edgeSizes);
+BENCHMARK_CAPTURE(BM_MaxFlow, push_relabel, MaxFlow::Method::PushRelabel)->Apply(edgeSizes);
+
+static void BM_StronglyConnectedComponents(benchmark::State &state, Shape shape)
+{
+    const GraphSnapshot &snapshot = generated(shape, state.range(0));
+
+    for (auto _ : state) {
+        ComponentsResult result = GraphAlgorithms::stronglyConnectedComponents(snapshot);
+        benchmark::DoNotOptimize(result.components.data());
+    }
+
+    setCounters(state, snapshot);
+}
+BENCHMARK_CAPTURE(BM_StronglyConnectedComponents, erdos_renyi, Shape::ErdosRenyi)->Apply(edgeSizes);
+BENCHMARK_CAPTURE(BM_StronglyConnectedComponents, scale_free, Shape::ScaleFree)->Apply(edgeSizes);
+BENCHMARK_CAPTURE(BM_StronglyConnectedComponents, cycle, Shape::Cycle)->Apply(edgeSizes);
+
+// One iteration inserts and deletes QUERY_PAIR_COUNT edges on a graph that
+// tracks its components. Edges closing a cycle merge components on insert
+// and split them again on delete.
+static void BM_TrackedComponentsEdit(benchmark::State &state, Shape shape)
+{
+    const GraphSnapshot &snapshot = generated(shape, state.range(0));
+    QVector<QPair<int, int>> pairs = queryPairs(snapshot);
+    Graph graph;
+    graph.loadSnapshot(snapshot);
+    graph.setTracksComponents(true);
+
+    for (auto _ : state) {
+        for (const QPair<int, int> &pair : pairs) {
+            Vertex *from = graph.vertices()[pair.first];
+            Vertex *to = graph.vertices()[pair.second];
+            if (!graph.areConnected(from, to)) {
+                graph.addEdge(from, to);
+                graph.removeEdge(from, to);
+            }
+        }
+    }
+
+    setCounters(state, snapshot);
+    state.counters["components"] = graph.strongComponents()->componentCount();
+}
+BENCHMARK_CAPTURE(BM_TrackedComponentsEdit, dag_layers, Shape::DagLayers)->Apply(edgeSizes);
+BENCHMARK_CAPTURE(BM_TrackedComponentsEdit, scale_free, Shape::ScaleFree)->Apply(edgeSizes);
+
+static void BM_VertexDegrees(benchmark::State &state)
+{
+    const GraphSnapshot &snapshot = generated(Shape::ScaleFree, state.range(0));
+
+    for (auto _ : state) {
+        DegreesResult result = GraphAlgorithms::vertexDegrees(snapshot);
+        benchmark::DoNotOptimize(result.degrees.data());
+    }
+
+    setCounters(state, snapshot);
+}
+BENCHMARK(BM_VertexDegrees)->Apply(edgeSizes);
+
+// Each iteration answers HIT_TEST_QUERIES lookups at random canvas points
+// near existing vertices, so both hits and near misses are exercised.
+static void BM_HitTest(benchmark::State &state, bool isEdgeQuery)
+{
+    const GraphSnapshot &snapshot = generated(Shape::ErdosRenyi, state.range(0));
+    Graph graph;
+    graph.loadSnapshot(snapshot);
+
+    QRandomGenerator random(7);
+    QVector<QPoint> queries(HIT_TEST_QUERIES);
+    for (int i = 0; i < queries.size(); ++i) {
+        QPoint jitter(random.bounded(-30, 31), random.bounded(-30, 31));
+        queries[i] = snapshot.position(random.bounded(snapshot.vertexCount())) + jitter;
+    }
+
+    for (auto _ : state) {
+        int hits = 0;
+        for (const QPoint &point : queries) {
+            bool isHit = isEdgeQuery ? graph.findEdgeAt(point) != nullptr : graph.findVertexAt(point) != nullptr;
+            hits += isHit ? 1 : 0;
+        }
+        benchmark::DoNotOptimize(hits);
+    }
+
+    state.counters["vertices"] = snapshot.vertexCount();
+    state.counters["edges"] = snapshot.edgeCount();
+    state.SetItemsProcessed(state.iterations() * queries.size());
+}
+BENCHMARK_CAPTURE(BM_HitTest, vertex, false)->Apply(edgeSizes);
+BENCHMARK_CAPTURE(BM_HitTest, edge, true)->Apply(edgeSizes);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,10 @@
+#include <QCoreApplication>
+#include "GraphCli.h"
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("ultimategraph-cli");
+
+    return GraphCli::run(QCoreApplication::arguments());
+}
@@ -6,11 +6,15 @@
 #include <QHBoxLayout>
 #include <QWidget>
 #include <QPlainTextEdit>
+#include <QProgressBar>
+#include <QPushButton>
 #include <QMenuBar>
 #include <QMenu>
 #include <QStatusBar>
 #include <QSpacerItem>
 #include "GraphAlgorithms.h"
+#include "EdgeListImporter.h"
+#include "ResultFormatter.h"
 #include "VertexInputDialog.h"
 #include <QFileDialog>
 #include <QMessageBox>
@@ -26,6 +30,7 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent)
     , m_addVertexAction(nullptr)
     , m_addEdgeAction(nullptr)
     , m_clearAction(nullptr)
+    , m_autoLayoutAction(nullptr)
     , m_toolGroup(nullptr)
     , m_topologicalSortAction(nullptr)
     , m_menuBar(nullptr)
@@ -33,11 +38,18 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent)
     , m_instructionMenu(nullptr)
     , m_aboutMenu(nullptr)
     , m_openAction(nullptr)
+    , m_importAction(nullptr)
     , m_saveAction(nullptr)
     , m_exitAction(nullptr)
     , m_instructionAction(nullptr)
     , m_aboutAction(nullptr)
     , m_textOutput(nullptr)
+    , m_progressBar(nullptr)
+    , m_cancelButton(nullptr)
+    , m_algorithmRunner(nullptr)
+    , m_layoutRunner(nullptr)
+    , m_pendingHierarchyRevision(0)
+    , m_isSnapshotOnly(false)
 {
     setWindowTitle("Graph Application");
     setMinimumSize(1100, 800);
@@ -90,6 +102,7 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent)
     graphContainerLayout->setContentsMargins(0, 0, 0, 0);
 
     m_graphWidget = new GraphWidget(this);
+    updateComponentTracking();
     graphContainerLayout->addWidget(m_graphWidget);
 
     contentLayout->addWidget(graphContainer, 1);
@@ -139,7 +152,64 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent)
     m_textOutput->setPlaceholderText("Results of graph algorithms will appear here...");
 
     textContainerLayout->addWidget(m_textOutput);
+
+    QHBoxLayout *progressLayout = new QHBoxLayout();
+    progressLayout->setSpacing(5);
+
+    m_progressBar = new QProgressBar(this);
+    m_progressBar->setRange(0, 100);
+    m_progressBar->setTextVisible(true);
+    m_progressBar->setStyleSheet(
+        "QProgressBar {"
+        "   border: 1px solid #4CAF50;"
+        "   border-radius: 4px;"
+        "   text-align: center;"
+        "   height: 18px;"
+        "}"
+        "QProgressBar::chunk {"
+        "   background-color: #4CAF50;"
+        "   border-radius: 3px;"
+        "}"
+    );
+
+    m_cancelButton = new QPushButton("Cancel", this);
+    m_cancelButton->setStyleSheet(
+        "QPushButton {"
+        "   background-color: #4CAF50;"
+        "   border: none;"
+        "   color: white;"
+        "   padding: 4px 12px;"
+        "   border-radius: 4px;"
+        "   font-weight: bold;"
+        "}"
+        "QPushButton:hover {"
+        "   background-color: #45a049;"
+        "}"
+    );
+
+    progressLayout->addWidget(m_progressBar, 1);
+    progressLayout->addWidget(m_cancelButton);
+    textContainerLayout->addLayout(progressLayout);
+
+    m_progressBar->hide();
+    m_cancelButton->hide();
+
     mainLayout->addWidget(textContainer);
+
+    m_algorithmRunner = new AlgorithmRunner(this);
+    connect(m_algorithmRunner, &AlgorithmRunner::started, this, &MainWindow::onAlgorithmStarted);
+    connect(m_algorithmRunner, &AlgorithmRunner::progressChanged, m_progressBar, &QProgressBar::setValue);
+    connect(m_algorithmRunner, &AlgorithmRunner::finished, this, &MainWindow::onAlgorithmFinished);
+    connect(m_algorithmRunner, &AlgorithmRunner::cancelled, this, &MainWindow::onAlgorithmCancelled);
+    connect(m_cancelButton, &QPushButton::clicked, m_algorithmRunner, &AlgorithmRunner::cancel);
+
+    m_layoutRunner = new LayoutRunner(this);
+    connect(m_layoutRunner, &LayoutRunner::started, this, &MainWindow::onAlgorithmStarted);
+    connect(m_layoutRunner, &LayoutRunner::progressChanged, m_progressBar, &QProgressBar::setValue);
+    connect(m_layoutRunner, &LayoutRunner::positionsReady, this, &MainWindow::onLayoutPositionsReady);
+    connect(m_layoutRunner, &LayoutRunner::finished, this, &MainWindow::onLayoutFinished);
+    connect(m_layoutRunner, &LayoutRunner::cancelled, this, &MainWindow::onLayoutCancelled);
+    connect(m_cancelButton, &QPushButton::clicked, m_layoutRunner, &LayoutRunner::cancel);
 }
 
 void MainWindow::createMenus()
@@ -189,15 +259,18 @@ void MainWindow::createMenus()
     m_fileMenu = m_menuBar->addMenu("File");
 
     m_openAction = new QAction("Open", this);
+    m_importAction = new QAction("Import Edge List", this);
     m_saveAction = new QAction("Save", this);
     m_exitAction = new QAction("Exit", this);
 
     QFont menuFont("Segoe UI", 9);
     m_openAction->setFont(menuFont);
+    m_importAction->setFont(menuFont);
     m_saveAction->setFont(menuFont);
     m_exitAction->setFont(menuFont);
 
     m_fileMenu->addAction(m_openAction);
+    m_fileMenu->addAction(m_importAction);
     m_fileMenu->addAction(m_saveAction);
     m_fileMenu->addSeparator();
     m_fileMenu->addAction(m_exitAction);
@@ -211,6 +284,7 @@ void MainWindow::createMenus()
     m_menuBar->addAction(m_aboutAction);
 
     connect(m_openAction, &QAction::triggered, this, &MainWindow::onOpen);
+    connect(m_importAction, &QAction::triggered, this, &MainWindow::onImport);
     connect(m_saveAction, &QAction::triggered, this, &MainWindow::onSave);
     connect(m_exitAction, &QAction::triggered, this, &MainWindow::onExit);
 }
@@ -297,6 +371,10 @@ void MainWindow::createActions()
     m_clearAction->setFont(actionFont);
     m_drawingToolBar->addAction(m_clearAction);
 
+    m_autoLayoutAction = new QAction("Auto Layout", this);
+    m_autoLayoutAction->setFont(actionFont);
+    m_drawingToolBar->addAction(m_autoLayoutAction);
+
     m_topologicalSortAction = new QAction("Topological", this);
     m_topologicalSortAction->setFont(actionFont);
     m_algorithmToolBar->addAction(m_topologicalSortAction);
@@ -325,9 +403,14 @@ void MainWindow::createActions()
     m_vertexDegreesAction->setFont(actionFont);
     m_algorithmToolBar->addAction(m_vertexDegreesAction);
 
+    m_buildPathIndexAction = new QAction("Path Index", this);
+    m_buildPathIndexAction->setFont(actionFont);
+    m_algorithmToolBar->addAction(m_buildPathIndexAction);
+
     connect(m_addVertexAction, &QAction::triggered, this, &MainWindow::onAddVertexMode);
     connect(m_addEdgeAction, &QAction::triggered, this, &MainWindow::onAddEdgeMode);
     connect(m_clearAction, &QAction::triggered, this, &MainWindow::onClearGraph);
+    connect(m_autoLayoutAction, &QAction::triggered, this, &MainWindow::onAutoLayout);
     connect(m_selectAction, &QAction::triggered, this, &MainWindow::onSelectMode);
     connect(m_topologicalSortAction, &QAction::triggered, this, &MainWindow::onTopologicalSort);
     connect(m_eulerianCycleAction, &QAction::triggered, this, &MainWindow::onEulerianCycle);
@@ -336,6 +419,7 @@ void MainWindow::createActions()
     connect(m_sccAction, &QAction::triggered, this, &MainWindow::onStronglyConnectedComponents);
     connect(m_eulerianPathAction, &QAction::triggered, this, &MainWindow::onEulerianPath);
     connect(m_vertexDegreesAction, &QAction::triggered, this, &MainWindow::onVertexDegrees);
+    connect(m_buildPathIndexAction, &QAction::triggered, this, &MainWindow::onBuildPathIndex);
 }
 
 
@@ -352,44 +436,70 @@ void MainWindow::onAddEdgeMode(){
 }
 
 void MainWindow::onClearGraph(){
+    m_layoutRunner->cancelAndWait();
     m_graphWidget->clearGraph();
+    setSnapshotOnly(false);
+    updateComponentTracking();
     m_textOutput->clear();
 }
 
-void MainWindow::onTopologicalSort(){
+void MainWindow::onAutoLayout(){
+    Graph* graph = m_graphWidget->getGraph();
+
+    if (!graph) {
+        appendResult("Auto Layout", "Graph is not initialized.");
+    } else if (m_isSnapshotOnly) {
+        appendResult("Auto Layout", "The imported graph is too large to draw, so there is nothing to lay out.");
+    } else if (!m_algorithmRunner->isRunning() && !m_layoutRunner->isRunning()) {
+        m_layoutRunner->start(graph->snapshot());
+    }
+}
 
+// Like the components, the order is kept current while editing.
+void MainWindow::onTopologicalSort(){
     Graph* graph = m_graphWidget->getGraph();
-    QString result = GraphAlgorithms::topologicalSort(graph);
 
-    m_textOutput->appendPlainText("=== Topological Sort ===");
-    m_textOutput->appendPlainText(result);
-    m_textOutput->appendPlainText("");
+    if (graph && graph->strongComponents()) {
+        appendResult("Topological Sort", ResultFormatter::topologicalSort(GraphAlgorithms::topologicalSort(graph)));
+    } else {
+        runAlgorithm("Topological Sort", [](const GraphSnapshot &snapshot, AlgorithmProgress *) {
+            return ResultFormatter::topologicalSort(GraphAlgorithms::topologicalSort(snapshot));
+        });
+    }
 }
 
 void MainWindow::onEulerianCycle(){
 
-    Graph* graph = m_graphWidget->getGraph();
-    QString result = GraphAlgorithms::eulerianCycle(graph);
-
-    m_textOutput->appendPlainText("=== Eulerian Cycle ===");
-    m_textOutput->appendPlainText(result);
-    m_textOutput->appendPlainText("");
+    runAlgorithm("Eulerian Cycle", [](const GraphSnapshot &snapshot, AlgorithmProgress *) {
+        return ResultFormatter::eulerianCycle(GraphAlgorithms::eulerianCycle(snapshot));
+    });
 }
 
+// A path index built since the last edit answers the query; otherwise it
+// is a bidirectional search.
 void MainWindow::onDijkstra(){
 
     VertexInputDialog dialog("Dijkstra Algorithm", this);
+    Graph* graph = m_graphWidget->getGraph();
 
     if (dialog.exec() == QDialog::Accepted) {
         int startId = dialog.getStartVertexId();
         int endId = dialog.getEndVertexId();
-
-        Graph* graph = m_graphWidget->getGraph();
-        QString result = GraphAlgorithms::dijkstra(graph, startId, endId);
-
-        m_textOutput->appendPlainText("=== Dijkstra Algorithm ===");
-        m_textOutput->appendPlainText(result);
-        m_textOutput->appendPlainText("");
+        std::shared_ptr<const ContractionHierarchy> hierarchy = m_isSnapshotOnly ? m_importedHierarchy
+                                                                : graph ? graph->hierarchy() : nullptr;
+
+        if (hierarchy) {
+            runAlgorithm("Dijkstra Algorithm", [hierarchy, startId, endId](const GraphSnapshot &, AlgorithmProgress *) {
+                ContractionHierarchy::Query query(*hierarchy);
+                return ResultFormatter::dijkstra(GraphAlgorithms::shortestPath(query, startId, endId));
+            });
+        } else {
+            runAlgorithm("Dijkstra Algorithm", [startId, endId](const GraphSnapshot &snapshot, AlgorithmProgress *progress) {
+                return ResultFormatter::dijkstra(GraphAlgorithms::shortestPath(snapshot, startId, endId,
+                                                                               PointToPointSearch::Method::Bidirectional,
+                                                                               progress));
+            });
+        }
     }
 }
 
@@ -401,46 +511,216 @@ void MainWindow::onMaxFlow(){
         int sourceId = dialog.getStartVertexId();
         int sinkId = dialog.getEndVertexId();
 
-        Graph* graph = m_graphWidget->getGraph();
-        QString result = GraphAlgorithms::maxFlow(graph, sourceId, sinkId);
-
-        m_textOutput->appendPlainText("=== Max Flow Algorithm ===");
-        m_textOutput->appendPlainText(result);
-        m_textOutput->appendPlainText("");
+        runAlgorithm("Max Flow Algorithm", [sourceId, sinkId](const GraphSnapshot &snapshot, AlgorithmProgress *progress) {
+            return ResultFormatter::maxFlow(GraphAlgorithms::maxFlow(snapshot, sourceId, sinkId,
+                                                                     MaxFlow::Method::Dinic, progress));
+        });
     }
 }
 
+// A graph small enough to track its components keeps them current while it
+// is edited, so they are read off right here instead of recomputed on the
+// worker; larger ones go through a snapshot.
 void MainWindow::onStronglyConnectedComponents()
 {
-
     Graph* graph = m_graphWidget->getGraph();
-    QString result = GraphAlgorithms::stronglyConnectedComponents(graph);
 
-    m_textOutput->appendPlainText("=== Strongly Connected Components ===");
-    m_textOutput->appendPlainText(result);
-    m_textOutput->appendPlainText("");
+    if (graph && graph->strongComponents()) {
+        appendResult("Strongly Connected Components",
+                     ResultFormatter::stronglyConnectedComponents(GraphAlgorithms::stronglyConnectedComponents(graph)));
+    } else {
+        runAlgorithm("Strongly Connected Components", [](const GraphSnapshot &snapshot, AlgorithmProgress *progress) {
+            return ResultFormatter::stronglyConnectedComponents(GraphAlgorithms::stronglyConnectedComponents(snapshot, progress));
+        });
+    }
 }
 
 void MainWindow::onEulerianPath()
 {
 
+    runAlgorithm("Eulerian Path", [](const GraphSnapshot &snapshot, AlgorithmProgress *) {
+        return ResultFormatter::eulerianPath(GraphAlgorithms::eulerianPath(snapshot));
+    });
+}
+
+void MainWindow::onVertexDegrees()
+{
+
+    runAlgorithm("Vertex Degrees", [](const GraphSnapshot &snapshot, AlgorithmProgress *) {
+        return ResultFormatter::vertexDegrees(GraphAlgorithms::vertexDegrees(snapshot));
+    });
+}
+
+// The hierarchy is handed to the graph, or kept with an imported snapshot,
+// in onAlgorithmFinished, which drops it if the graph was edited or
+// replaced in the meantime.
+void MainWindow::onBuildPathIndex()
+{
+    Graph* graph = m_graphWidget->getGraph();
+
+    if (graph && !m_algorithmRunner->isRunning() && !m_layoutRunner->isRunning()) {
+        std::shared_ptr<ContractionHierarchy> hierarchy = std::make_shared<ContractionHierarchy>();
+        m_pendingHierarchy = hierarchy;
+        m_pendingHierarchyRevision = graph->structureRevision();
+
+        runAlgorithm("Build Path Index", [hierarchy](const GraphSnapshot &snapshot, AlgorithmProgress *progress) {
+            QString text = "Path index not built: the graph has negative weights.";
+            if (hierarchy->build(snapshot, progress)) {
+                text = QString("Path index built: %1 vertices, %2 arcs. Dijkstra uses it until the graph is edited.")
+                           .arg(hierarchy->vertexCount())
+                           .arg(hierarchy->arcCount());
+            }
+            return text;
+        });
+    } else if (!graph) {
+        appendResult("Build Path Index", "Graph is not initialized.");
+    }
+}
+
+// The snapshot is taken here, on the GUI thread; the worker never touches
+// the live Graph, so editing can go on while the algorithm runs. A graph
+// kept only as an imported snapshot is handed over as it is.
+void MainWindow::runAlgorithm(const QString &title, const AlgorithmRunner::Task &task)
+{
     Graph* graph = m_graphWidget->getGraph();
-    QString result = GraphAlgorithms::eulerianPath(graph);
 
-    m_textOutput->appendPlainText("=== Eulerian Path ===");
-    m_textOutput->appendPlainText(result);
+    if (!graph) {
+        appendResult(title, "Graph is not initialized.");
+    } else if (!m_algorithmRunner->isRunning() && !m_layoutRunner->isRunning()) {
+        m_algorithmRunner->start(title, m_isSnapshotOnly ? m_importedSnapshot : graph->snapshot(), task);
+    }
+}
+
+void MainWindow::appendResult(const QString &title, const QString &text)
+{
+    m_textOutput->appendPlainText("=== " + title + " ===");
+    m_textOutput->appendPlainText(text);
     m_textOutput->appendPlainText("");
 }
 
-void MainWindow::onVertexDegrees()
+void MainWindow::onAlgorithmStarted()
 {
+    m_algorithmToolBar->setEnabled(false);
+    m_autoLayoutAction->setEnabled(false);
+    m_progressBar->setValue(0);
+    m_progressBar->show();
+    m_cancelButton->show();
+}
 
+void MainWindow::onAlgorithmFinished(const QString &title, const QString &text)
+{
     Graph* graph = m_graphWidget->getGraph();
-    QString result = GraphAlgorithms::vertexDegrees(graph);
 
-    m_textOutput->appendPlainText("=== Vertex Degrees ===");
-    m_textOutput->appendPlainText(result);
-    m_textOutput->appendPlainText("");
+    if (graph && m_pendingHierarchy && !m_pendingHierarchy->isEmpty()) {
+        if (!m_isSnapshotOnly) {
+            graph->setHierarchy(m_pendingHierarchy, m_pendingHierarchyRevision);
+        } else if (graph->structureRevision() == m_pendingHierarchyRevision) {
+            m_importedHierarchy = m_pendingHierarchy;
+        }
+    }
+    m_pendingHierarchy.reset();
+
+    if (graph && m_pendingImport && m_pendingImport->isRead) {
+        m_layoutRunner->cancelAndWait();
+        adoptSnapshot(m_pendingImport->snapshot);
+    }
+    m_pendingImport.reset();
+
+    appendResult(title, text);
+    finishAlgorithm();
+}
+
+void MainWindow::onAlgorithmCancelled(const QString &title)
+{
+    m_pendingHierarchy.reset();
+    m_pendingImport.reset();
+    appendResult(title, "Cancelled.");
+    finishAlgorithm();
+}
+
+// Vertices deleted since the layout started are skipped by moveVertices.
+void MainWindow::onLayoutPositionsReady(const QVector<int> &vertexIds, const QVector<QPoint> &positions)
+{
+    Graph* graph = m_graphWidget->getGraph();
+
+    if (graph) {
+        graph->moveVertices(vertexIds, positions);
+        m_graphWidget->update();
+    }
+}
+
+void MainWindow::onLayoutFinished()
+{
+    appendResult("Auto Layout", "Done.");
+    finishAlgorithm();
+}
+
+void MainWindow::onLayoutCancelled()
+{
+    appendResult("Auto Layout", "Cancelled.");
+    finishAlgorithm();
+}
+
+// Called whenever the graph is replaced. Loading turns tracking off first,
+// so that a large graph is never tracked even for the load itself.
+void MainWindow::updateComponentTracking()
+{
+    Graph* graph = m_graphWidget->getGraph();
+    graph->setTracksComponents(!m_isSnapshotOnly
+                               && graph->vertexCount() + graph->edgeCount() <= MAX_TRACKED_ELEMENTS);
+}
+
+// Snapshots small enough to draw become the graph on the canvas. Larger
+// ones are kept as they are for the algorithms, since turning them into
+// Edge objects, hash entries and spatial cells would stall the window.
+void MainWindow::adoptSnapshot(const GraphSnapshot &snapshot)
+{
+    Graph* graph = m_graphWidget->getGraph();
+    bool isDrawable = snapshot.vertexCount() + snapshot.edgeCount() <= GraphWidget::MAX_DRAWN_ELEMENTS;
+
+    graph->setTracksComponents(false);
+    m_graphWidget->clearGraph();
+    if (isDrawable) {
+        graph->loadSnapshot(snapshot);
+        setSnapshotOnly(false);
+    } else {
+        setSnapshotOnly(true, snapshot);
+    }
+    updateComponentTracking();
+    m_graphWidget->update();
+}
+
+// Drawing tools are off while the canvas has nothing to edit; Clear and
+// Open go back to an ordinary graph.
+void MainWindow::setSnapshotOnly(bool isSnapshotOnly, const GraphSnapshot &snapshot)
+{
+    m_isSnapshotOnly = isSnapshotOnly;
+    m_importedSnapshot = snapshot;
+    m_importedHierarchy.reset();
+
+    m_addVertexAction->setEnabled(!isSnapshotOnly);
+    m_addEdgeAction->setEnabled(!isSnapshotOnly);
+    if (isSnapshotOnly) {
+        m_selectAction->setChecked(true);
+        m_graphWidget->setMode(GraphWidget::SelectMode);
+        m_graphWidget->setPlaceholderText(
+            QString("%1 vertices and %2 edges are too many to draw.\nAlgorithms run on the imported graph; "
+                    "Clear or Open a file to edit again.")
+                .arg(snapshot.vertexCount()).arg(snapshot.edgeCount()));
+    } else {
+        m_graphWidget->setPlaceholderText(QString());
+    }
+}
+
+void MainWindow::finishAlgorithm()
+{
+    m_progressBar->hide();
+    m_cancelButton->hide();
+    m_algorithmToolBar->setEnabled(true);
+    m_autoLayoutAction->setEnabled(true);
+    m_openAction->setEnabled(true);
+    m_importAction->setEnabled(true);
+    m_clearAction->setEnabled(true);
 }
 
 void MainWindow::onOpen()
@@ -461,8 +741,14 @@ void MainWindow::onOpen()
         return;
     }
 
+    m_layoutRunner->cancelAndWait();
     Graph* graph = m_graphWidget->getGraph();
+    graph->setTracksComponents(false);
     bool isLoadSuccessful = graph->loadFromFile(filename);
+    if (isLoadSuccessful) {
+        setSnapshotOnly(false);
+    }
+    updateComponentTracking();
 
     if (isLoadSuccessful) {
         m_textOutput->appendPlainText("Graph loaded successfully from: " + filename);
@@ -475,6 +761,56 @@ void MainWindow::onOpen()
 }
 
 
+// The importer builds a snapshot straight from the text on the algorithm
+// runner; onAlgorithmFinished hands it to adoptSnapshot. Open, Import and
+// Clear wait until then.
+void MainWindow::onImport()
+{
+    QString filename = QFileDialog::getOpenFileName(
+        this,
+        "Import Edge List",
+        "",
+        "Edge Lists (*.txt *.edges *.el *.tsv *.snap *.mtx *.gr *.dimacs *.max *.csv);;All Files (*.*)"
+    );
+
+    if (filename.isEmpty()) {
+        return;
+    }
+
+    if (!m_graphWidget) {
+        m_textOutput->appendPlainText("Error: GraphWidget is not initialized.");
+        return;
+    }
+
+    if (m_algorithmRunner->isRunning() || m_layoutRunner->isRunning()) {
+        appendResult("Import", "Another task is running; cancel it or wait for it to finish.");
+        return;
+    }
+
+    EdgeListImporter::Format format = EdgeListImporter::Format::Snap;
+    EdgeListImporter::formatFor(filename, format);
+
+    std::shared_ptr<PendingImport> pending = std::make_shared<PendingImport>();
+    m_pendingImport = pending;
+
+    m_algorithmRunner->start("Import", GraphSnapshot(),
+                             [pending, filename, format](const GraphSnapshot &, AlgorithmProgress *progress) {
+        EdgeListImporter importer;
+        QString text;
+        pending->isRead = importer.read(filename, format, pending->snapshot, progress);
+        if (pending->isRead) {
+            text = QString("Imported %1 vertices and %2 edges from: %3")
+                       .arg(pending->snapshot.vertexCount()).arg(pending->snapshot.edgeCount()).arg(filename);
+        } else {
+            text = "Error: Failed to import " + filename + ": " + importer.errorString();
+        }
+        return text;
+    });
+    m_openAction->setEnabled(false);
+    m_importAction->setEnabled(false);
+    m_clearAction->setEnabled(false);
+}
+
 void MainWindow::onSave()
 {
     QString filename = QFileDialog::getSaveFileName(
@@ -498,7 +834,8 @@ void MainWindow::onSave()
     }
 
     Graph* graph = m_graphWidget->getGraph();
-    bool isSaveSuccessful = graph->saveToFile(filename);
+    bool isSaveSuccessful = m_isSnapshotOnly ? GraphFile::write(m_importedSnapshot, filename)
+                                             : graph->saveToFile(filename);
 
     if (isSaveSuccessful) {
         m_textOutput->appendPlainText("Graph saved successfully to: " + filename);
@@ -4,11 +4,15 @@
 #include <QMainWindow>
 #include "GraphWidget.h"
 #include "GraphAlgorithms.h"
+#include "AlgorithmRunner.h"
+#include "LayoutRunner.h"
 
 class QToolBar;
 class QAction;
 class QActionGroup;
 class QPlainTextEdit;
+class QProgressBar;
+class QPushButton;
 class QMenu;
 class QMenuBar;
 
@@ -24,6 +28,7 @@ private slots:
     void onAddVertexMode();
     void onAddEdgeMode();
     void onClearGraph();
+    void onAutoLayout();
     void onTopologicalSort();
     void onEulerianCycle();
     void onDijkstra();
@@ -31,14 +36,34 @@ private slots:
     void onStronglyConnectedComponents();
     void onEulerianPath();
     void onVertexDegrees();
+    void onBuildPathIndex();
 
+    void onImport();
     void onSave();
     void onExit();
 
+    void onAlgorithmStarted();
+    void onAlgorithmFinished(const QString &title, const QString &text);
+    void onAlgorithmCancelled(const QString &title);
+    void onLayoutPositionsReady(const QVector<int> &vertexIds, const QVector<QPoint> &positions);
+    void onLayoutFinished();
+    void onLayoutCancelled();
+
 private:
+    // Above this many vertices and edges together the graph does not track
+    // its components: each edit inside a large component would rerun Tarjan
+    // over it on the GUI thread. Algorithms then run on snapshots instead.
+    static const int MAX_TRACKED_ELEMENTS = 100000;
+
     void createToolBars();
     void createActions();
     void createMenus();
+    void runAlgorithm(const QString &title, const AlgorithmRunner::Task &task);
+    void appendResult(const QString &title, const QString &text);
+    void finishAlgorithm();
+    void updateComponentTracking();
+    void adoptSnapshot(const GraphSnapshot &snapshot);
+    void setSnapshotOnly(bool isSnapshotOnly, const GraphSnapshot &snapshot = GraphSnapshot());
 
     GraphWidget *m_graphWidget;
 
@@ -51,6 +76,7 @@ private:
     QAction *m_addVertexAction;
     QAction *m_addEdgeAction;
     QAction *m_clearAction;
+    QAction *m_autoLayoutAction;
     QActionGroup *m_toolGroup;
 
 
@@ -65,6 +91,7 @@ private:
     QMenu *m_instructionMenu;
     QMenu *m_aboutMenu;
     QAction *m_openAction;
+    QAction *m_importAction;
     QAction *m_saveAction;
     QAction *m_exitAction;
     QAction *m_instructionAction;
@@ -72,8 +99,33 @@ private:
     QAction *m_dijkstraAction;
     QAction *m_maxFlowAction;
     QAction *m_vertexDegreesAction;
+    QAction *m_buildPathIndexAction;
 
     QPlainTextEdit *m_textOutput;
+    QProgressBar *m_progressBar;
+    QPushButton *m_cancelButton;
+    AlgorithmRunner *m_algorithmRunner;
+    LayoutRunner *m_layoutRunner;
+
+    // Hierarchy being built by the algorithm runner and the structure
+    // revision of the snapshot it is built from.
+    std::shared_ptr<ContractionHierarchy> m_pendingHierarchy;
+    quint64 m_pendingHierarchyRevision;
+
+    // Edge list being read by the algorithm runner; the graph adopts the
+    // snapshot once the read succeeded.
+    struct PendingImport {
+        GraphSnapshot snapshot;
+        bool isRead = false;
+    };
+    std::shared_ptr<PendingImport> m_pendingImport;
+
+    // An import too large to draw is never turned into the Graph. While
+    // m_isSnapshotOnly, the canvas graph stays empty and algorithms, Save
+    // and the path index work on m_importedSnapshot instead.
+    GraphSnapshot m_importedSnapshot;
+    std::shared_ptr<const ContractionHierarchy> m_importedHierarchy;
+    bool m_isSnapshotOnly;
 };
 
 #endif
\ No newline at end of file